@@ -22,6 +22,9 @@ class EngineEventListener;
 class ProcessManager;
 class ResCacheManager;
 class ScriptManager;
+class ThreadPool;
+class RenderPipeline;
+struct RenderFrame;
 
 typedef shared_ptr<Timer>			TimerPtr;
 typedef shared_ptr<Settings>		SettingsPtr;
@@ -29,6 +32,8 @@ typedef shared_ptr<EventManager>	EventManagerPtr;
 typedef shared_ptr<ProcessManager>	SchedulerPtr;
 typedef shared_ptr<ResCacheManager>	ResCacheManagerPtr;
 typedef shared_ptr<ScriptManager>	ScriptManagerPtr;
+typedef shared_ptr<ThreadPool>		ThreadPoolPtr;
+typedef shared_ptr<RenderPipeline>	RenderPipelinePtr;
 
 /*=============================================================================
 class Application
@@ -41,9 +46,11 @@ class Application {
 		TimerPtr				mFrameTimer;
 		EventManagerPtr			mEventMgr;
 		SchedulerPtr			mScheduler;
+		ThreadPoolPtr			mThreadPool;
 		ResCacheManagerPtr		mResCacheMgr;
 		ScriptManagerPtr		mScriptMgr;
 		RendererPtr				mRenderer;
+		RenderPipelinePtr		mRenderPipeline;
 		
 		int		mPausedCount; // pause() increments, unpause() decrements, always >= 0, unpaused when 0
 		bool	mExit;
@@ -57,6 +64,12 @@ class Application {
 		bool isExiting() const		{ return mExit; }
 		const RendererPtr & getRenderer() const { return mRenderer; }
 
+		/*---------------------------------------------------------------------
+			The snapshot this frame's update fills for the renderer, main
+			thread only. Only deltaMillis is filled so far, see RenderFrame
+		---------------------------------------------------------------------*/
+		RenderFrame & getRenderFrame();
+
 		// Mutators
 		void exit()		{ mExit = true; }
 		int	 pause()	{ return ++mPausedCount; }
@@ -65,6 +78,7 @@ class Application {
 		void update(double deltaMillis);
 		void render();
 		void resetAfterInactive();
+		void setPipelinedRender(bool pipelined);
 
 		void cleanup();
 
@@ -75,9 +89,11 @@ class Application {
 							 const TimerPtr &timer,
 							 const EventManagerPtr &eventMgr,
 							 const SchedulerPtr &scheduler,
+							 const ThreadPoolPtr &threadPool,
 							 const ResCacheManagerPtr &resCacheMgr,
 							 const ScriptManagerPtr &scriptMgr,
-							 const RendererPtr &renderer
+							 const RendererPtr &renderer,
+							 const RenderPipelinePtr &renderPipeline
 							);
 		~Application();
 };
@@ -0,0 +1,130 @@
+/* Benchmark.h
+Author: Jeff Kiah
+Orig.Date: 10/17/2026
+*/
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+class EventManager;
+
+///// STRUCTURES /////
+
+/*=============================================================================
+struct QueueBenchmarkResult
+	Average cost per item moved through each thread-safe queue, measured from
+	the consumer side, in nanoseconds
+=============================================================================*/
+struct QueueBenchmarkResult {
+	double	mutexNsPerItem;		// ConcurrentQueue (boost::mutex + condition variable)
+	double	mpscNsPerItem;		// lock-free MPSCQueue
+	double	mpmcNsPerItem;		// lock-free MPMCQueue
+};
+
+/*=============================================================================
+struct ScriptDataBenchmarkResult
+	Average cost per event of building a ten field script payload, copying it
+	into the event and reading every field back, in nanoseconds
+=============================================================================*/
+struct ScriptDataBenchmarkResult {
+	double	anyVarsNsPerEvent;		// AnyVars list, read back with a _stricmp scan per field
+	double	scriptDataNsPerEvent;	// ScriptData blob, read back by field index
+	double	byNameNsPerEvent;		// ScriptData blob, read back by field name as script does
+};
+
+/*=============================================================================
+struct RemoteEventBenchmarkResult
+	Cost of the remote event path for an ActorMovedEvent shaped payload
+=============================================================================*/
+struct RemoteEventBenchmarkResult {
+	double	packedBytesPerEvent;	// wire format, packet header and payload
+	double	rawBytesPerEvent;		// the same fields written unpacked by BinaryWriter
+	double	encodeNsPerEvent;		// packing into a packet buffer
+	double	decodeNsPerEvent;		// unpacking into a new event
+	double	eventsPerSecond;		// end to end through a RemoteEventLink over a LoopbackTransport
+};
+
+/*=============================================================================
+struct EventTraceBenchmarkResult
+	Cost of recording resource load events into an event trace and reading
+	them back for replay, and whether every event survived the round trip
+=============================================================================*/
+struct EventTraceBenchmarkResult {
+	double		recordNsPerEvent;		// trigger with an EventRecorder installed
+	double		deserializeNsPerEvent;	// EventManager::deserializeEvent from the loaded trace
+	double		bytesPerEvent;			// record header and payload in the trace file
+	uint32_t	numMismatched;			// events missing from the trace or read back different
+};
+
+/*=============================================================================
+struct BenchmarkCase
+	One line of the benchmark report. allocsPerEvent counts blocks taken
+	from the event SlabPool, large allocations included, heap use outside
+	the pool is not seen.
+=============================================================================*/
+struct BenchmarkCase {
+	std::string	name;
+	double		nsPerEvent;
+	double		allocsPerEvent;
+};
+typedef std::vector<BenchmarkCase>	BenchmarkResults;
+
+///// FUNCTIONS /////
+
+/*---------------------------------------------------------------------
+	Contention benchmark for the thread-safe event queues. numProducers
+	threads each push itemsPerProducer EventPtrs as fast as they can
+	while the calling thread drains the queue with tryPop, the same way
+	EventManager::notifyQueued drains raiseThreadSafe events. Results
+	are printed to the debug console and returned.
+---------------------------------------------------------------------*/
+QueueBenchmarkResult benchmarkThreadSafeQueues(int numProducers, int itemsPerProducer);
+
+/*---------------------------------------------------------------------
+	Compares the legacy AnyVars script payload with the ScriptData blob
+	for an ActorMovedEvent shaped payload, the way buildScriptData and
+	the script-called constructor use them. Results are printed to the
+	debug console and returned.
+---------------------------------------------------------------------*/
+ScriptDataBenchmarkResult benchmarkScriptData(int iterations);
+
+/*---------------------------------------------------------------------
+	Measures packing, unpacking and end to end throughput of remote
+	events. Registers a benchmark remote event type with eventMgr the
+	first time, and triggers the received events so nothing is left in
+	the queue. Results are printed to the debug console and returned.
+---------------------------------------------------------------------*/
+RemoteEventBenchmarkResult benchmarkRemoteEvents(const std::shared_ptr<EventManager> &eventMgr, int numEvents);
+
+/*---------------------------------------------------------------------
+	Records numEvents resource load events through eventMgr, saves the
+	trace to traceFile, loads it back and deserializes every record the
+	way EventReplayProcess does, comparing each event with the one that
+	was triggered. Registers the resource event types with eventMgr if
+	they aren't yet, and leaves no recorder installed. Results are
+	printed to the debug console and returned.
+---------------------------------------------------------------------*/
+EventTraceBenchmarkResult benchmarkEventTrace(const std::shared_ptr<EventManager> &eventMgr, int numEvents,
+											  const std::string &traceFile);
+
+/*---------------------------------------------------------------------
+	Event core benchmark: raise and notifyQueued, trigger, 1 to 10000
+	listeners, mixed priorities, a consuming listener, the wildcard
+	EventSnooper, and raiseThreadSafe from 1 to 8 producer threads.
+	Creates its own EventManager, which takes over the listener and
+	registration statics, so only run it while no other EventManager
+	exists, as the -benchmark mode does.
+---------------------------------------------------------------------*/
+BenchmarkResults benchmarkEventSystem(int eventsPerCase);
+
+/*---------------------------------------------------------------------
+	Runs every benchmark and writes the report to reportFile, one tab
+	separated case per line. If baselineFile names an earlier report,
+	each case is compared against it by name and the change is written
+	alongside. Returns false if the report can't be written or the event
+	trace round trip check fails.
+---------------------------------------------------------------------*/
+bool runBenchmarkSuite(const std::string &reportFile, const std::string &baselineFile);
@@ -4,10 +4,17 @@ Orig.Date: 06/21/2012
 */
 
 #include "Application/Application.h"
+#include "Application/Settings.h"
 #include "Application/Timer.h"
 #include "Event/EventManager.h"
 #include "Event/RegisteredEvents.h"
+#include "Event/EventRecorder.h"
+#include "Event/EventReplayProcess.h"
 #include "Process/ProcessManager.h"
+#include "Utility/JobSystem.h"
+#include "Utility/ThreadPool.h"
+#include "Process/ThreadProcess.h"
+#include "Application/RenderPipeline.h"
 #include "Resource/ResCache.h"
 #include "Script/ScriptManager_LuaJIT.h"
 
@@ -23,6 +30,7 @@ void Application::processFrame()
 	double updateDeltaMS = mFrameTimer->stop();
 	mFrameTimer->start();
 	if (!isPaused()) {
+		getRenderFrame().deltaMillis = updateDeltaMS;
 		update(updateDeltaMS);
 	}
 
@@ -42,13 +50,22 @@ void Application::processFrame()
 
 void Application::update(double deltaMillis)
 {
-	mEventMgr->notifyQueued(0);
-	mScheduler->updateProcesses(deltaMillis);
+	mEventMgr->notifyQueued(m_pSettings->eventBudgetMillis);
+	mScheduler->updateProcesses(deltaMillis, m_pSettings->processBudgetMillis);
 }
 
+/*---------------------------------------------------------------------
+	Hands the frame's snapshot to the RenderPipeline, which draws it on
+	the render thread while the next frame updates, or here when serial.
+	Paused frames have no new snapshot, so the last one is drawn again.
+---------------------------------------------------------------------*/
 void Application::render()
 {
-	mRenderer->render();
+	if (isPaused()) {
+		mRenderPipeline->resubmit();
+	} else {
+		mRenderPipeline->submit();
+	}
 
 //	mRenderMgr->prepareSubmitList();
 
@@ -68,6 +85,16 @@ void Application::resetAfterInactive()
 	mFrameTimer->start();
 }
 
+RenderFrame & Application::getRenderFrame()
+{
+	return mRenderPipeline->writeFrame();
+}
+
+void Application::setPipelinedRender(bool pipelined)
+{
+	mRenderPipeline->setPipelined(pipelined);
+}
+
 ///// TEST Mesh /////
 //	testMesh = new Mesh_D3D9;
 //	testMesh->loadFromXFile("data/model/palmtree.x");
@@ -200,13 +227,22 @@ NoiseWrapper::initGrad4();
 
 void Application::cleanup()
 {
+	// stop the render thread first, it draws from the renderer until then
+	mRenderPipeline->logStats();
+	mRenderPipeline = 0;
+	if (mEventMgr->getRecorder()) {
+		mEventMgr->getRecorder()->save(m_pSettings->eventTraceFile, *mEventMgr);
+		mEventMgr->setRecorder(0);
+	}
 	mScriptMgr->deinit();
 	// shutdown all processes - do this early incase any processes hold Resources
+	mScheduler->logStats();
 	mScheduler->clear();
 	mRenderer = 0;
 	mScriptMgr = 0;
 	mResCacheMgr = 0;
 	mScheduler = 0;
+	mThreadPool = 0; // every ThreadProcess has finished by now
 	mEventMgr = 0;
 }
 
@@ -217,9 +253,11 @@ Application::Application(
 					 const TimerPtr &timer,
 					 const EventManagerPtr &eventMgr,
 					 const SchedulerPtr &scheduler,
+					 const ThreadPoolPtr &threadPool,
 					 const ResCacheManagerPtr &resCacheMgr,
 					 const ScriptManagerPtr &scriptMgr,
-					 const RendererPtr &renderer
+					 const RendererPtr &renderer,
+					 const RenderPipelinePtr &renderPipeline
 					) :
 	appName(name),
 	m_pPlatform(pPlatform),
@@ -227,9 +265,11 @@ Application::Application(
 	mFrameTimer(timer),
 	mEventMgr(eventMgr),
 	mScheduler(scheduler),
+	mThreadPool(threadPool),
 	mResCacheMgr(resCacheMgr),
 	mScriptMgr(scriptMgr),
 	mRenderer(renderer),
+	mRenderPipeline(renderPipeline),
 	mPausedCount(0), mExit(false)
 {}
 
@@ -246,17 +286,40 @@ ApplicationUniquePtr ApplicationFactory::createIcarus()
 	TimerPtr timer(new Timer());
 	timer->start();
 	
+	// create the Job System, one worker per core besides this one, shared by events and processes
+	JobSystemPtr jobSystem(std::make_shared<JobSystem>(JobSystem::defaultNumThreads()));
+
 	// create Event System
 	unique_ptr<EventSnooper> eventSnooper(new EventSnooper());
 	EventManagerPtr eventMgr(EventManager::create(eventSnooper));
+	eventMgr->setJobSystem(jobSystem);
+	if (m_pSettings->recordEvents) {
+		eventMgr->setRecorder(std::make_shared<EventRecorder>());
+	}
 	
 	// create ProcessManager
-	SchedulerPtr scheduler(new ProcessManager());
+	SchedulerPtr scheduler(new ProcessManager(jobSystem));
+
+	// create the Thread Pool for ThreadProcesses, kept off core 0 which this thread takes
+	ThreadPool::Config poolConfig(ThreadPool::defaultConfig(m_pSettings->threadPoolMaxThreads));
+	if (poolConfig.affinityMask[ThreadClass_Background] != 0) {
+		ThreadPool::pinCurrentThread(1);
+	}
+	ThreadPoolPtr threadPool(std::make_shared<ThreadPool>(poolConfig));
+	ThreadProcess::setThreadPool(threadPool);
 	
 	// create Resource Cache Manager
 	// TEMP these hard-coded values should come from real-time memory queries
 	ResCacheManagerPtr resCacheMgr(ResCacheManager::create(2048, 512, eventMgr, scheduler));
 
+	// replay a recorded trace once the event types it holds are registered
+	if (!m_pSettings->replayEventTrace.empty()) {
+		EventTracePtr trace(std::make_shared<EventTrace>());
+		if (trace->load(m_pSettings->replayEventTrace)) {
+			scheduler->attach(ProcessManager::make<EventReplayProcess>("EventReplayProcess", eventMgr, trace));
+		}
+	}
+
 //////////
 	// create Resource Sources
 	// TEMP TEST, eventually place these in a vector within Application
@@ -285,7 +348,7 @@ ApplicationUniquePtr ApplicationFactory::createIcarus()
 	ScriptManagerPtr scriptMgr(new ScriptManager());
 	
 	// init.lua configures the startup settings
-	if (!scriptMgr->init("data/script/init.lua")) {
+	if (!scriptMgr->init("data/script/init.lua", eventMgr)) {
 		return ApplicationUniquePtr();
 	}
 
@@ -295,6 +358,20 @@ ApplicationUniquePtr ApplicationFactory::createIcarus()
 		debugPrintf("Renderer init failed!\n");
 		return ApplicationUniquePtr();
 	}
+
+	// create the Render Pipeline, its thread takes the latency class cores like the RenderProcess
+	RenderPipelinePtr renderPipeline(std::make_shared<RenderPipeline>(
+		[renderer](const RenderFrame &frame) { renderer->render(frame); },
+		[renderer]() { renderer->present(); },
+		m_pSettings->pipelinedRender,
+		poolConfig.affinityMask[ThreadClass_Latency]));
+	// main thread users of the immediate context wait for the frame in flight,
+	// weak so the pipeline's render function holding the renderer isn't a cycle
+	std::weak_ptr<RenderPipeline> weakPipeline(renderPipeline);
+	renderer->setContextWait([weakPipeline]() {
+		RenderPipelinePtr pipeline(weakPipeline.lock());
+		if (pipeline) { pipeline->waitForRender(); }
+	});
 // TEMP
 //	activeCam  = new Camera_D3D9(Vector3f(0.0f, 0.0f, 0.0f),
 //								 Vector3f(0.0f, 0.0f, 0.0f),
@@ -304,7 +381,7 @@ ApplicationUniquePtr ApplicationFactory::createIcarus()
 
 	// create the application layer
 	ApplicationUniquePtr appPtr(new Application("Icarus", m_pPlatform,
-												m_pSettings, timer, eventMgr, scheduler,
-												resCacheMgr, scriptMgr, renderer));
+												m_pSettings, timer, eventMgr, scheduler, threadPool,
+												resCacheMgr, scriptMgr, renderer, renderPipeline));
 	return appPtr;
 }
\ No newline at end of file
@@ -0,0 +1,840 @@
+/* Benchmark.cpp
+Author: Jeff Kiah
+Orig.Date: 10/17/2026
+*/
+
+#include "Application/Benchmark.h"
+#include "Application/Timer.h"
+#include "Event/EventManager.h"
+#include "Event/ScriptData.h"
+#include "Event/RegisteredEvents.h"
+#include "Event/RemoteEvent.h"
+#include "Event/RemoteEventLink.h"
+#include "Event/EventHandler.h"
+#include "Event/EventRecorder.h"
+#include "Resource/ResourceProcess.h"
+#include "Utility/BinaryStream.h"
+#include "Utility/ConcurrentQueue.h"
+#include "Utility/LockFreeQueue.h"
+#include "Utility/Debug.h"
+#include <atomic>
+#include <cstdlib>
+#include <vector>
+#include <memory>
+#include <fstream>
+#include <sstream>
+#include <hash_map>
+#include <boost/thread/thread.hpp>
+
+///// STRUCTURES /////
+
+/*=============================================================================
+class BenchmarkEvent
+	Minimal event used to push real EventPtrs through the systems being
+	measured, so shared_ptr copy costs are included as they are in the engine
+=============================================================================*/
+class BenchmarkEvent : public Event {
+	public:
+		static const string			sEventType;
+		static const EventTypeId	sEventTypeId;
+
+		const string &	type() const	{ return sEventType; }
+		EventTypeId		typeId() const	{ return sEventTypeId; }
+
+		explicit BenchmarkEvent() : Event() {}
+		virtual ~BenchmarkEvent() {}
+};
+
+const string BenchmarkEvent::sEventType("SYS_BENCHMARK");
+const EventTypeId BenchmarkEvent::sEventTypeId(eventTypeIdOf(BenchmarkEvent::sEventType));
+
+/*=============================================================================
+class BenchListener
+	Counts the benchmark events it handles, and consumes them if asked
+=============================================================================*/
+class BenchListener : public EventListener {
+	public:
+		uint64_t	mHandled;
+		bool		mConsume;
+
+		bool handleEvent(const EventPtr &ePtr)
+		{
+			++mHandled;
+			return mConsume;
+		}
+
+		explicit BenchListener(uint32_t priority = 0, bool consume = false) :
+			EventListener("BenchListener"),
+			mHandled(0),
+			mConsume(consume)
+		{
+			registerEventHandler(BenchmarkEvent::sEventType,
+				IEventHandlerPtr(new EventHandler<BenchListener>(this, &BenchListener::handleEvent)), priority);
+		}
+		virtual ~BenchListener() {}
+};
+
+typedef vector<unique_ptr<BenchListener>>	BenchListenerList;
+
+/*=============================================================================
+class BenchRemoteEvent
+	Remote event shaped like ActorMovedEvent, positions quantized to 1/128
+	of a unit within +-4096 and rotations to 1/8191 within +-1
+=============================================================================*/
+class BenchRemoteEvent : public RemoteEvent {
+	public:
+		enum : WireFieldIndex {
+			Field_ActorId = 0,
+			Field_PositionX, Field_PositionY, Field_PositionZ,
+			Field_RotationW, Field_RotationX, Field_RotationY, Field_RotationZ,
+			Field_SystemGen,
+			Field_Name
+		};
+		static const string			sEventType;
+		static const EventTypeId	sEventTypeId;
+		static const WireSchemaPtr	sWireSchema;
+
+		uint32_t	mActorId;
+		float		mPosition[3];
+		float		mRotation[4];
+		int32_t		mSystemGen;
+		string		mName;
+
+		const string &	type() const	{ return sEventType; }
+		EventTypeId		typeId() const	{ return sEventTypeId; }
+		uint32_t		subject() const	{ return mActorId; }
+
+		void writeWire(WireWriter &out) const
+		{
+			out.writeUInt(Field_ActorId, mActorId);
+			for (int c = 0; c < 3; ++c) { out.writeFloat(static_cast<WireFieldIndex>(Field_PositionX + c), mPosition[c]); }
+			for (int c = 0; c < 4; ++c) { out.writeFloat(static_cast<WireFieldIndex>(Field_RotationW + c), mRotation[c]); }
+			out.writeInt(Field_SystemGen, mSystemGen);
+			out.writeString(Field_Name, mName);
+		}
+
+		static EventPtr readWire(WireReader &in, int targetClientId)
+		{
+			EventPtr ePtr(EventManager::make<BenchRemoteEvent>(targetClientId));
+			BenchRemoteEvent &e = static_cast<BenchRemoteEvent &>(*ePtr);
+			e.mActorId = in.readUInt(Field_ActorId);
+			for (int c = 0; c < 3; ++c) { e.mPosition[c] = in.readFloat(static_cast<WireFieldIndex>(Field_PositionX + c)); }
+			for (int c = 0; c < 4; ++c) { e.mRotation[c] = in.readFloat(static_cast<WireFieldIndex>(Field_RotationW + c)); }
+			e.mSystemGen = in.readInt(Field_SystemGen);
+			in.readString(Field_Name, e.mName);
+			return ePtr;
+		}
+
+		static WireSchemaPtr buildWireSchema()
+		{
+			shared_ptr<WireSchema> schema(new WireSchema());
+			schema->addUInt("actorID", 20);
+			schema->addQuantizedFloat("newPositionX", -4096.0f, 4096.0f, 20);
+			schema->addQuantizedFloat("newPositionY", -4096.0f, 4096.0f, 20);
+			schema->addQuantizedFloat("newPositionZ", -4096.0f, 4096.0f, 20);
+			schema->addQuantizedFloat("newRotationW", -1.0f, 1.0f, 14);
+			schema->addQuantizedFloat("newRotationX", -1.0f, 1.0f, 14);
+			schema->addQuantizedFloat("newRotationY", -1.0f, 1.0f, 14);
+			schema->addQuantizedFloat("newRotationZ", -1.0f, 1.0f, 14);
+			schema->addInt("systemGen", 0, 15);
+			schema->addString("name", 31);
+			return schema;
+		}
+
+		explicit BenchRemoteEvent(int targetClientId) :
+			RemoteEvent(targetClientId),
+			mActorId(0), mSystemGen(0)
+		{
+			mPosition[0] = mPosition[1] = mPosition[2] = 0.0f;
+			mRotation[0] = 1.0f; mRotation[1] = mRotation[2] = mRotation[3] = 0.0f;
+		}
+		virtual ~BenchRemoteEvent() {}
+};
+
+const string BenchRemoteEvent::sEventType("SYS_BENCHMARK_REMOTE");
+const EventTypeId BenchRemoteEvent::sEventTypeId(eventTypeIdOf(BenchRemoteEvent::sEventType));
+const WireSchemaPtr BenchRemoteEvent::sWireSchema(BenchRemoteEvent::buildWireSchema());
+
+/*=============================================================================
+	Script payload shaped like ActorMovedEvent, field indices in the order
+	they are added to the schema
+=============================================================================*/
+enum : ScriptFieldIndex {
+	BenchField_ActorId = 0,
+	BenchField_PositionX, BenchField_PositionY, BenchField_PositionZ,
+	BenchField_RotationW, BenchField_RotationX, BenchField_RotationY, BenchField_RotationZ,
+	BenchField_SystemGen,
+	BenchField_Name,
+	BenchField_MAX
+};
+
+static const char *sBenchFieldNames[BenchField_MAX] = {
+	"actorID",
+	"newPositionX", "newPositionY", "newPositionZ",
+	"newRotationW", "newRotationX", "newRotationY", "newRotationZ",
+	"systemGen",
+	"name"
+};
+
+///// FUNCTIONS /////
+
+/*---------------------------------------------------------------------
+	Runs one contention pass against any queue with the push/tryPop
+	surface, returns nanoseconds per item
+---------------------------------------------------------------------*/
+template <typename TQueue>
+double runQueueContention(TQueue &queue, int numProducers, int itemsPerProducer)
+{
+	EventPtr ePtr(EventManager::make<BenchmarkEvent>());
+	std::atomic<bool> go(false);
+
+	std::vector<boost::thread *> producers;
+	for (int t = 0; t < numProducers; ++t) {
+		producers.push_back(new boost::thread([&queue, &go, &ePtr, itemsPerProducer]() {
+			while (!go.load(std::memory_order_acquire)) { boost::this_thread::yield(); }
+			for (int i = 0; i < itemsPerProducer; ++i) {
+				queue.push(ePtr);
+			}
+		}));
+	}
+
+	int64_t start = Timer::queryCounts();
+	go.store(true, std::memory_order_release);
+
+	const int total = numProducers * itemsPerProducer;
+	EventPtr popped;
+	for (int received = 0; received < total; ) {
+		if (queue.tryPop(popped)) { ++received; }
+	}
+	int64_t stop = Timer::queryCounts();
+
+	for (size_t t = 0; t < producers.size(); ++t) {
+		producers[t]->join();
+		delete producers[t];
+	}
+	return Timer::secondsBetween(start, stop) * 1.0e9 / static_cast<double>(total);
+}
+
+/*---------------------------------------------------------------------
+	The i-th event of the trace benchmark, cycling through the three
+	resource load events with varied names, sizes and results
+---------------------------------------------------------------------*/
+EventPtr makeTraceEvent(int i)
+{
+	std::wostringstream resName;
+	resName << L"tex_" << i << L".dds";
+	const wstring sourceName((i & 4) ? L"textures" : L"data");
+	const size_t size = static_cast<size_t>(i) * 4099;
+	const bool success = (i % 7 != 0);
+	switch (i % 3) {
+		case 0:
+			return EventManager::make<AsyncLoadEvent>(resName.str(), sourceName,
+													  AsyncLoadEvent::ResSourcePtr(), ResPtr());
+		case 1:
+			return EventManager::make<AsyncLoadDoneEvent>(resName.str(), sourceName, BufferPtr(),
+														  size, ResPtr(), success);
+		default:
+			return EventManager::make<AsyncInitDoneEvent>(resName.str(), sourceName, BufferPtr(),
+														  size, ResPtr(), success);
+	}
+}
+
+/*---------------------------------------------------------------------
+	Returns true if a deserialized event carries the same data as the
+	one it was recorded from
+---------------------------------------------------------------------*/
+bool sameTraceEvent(const Event &recorded, const Event &replayed)
+{
+	if (recorded.typeId() != replayed.typeId()) { return false; }
+	if (recorded.typeId() == AsyncLoadEvent::sEventTypeId) {
+		const AsyncLoadEvent &a = static_cast<const AsyncLoadEvent &>(recorded);
+		const AsyncLoadEvent &b = static_cast<const AsyncLoadEvent &>(replayed);
+		return (a.mResName == b.mResName && a.mSourceName == b.mSourceName);
+	} else if (recorded.typeId() == AsyncLoadDoneEvent::sEventTypeId) {
+		const AsyncLoadDoneEvent &a = static_cast<const AsyncLoadDoneEvent &>(recorded);
+		const AsyncLoadDoneEvent &b = static_cast<const AsyncLoadDoneEvent &>(replayed);
+		return (a.mResName == b.mResName && a.mSourceName == b.mSourceName &&
+				a.mSize == b.mSize && a.mSuccess == b.mSuccess);
+	} else if (recorded.typeId() == AsyncInitDoneEvent::sEventTypeId) {
+		const AsyncInitDoneEvent &a = static_cast<const AsyncInitDoneEvent &>(recorded);
+		const AsyncInitDoneEvent &b = static_cast<const AsyncInitDoneEvent &>(replayed);
+		return (a.mResName == b.mResName && a.mSourceName == b.mSourceName &&
+				a.mSize == b.mSize && a.mSuccess == b.mSuccess && a.subject() == b.subject());
+	}
+	return false;
+}
+
+/*---------------------------------------------------------------------
+	Times body, which handles numEvents events, and counts the event pool
+	allocations it makes
+---------------------------------------------------------------------*/
+template <typename TFunc>
+BenchmarkCase runCase(const string &name, int numEvents, TFunc &&body)
+{
+	SlabPool::Stats before = EventManager::getAllocStats();
+	int64_t start = Timer::queryCounts();
+	body();
+	double seconds = Timer::secondsSince(start);
+	SlabPool::Stats after = EventManager::getAllocStats();
+
+	BenchmarkCase result = { name, seconds * 1.0e9 / numEvents,
+							 static_cast<double>(after.allocations - before.allocations) / numEvents };
+	debugPrintf("  %-48s %10.1f ns/event %6.2f allocs/event\n", name.c_str(), result.nsPerEvent, result.allocsPerEvent);
+	return result;
+}
+
+BenchListenerList makeListeners(int count, uint32_t priority = 0)
+{
+	BenchListenerList listeners;
+	listeners.reserve(count);
+	for (int l = 0; l < count; ++l) {
+		listeners.push_back(unique_ptr<BenchListener>(new BenchListener(priority)));
+	}
+	return listeners;
+}
+
+/*---------------------------------------------------------------------
+	Reads the ns/event column of an earlier report, keyed by case name
+---------------------------------------------------------------------*/
+bool readBenchmarkReport(const string &filename, hash_map<string, double> &outNsPerEvent)
+{
+	std::ifstream in(filename.c_str());
+	if (!in) { return false; }
+	string line;
+	while (std::getline(in, line)) {
+		if (line.empty() || line[0] == '#') { continue; }
+		size_t tab = line.find('\t');
+		if (tab == string::npos) { continue; }
+		outNsPerEvent[line.substr(0, tab)] = atof(line.c_str() + tab + 1);
+	}
+	return true;
+}
+
+/*---------------------------------------------------------------------
+	Event core benchmark
+---------------------------------------------------------------------*/
+BenchmarkResults benchmarkEventSystem(int eventsPerCase)
+{
+	BenchmarkResults results;
+	unique_ptr<EventSnooper> noSnooper; // the snooper is measured separately below
+	EventManagerPtr eventMgr(EventManager::create(noSnooper));
+	eventMgr->registerEventType(BenchmarkEvent::sEventType, RegEventPtr(new CodeOnlyEvent(EventDataType_NotEmpty)));
+	debugPrintf("Benchmark: event system, %i events per case\n", eventsPerCase);
+
+	// the basic paths with a single listener, raised events are handled 64 to a frame
+	{
+		BenchListener listener;
+		results.push_back(runCase("raise+notifyQueued, 1 listener", eventsPerCase, [&]() {
+			for (int i = 0; i < eventsPerCase; ++i) {
+				eventMgr->raise(EventManager::make<BenchmarkEvent>());
+				if ((i & 63) == 63) { eventMgr->notifyQueued(0); }
+			}
+			eventMgr->notifyQueued(0);
+		}));
+		results.push_back(runCase("trigger, 1 listener", eventsPerCase, [&]() {
+			for (int i = 0; i < eventsPerCase; ++i) {
+				eventMgr->trigger(EventManager::make<BenchmarkEvent>());
+			}
+		}));
+		EventPtr ePtr(EventManager::make<BenchmarkEvent>());
+		results.push_back(runCase("trigger prebuilt event, 1 listener", eventsPerCase, [&]() {
+			for (int i = 0; i < eventsPerCase; ++i) {
+				eventMgr->trigger(ePtr);
+			}
+		}));
+	}
+
+	// fan-out, fewer events as the listener count grows so each case does similar work,
+	// the single listener case is above
+	static const int sListenerCounts[] = { 10, 100, 1000, 10000 };
+	for (size_t c = 0; c < sizeof(sListenerCounts) / sizeof(sListenerCounts[0]); ++c) {
+		int numListeners = sListenerCounts[c];
+		int numEvents = (eventsPerCase / numListeners > 16 ? eventsPerCase / numListeners : 16);
+		BenchListenerList listeners(makeListeners(numListeners));
+		std::ostringstream name;
+		name << "trigger, " << numListeners << " listeners";
+		results.push_back(runCase(name.str(), numEvents, [&]() {
+			for (int i = 0; i < numEvents; ++i) {
+				eventMgr->trigger(EventManager::make<BenchmarkEvent>());
+			}
+		}));
+	}
+
+	// prioritized listeners registered out of order, and a consumer ahead of the rest
+	int fanOutEvents = eventsPerCase / 100;
+	{
+		BenchListenerList listeners;
+		for (int l = 0; l < 100; ++l) {
+			listeners.push_back(unique_ptr<BenchListener>(new BenchListener((l * 37) % 10)));
+		}
+		results.push_back(runCase("trigger, 100 listeners, mixed priorities", fanOutEvents, [&]() {
+			for (int i = 0; i < fanOutEvents; ++i) {
+				eventMgr->trigger(EventManager::make<BenchmarkEvent>());
+			}
+		}));
+	}
+	{
+		BenchListener consumer(1, true);
+		BenchListenerList listeners(makeListeners(99));
+		results.push_back(runCase("trigger, 100 listeners, first consumes", fanOutEvents, [&]() {
+			for (int i = 0; i < fanOutEvents; ++i) {
+				eventMgr->trigger(EventManager::make<BenchmarkEvent>());
+			}
+		}));
+	}
+
+	// the wildcard snooper sees every event ahead of the type's listeners
+	{
+		BenchListener listener;
+		unique_ptr<EventSnooper> snooper(new EventSnooper());
+		results.push_back(runCase("raise+notifyQueued, 1 listener + EventSnooper", eventsPerCase, [&]() {
+			for (int i = 0; i < eventsPerCase; ++i) {
+				eventMgr->raise(EventManager::make<BenchmarkEvent>());
+				if ((i & 63) == 63) { eventMgr->notifyQueued(0); }
+			}
+			eventMgr->notifyQueued(0);
+		}));
+		results.push_back(runCase("trigger, 1 listener + EventSnooper", eventsPerCase, [&]() {
+			for (int i = 0; i < eventsPerCase; ++i) {
+				eventMgr->trigger(EventManager::make<BenchmarkEvent>());
+			}
+		}));
+	}
+
+	// producer threads raising into the thread-safe queue while this thread pumps it
+	static const int sProducerCounts[] = { 1, 2, 4, 8 };
+	for (size_t c = 0; c < sizeof(sProducerCounts) / sizeof(sProducerCounts[0]); ++c) {
+		int numProducers = sProducerCounts[c];
+		int perProducer = eventsPerCase / numProducers;
+		uint64_t total = static_cast<uint64_t>(perProducer) * numProducers;
+		BenchListener listener;
+		std::ostringstream name;
+		name << "raiseThreadSafe, " << numProducers << (numProducers == 1 ? " producer" : " producers");
+		results.push_back(runCase(name.str(), static_cast<int>(total), [&]() {
+			vector<boost::thread *> producers;
+			for (int t = 0; t < numProducers; ++t) {
+				producers.push_back(new boost::thread([&eventMgr, perProducer]() {
+					for (int i = 0; i < perProducer; ++i) {
+						eventMgr->raiseThreadSafe(EventManager::make<BenchmarkEvent>());
+					}
+				}));
+			}
+			while (listener.mHandled < total) {
+				eventMgr->notifyQueued(0);
+			}
+			for (size_t t = 0; t < producers.size(); ++t) {
+				producers[t]->join();
+				delete producers[t];
+			}
+		}));
+	}
+
+	return results;
+}
+
+/*---------------------------------------------------------------------
+	Contention benchmark for the thread-safe event queues
+---------------------------------------------------------------------*/
+QueueBenchmarkResult benchmarkThreadSafeQueues(int numProducers, int itemsPerProducer)
+{
+	QueueBenchmarkResult result;
+	{
+		ConcurrentQueue<EventPtr> q;
+		result.mutexNsPerItem = runQueueContention(q, numProducers, itemsPerProducer);
+	}
+	{
+		MPSCQueue<EventPtr> q;
+		result.mpscNsPerItem = runQueueContention(q, numProducers, itemsPerProducer);
+	}
+	{
+		MPMCQueue<EventPtr> q;
+		result.mpmcNsPerItem = runQueueContention(q, numProducers, itemsPerProducer);
+	}
+	debugPrintf("Benchmark: queue contention, %i producers x %i items\n", numProducers, itemsPerProducer);
+	debugPrintf("  ConcurrentQueue  %8.1f ns/item\n", result.mutexNsPerItem);
+	debugPrintf("  MPSCQueue        %8.1f ns/item\n", result.mpscNsPerItem);
+	debugPrintf("  MPMCQueue        %8.1f ns/item\n", result.mpmcNsPerItem);
+	return result;
+}
+
+/*---------------------------------------------------------------------
+	Script payload benchmark, AnyVars against ScriptData
+---------------------------------------------------------------------*/
+ScriptDataBenchmarkResult benchmarkScriptData(int iterations)
+{
+	ScriptDataBenchmarkResult result;
+	const string name("crate_017");
+	double sink = 0.0;	// printed at the end so the reads can't be optimized away
+
+	// AnyVars, built as buildScriptData did and read back as the AnyVars constructors did
+	{
+		int64_t start = Timer::queryCounts();
+		for (int i = 0; i < iterations; ++i) {
+			AnyVars vars;
+			vars.push_back(AnyVarsValue(sBenchFieldNames[BenchField_ActorId], i));
+			vars.push_back(AnyVarsValue(sBenchFieldNames[BenchField_PositionX], 1.0f));
+			vars.push_back(AnyVarsValue(sBenchFieldNames[BenchField_PositionY], 2.0f));
+			vars.push_back(AnyVarsValue(sBenchFieldNames[BenchField_PositionZ], 3.0f));
+			vars.push_back(AnyVarsValue(sBenchFieldNames[BenchField_RotationW], 1.0f));
+			vars.push_back(AnyVarsValue(sBenchFieldNames[BenchField_RotationX], 0.0f));
+			vars.push_back(AnyVarsValue(sBenchFieldNames[BenchField_RotationY], 0.0f));
+			vars.push_back(AnyVarsValue(sBenchFieldNames[BenchField_RotationZ], 0.0f));
+			vars.push_back(AnyVarsValue(sBenchFieldNames[BenchField_SystemGen], 1));
+			vars.push_back(AnyVarsValue(sBenchFieldNames[BenchField_Name], name));
+			AnyVars copy(vars);	// ScriptableEvent(const AnyVars &) copied the list into the event
+
+			for (AnyVars::const_iterator v = copy.begin(); v != copy.end(); ++v) {
+				if (_stricmp(v->first.c_str(), "actorID") == 0) {
+					sink += any_cast<int>(v->second);
+				} else if (_stricmp(v->first.c_str(), "systemGen") == 0) {
+					sink += any_cast<int>(v->second);
+				} else if (_stricmp(v->first.c_str(), "name") == 0) {
+					sink += any_cast<string>(v->second).size();
+				} else {
+					for (int f = BenchField_PositionX; f <= BenchField_RotationZ; ++f) {
+						if (_stricmp(v->first.c_str(), sBenchFieldNames[f]) == 0) {
+							sink += any_cast<float>(v->second);
+							break;
+						}
+					}
+				}
+			}
+		}
+		result.anyVarsNsPerEvent = Timer::secondsSince(start) * 1.0e9 / iterations;
+	}
+
+	shared_ptr<ScriptDataSchema> schema(new ScriptDataSchema());
+	schema->addField(sBenchFieldNames[BenchField_ActorId], ScriptField_Int);
+	for (int f = BenchField_PositionX; f <= BenchField_RotationZ; ++f) {
+		schema->addField(sBenchFieldNames[f], ScriptField_Float);
+	}
+	schema->addField(sBenchFieldNames[BenchField_SystemGen], ScriptField_Int);
+	schema->addField(sBenchFieldNames[BenchField_Name], ScriptField_String);
+	schema->reserveStrings(16);
+	ScriptDataSchemaPtr schemaPtr(schema);
+	ScriptData scratch;	// reused like the script manager's scratch data
+
+	// ScriptData, built and read by index as code does
+	{
+		int64_t start = Timer::queryCounts();
+		for (int i = 0; i < iterations; ++i) {
+			scratch.reset(schemaPtr);
+			scratch.setInt(BenchField_ActorId, i);
+			scratch.setFloat(BenchField_PositionX, 1.0f);
+			scratch.setFloat(BenchField_PositionY, 2.0f);
+			scratch.setFloat(BenchField_PositionZ, 3.0f);
+			scratch.setFloat(BenchField_RotationW, 1.0f);
+			scratch.setFloat(BenchField_RotationX, 0.0f);
+			scratch.setFloat(BenchField_RotationY, 0.0f);
+			scratch.setFloat(BenchField_RotationZ, 0.0f);
+			scratch.setInt(BenchField_SystemGen, 1);
+			scratch.setString(BenchField_Name, name);
+			ScriptData copy(scratch);	// ScriptableEvent(const ScriptData &) copies the blob into the event
+
+			sink += copy.getInt(BenchField_ActorId) + copy.getInt(BenchField_SystemGen);
+			for (int f = BenchField_PositionX; f <= BenchField_RotationZ; ++f) {
+				sink += copy.getFloat(static_cast<ScriptFieldIndex>(f));
+			}
+			size_t length = 0;
+			copy.getString(BenchField_Name, &length);
+			sink += length;
+		}
+		result.scriptDataNsPerEvent = Timer::secondsSince(start) * 1.0e9 / iterations;
+	}
+
+	// ScriptData, built and read by name through the schema, as a script binding without cached indices would
+	{
+		const string names[BenchField_MAX] = {
+			sBenchFieldNames[0], sBenchFieldNames[1], sBenchFieldNames[2], sBenchFieldNames[3], sBenchFieldNames[4],
+			sBenchFieldNames[5], sBenchFieldNames[6], sBenchFieldNames[7], sBenchFieldNames[8], sBenchFieldNames[9]
+		};
+		int64_t start = Timer::queryCounts();
+		for (int i = 0; i < iterations; ++i) {
+			scratch.reset(schemaPtr);
+			for (int f = 0; f < BenchField_MAX - 1; ++f) {
+				scratch.setNumber(schemaPtr->findField(names[f]), (f == BenchField_ActorId ? i : f));
+			}
+			scratch.setString(schemaPtr->findField(names[BenchField_Name]), name);
+			ScriptData copy(scratch);
+			for (int f = 0; f < BenchField_MAX - 1; ++f) {
+				sink += copy.getNumber(schemaPtr->findField(names[f]));
+			}
+			size_t length = 0;
+			copy.getString(schemaPtr->findField(names[BenchField_Name]), &length);
+			sink += length;
+		}
+		result.byNameNsPerEvent = Timer::secondsSince(start) * 1.0e9 / iterations;
+	}
+
+	debugPrintf("Benchmark: script payload, %i events of %i fields (checksum %.0f)\n", iterations, (int)BenchField_MAX, sink);
+	debugPrintf("  AnyVars             %8.1f ns/event\n", result.anyVarsNsPerEvent);
+	debugPrintf("  ScriptData by index %8.1f ns/event\n", result.scriptDataNsPerEvent);
+	debugPrintf("  ScriptData by name  %8.1f ns/event\n", result.byNameNsPerEvent);
+	return result;
+}
+
+/*---------------------------------------------------------------------
+	Remote event benchmark, wire format and loopback throughput
+---------------------------------------------------------------------*/
+RemoteEventBenchmarkResult benchmarkRemoteEvents(const EventManagerPtr &eventMgr, int numEvents)
+{
+	RemoteEventBenchmarkResult result;
+	if (!eventMgr->isEventTypeRegistered(BenchRemoteEvent::sEventTypeId)) {
+		eventMgr->registerEventType(BenchRemoteEvent::sEventType,
+			RegEventPtr(new RemoteCallableEvent<BenchRemoteEvent>(EventDataType_NotEmpty)));
+	}
+	RegEventPtr regPtr(eventMgr->getRegEventPtr(BenchRemoteEvent::sEventTypeId));
+	const WireSchema &schema = *regPtr->getWireSchema();
+
+	EventPtr ePtr(EventManager::make<BenchRemoteEvent>(7));
+	BenchRemoteEvent &e = static_cast<BenchRemoteEvent &>(*ePtr);
+	e.mActorId = 1017;
+	e.mPosition[0] = 12.5f; e.mPosition[1] = -3.25f; e.mPosition[2] = 100.0f;
+	e.mRotation[0] = 0.7071f; e.mRotation[2] = 0.7071f;
+	e.mSystemGen = 3;
+	e.mName = "crate_017";
+	double sink = 0.0;	// printed at the end so the decodes can't be optimized away
+
+	// unpacked size, the fields copied as-is the way the event recorder writes payloads
+	{
+		vector<uint8_t> raw;
+		BinaryWriter out(raw);
+		out.write(e.mActorId);
+		out.writeBytes(e.mPosition, sizeof(e.mPosition));
+		out.writeBytes(e.mRotation, sizeof(e.mRotation));
+		out.write(e.mSystemGen);
+		out.writeString(e.mName);
+		result.rawBytesPerEvent = static_cast<double>(raw.size() + sizeof(EventTypeId) + sizeof(int32_t));
+	}
+
+	// packing and unpacking alone, one event record at a time through the same buffer
+	uint8_t packet[1200];
+	BitWriter writer(packet, sizeof(packet));
+	{
+		int64_t start = Timer::queryCounts();
+		for (int i = 0; i < numEvents; ++i) {
+			writer.reset(packet, sizeof(packet));
+			writer.writeBits(e.typeId(), 32);
+			writer.writeBool(e.isBroadcast());
+			writer.writeBits(static_cast<uint32_t>(e.targetClientId()), 16);
+			WireWriter wireOut(writer, schema);
+			e.writeWire(wireOut);
+		}
+		result.encodeNsPerEvent = Timer::secondsSince(start) * 1.0e9 / numEvents;
+	}
+	size_t recordBytes = writer.finish();
+	{
+		int64_t start = Timer::queryCounts();
+		for (int i = 0; i < numEvents; ++i) {
+			BitReader in(packet, recordBytes);
+			EventTypeId eventTypeId = in.readBits(32);
+			int targetClientId = (in.readBool() ? -1 : static_cast<int>(in.readBits(16)));
+			EventPtr decoded(eventMgr->readRemoteEvent(eventTypeId, in, targetClientId));
+			sink += static_cast<BenchRemoteEvent &>(*decoded).mPosition[2];
+		}
+		result.decodeNsPerEvent = Timer::secondsSince(start) * 1.0e9 / numEvents;
+	}
+
+	// end to end, packets are received and triggered every 256 events, well before the ring fills
+	{
+		LoopbackTransport transport(64, 1200);
+		RemoteEventLink link(transport, eventMgr);
+		int64_t start = Timer::queryCounts();
+		for (int i = 0; i < numEvents; ++i) {
+			EventPtr sendPtr(EventManager::make<BenchRemoteEvent>(-1));
+			BenchRemoteEvent &se = static_cast<BenchRemoteEvent &>(*sendPtr);
+			se.mActorId = static_cast<uint32_t>(i) & 0xFFFFF;
+			se.mPosition[0] = static_cast<float>(i & 1023);
+			se.mName = e.mName;
+			link.send(sendPtr);
+			if ((i & 255) == 255) {
+				link.flush();
+				link.receive(true);
+			}
+		}
+		link.flush();
+		link.receive(true);
+		double seconds = Timer::secondsSince(start);
+		const RemoteEventLink::Stats &stats = link.getStats();
+		result.eventsPerSecond = static_cast<double>(stats.eventsReceived) / seconds;
+		result.packedBytesPerEvent = static_cast<double>(stats.bytesSent) / static_cast<double>(stats.eventsSent);
+		debugPrintf("Benchmark: remote events, %i events (checksum %.0f)\n", numEvents, sink);
+		debugPrintf("  sent %llu received %llu dropped %llu in %llu packets\n",
+					(unsigned long long)stats.eventsSent, (unsigned long long)stats.eventsReceived,
+					(unsigned long long)stats.eventsDropped, (unsigned long long)stats.packetsSent);
+	}
+
+	debugPrintf("  wire format      %8.1f bytes/event (unpacked %.1f)\n", result.packedBytesPerEvent, result.rawBytesPerEvent);
+	debugPrintf("  encode           %8.1f ns/event\n", result.encodeNsPerEvent);
+	debugPrintf("  decode           %8.1f ns/event\n", result.decodeNsPerEvent);
+	debugPrintf("  loopback         %8.0f events/sec\n", result.eventsPerSecond);
+	return result;
+}
+
+/*---------------------------------------------------------------------
+	Event trace benchmark and round trip check
+---------------------------------------------------------------------*/
+EventTraceBenchmarkResult benchmarkEventTrace(const EventManagerPtr &eventMgr, int numEvents, const string &traceFile)
+{
+	EventTraceBenchmarkResult result;
+	memset(&result, 0, sizeof(result));
+	if (!eventMgr->isEventTypeRegistered(AsyncLoadEvent::sEventTypeId)) {
+		eventMgr->registerEventType(AsyncLoadEvent::sEventType,
+			RegEventPtr(new ReplayableCodeOnlyEvent<AsyncLoadEvent>(EventDataType_NotEmpty)));
+	}
+	if (!eventMgr->isEventTypeRegistered(AsyncLoadDoneEvent::sEventTypeId)) {
+		eventMgr->registerEventType(AsyncLoadDoneEvent::sEventType,
+			RegEventPtr(new ReplayableCodeOnlyEvent<AsyncLoadDoneEvent>(EventDataType_NotEmpty)));
+	}
+	if (!eventMgr->isEventTypeRegistered(AsyncInitDoneEvent::sEventTypeId)) {
+		eventMgr->registerEventType(AsyncInitDoneEvent::sEventType,
+			RegEventPtr(new ReplayableCodeOnlyEvent<AsyncInitDoneEvent>(EventDataType_NotEmpty)));
+	}
+	debugPrintf("Benchmark: event trace, %i events\n", numEvents);
+
+	// the events are built up front so only triggering and recording are timed
+	vector<EventPtr> events;
+	events.reserve(numEvents);
+	for (int i = 0; i < numEvents; ++i) {
+		events.push_back(makeTraceEvent(i));
+	}
+
+	EventRecorderPtr recorder(std::make_shared<EventRecorder>());
+	EventRecorderPtr prevRecorder(eventMgr->getRecorder());
+	eventMgr->setRecorder(recorder);
+	{
+		int64_t start = Timer::queryCounts();
+		for (int i = 0; i < numEvents; ++i) {
+			eventMgr->trigger(events[i]);
+		}
+		result.recordNsPerEvent = Timer::secondsSince(start) * 1.0e9 / numEvents;
+	}
+	eventMgr->setRecorder(prevRecorder);
+
+	EventTrace trace;
+	if (!recorder->save(traceFile, *eventMgr) || !trace.load(traceFile)) {
+		debugPrintf("  cannot save and load \"%s\"\n", traceFile.c_str());
+		result.numMismatched = static_cast<uint32_t>(numEvents);
+		return result;
+	}
+	const vector<EventTrace::Record> &records = trace.records();
+	if (recorder->numDropped() > 0 || records.size() != events.size()) {
+		debugPrintf("  recorded %llu events, dropped %llu, %u in the trace\n",
+					(unsigned long long)recorder->numRecorded(), (unsigned long long)recorder->numDropped(),
+					(uint32_t)records.size());
+	}
+
+	vector<EventPtr> replayed(records.size());
+	size_t payloadBytes = 0;
+	{
+		int64_t start = Timer::queryCounts();
+		for (size_t r = 0; r < records.size(); ++r) {
+			BinaryReader in(records[r].payload, records[r].payloadSize);
+			replayed[r] = eventMgr->deserializeEvent(records[r].typeId, in);
+			payloadBytes += records[r].payloadSize;
+		}
+		result.deserializeNsPerEvent = Timer::secondsSince(start) * 1.0e9 / (records.empty() ? 1 : records.size());
+	}
+	result.bytesPerEvent = static_cast<double>(payloadBytes + records.size() * sizeof(EventRecordHeader)) /
+						   (records.empty() ? 1 : records.size());
+
+	// every triggered event must come back in order with the same data
+	for (size_t i = 0; i < events.size(); ++i) {
+		if (i >= records.size() || !replayed[i] ||
+			records[i].state != EventState_Triggered ||
+			!sameTraceEvent(*events[i], *replayed[i]))
+		{
+			if (result.numMismatched < 8) {
+				debugPrintf("  event %u did not survive the round trip\n", (uint32_t)i);
+			}
+			++result.numMismatched;
+		}
+	}
+	_ASSERTE(result.numMismatched == 0 && "Event trace round trip mismatch");
+
+	debugPrintf("  record           %8.1f ns/event\n", result.recordNsPerEvent);
+	debugPrintf("  deserialize      %8.1f ns/event\n", result.deserializeNsPerEvent);
+	debugPrintf("  trace size       %8.1f bytes/event\n", result.bytesPerEvent);
+	debugPrintf("  round trip       %u of %i events mismatched\n", result.numMismatched, numEvents);
+	return result;
+}
+
+/*---------------------------------------------------------------------
+	Runs every benchmark and writes the report
+---------------------------------------------------------------------*/
+bool runBenchmarkSuite(const string &reportFile, const string &baselineFile)
+{
+	BenchmarkResults results(benchmarkEventSystem(200000));
+	bool traceRoundTripOk = true;
+
+	{
+		const int producers = 4, items = 100000;
+		QueueBenchmarkResult q = benchmarkThreadSafeQueues(producers, items);
+		BenchmarkCase queueCases[3] = {
+			{ "ConcurrentQueue, 4 producers", q.mutexNsPerItem, 0.0 },
+			{ "MPSCQueue, 4 producers", q.mpscNsPerItem, 0.0 },
+			{ "MPMCQueue, 4 producers", q.mpmcNsPerItem, 0.0 }
+		};
+		results.insert(results.end(), queueCases, queueCases + 3);
+	}
+	{
+		ScriptDataBenchmarkResult sd = benchmarkScriptData(100000);
+		BenchmarkCase scriptCases[3] = {
+			{ "script payload, AnyVars", sd.anyVarsNsPerEvent, 0.0 },
+			{ "script payload, ScriptData by index", sd.scriptDataNsPerEvent, 0.0 },
+			{ "script payload, ScriptData by name", sd.byNameNsPerEvent, 0.0 }
+		};
+		results.insert(results.end(), scriptCases, scriptCases + 3);
+	}
+	{
+		unique_ptr<EventSnooper> noSnooper;
+		EventManagerPtr eventMgr(EventManager::create(noSnooper));
+		RemoteEventBenchmarkResult r = benchmarkRemoteEvents(eventMgr, 200000);
+		BenchmarkCase remoteCases[3] = {
+			{ "remote event encode", r.encodeNsPerEvent, 0.0 },
+			{ "remote event decode", r.decodeNsPerEvent, 0.0 },
+			{ "remote event loopback", 1.0e9 / r.eventsPerSecond, 0.0 }
+		};
+		results.insert(results.end(), remoteCases, remoteCases + 3);
+
+		EventTraceBenchmarkResult t = benchmarkEventTrace(eventMgr, 100000, reportFile + ".trace");
+		BenchmarkCase traceCases[2] = {
+			{ "event trace record", t.recordNsPerEvent, 0.0 },
+			{ "event trace deserialize", t.deserializeNsPerEvent, 0.0 }
+		};
+		results.insert(results.end(), traceCases, traceCases + 2);
+		traceRoundTripOk = (t.numMismatched == 0);
+	}
+
+	hash_map<string, double> baseline;
+	bool haveBaseline = (!baselineFile.empty() && readBenchmarkReport(baselineFile, baseline));
+	if (!baselineFile.empty() && !haveBaseline) {
+		debugPrintf("Benchmark: cannot read baseline \"%s\"\n", baselineFile.c_str());
+	}
+
+	std::ofstream out(reportFile.c_str());
+	if (!out) {
+		debugPrintf("Benchmark: cannot write report \"%s\"\n", reportFile.c_str());
+		return false;
+	}
+	out << "# case\tns/event\tallocs/event";
+	if (haveBaseline) { out << "\tbaseline ns/event\tchange"; }
+	out << "\n";
+	out.setf(std::ios::fixed);
+	out.precision(2);
+	for (size_t c = 0; c < results.size(); ++c) {
+		const BenchmarkCase &bc = results[c];
+		out << bc.name << "\t" << bc.nsPerEvent << "\t" << bc.allocsPerEvent;
+		hash_map<string, double>::const_iterator bi = baseline.find(bc.name);
+		if (haveBaseline && bi != baseline.end() && bi->second > 0.0) {
+			double change = (bc.nsPerEvent - bi->second) * 100.0 / bi->second;
+			out << "\t" << bi->second << "\t" << (change >= 0.0 ? "+" : "") << change << "%";
+			debugPrintf("  %-48s %+7.1f%% vs baseline\n", bc.name.c_str(), change);
+		}
+		out << "\n";
+	}
+	if (!traceRoundTripOk) {
+		debugPrintf("Benchmark: event trace round trip failed\n");
+	}
+	return (out.good() && traceRoundTripOk);
+}
@@ -0,0 +1,160 @@
+/* RenderPipeline.cpp
+Author: Jeff Kiah
+Orig.Date: 10/17/2026
+*/
+
+#include "Application/RenderPipeline.h"
+#include "Application/Timer.h"
+#include "Utility/ThreadPool.h"
+#include "Utility/Debug.h"
+
+///// FUNCTIONS /////
+
+void RenderPipeline::renderLoop()
+{
+	ThreadPool::setCurrentThreadClass(ThreadClass_Latency, mAffinityMask);
+
+	boost::mutex::scoped_lock lock(mMutex);
+	for (;;) {
+		while (!mPending && !mStopping) {
+			mSubmitted.wait(lock);
+		}
+		// a frame submitted before the stop is still drawn
+		if (!mPending) { break; }
+		const RenderFrame &frame = mFrames[mRenderIndex];
+		lock.unlock();
+
+		mRenderFunc(frame);
+
+		lock.lock();
+		mPending = false;
+		mRendered.notify_all();
+	}
+}
+
+void RenderPipeline::startThread()
+{
+	_ASSERTE(!mThread);
+	mStopping = false;
+	mThread.reset(new boost::thread(&RenderPipeline::renderLoop, this));
+}
+
+void RenderPipeline::stopThread()
+{
+	if (!mThread) { return; }
+	{
+		boost::mutex::scoped_lock lock(mMutex);
+		mStopping = true;
+		mSubmitted.notify_all();
+	}
+	mThread->join();
+	mThread.reset();
+	presentRendered();
+}
+
+void RenderPipeline::waitForRender()
+{
+	if (!mThread) { return; }
+	_ASSERTE(boost::this_thread::get_id() != mThread->get_id() && "render function waited for itself");
+	boost::mutex::scoped_lock lock(mMutex);
+	if (!mPending) { return; }
+
+	int64_t startCounts = Timer::queryCounts();
+	while (mPending) {
+		mRendered.wait(lock);
+	}
+	double waitMillis = Timer::secondsSince(startCounts) * 1000.0;
+	++mStats.framesWaited;
+	mStats.waitMillis += waitMillis;
+	if (waitMillis > mStats.maxWaitMillis) { mStats.maxWaitMillis = waitMillis; }
+}
+
+void RenderPipeline::presentRendered()
+{
+	if (!mPresentPending) { return; }
+	waitForRender();
+	mPresentPending = false;
+	mPresentFunc();
+}
+
+void RenderPipeline::renderSubmitted()
+{
+	++mStats.frames;
+	if (!mThread) {
+		mRenderFunc(mFrames[mRenderIndex]);
+		mPresentFunc();
+		return;
+	}
+	mPresentPending = true;
+	boost::mutex::scoped_lock lock(mMutex);
+	mPending = true;
+	mSubmitted.notify_one();
+}
+
+/*---------------------------------------------------------------------
+	Once the frame before has been drawn and presented, neither frame is
+	in use by the render thread, so the write frame can be handed over
+	and the other one reused
+---------------------------------------------------------------------*/
+void RenderPipeline::submit()
+{
+	presentRendered();
+
+	mFrames[mWriteIndex].frameIndex = ++mFrameCount;
+	mRenderIndex = mWriteIndex;
+	mWriteIndex ^= 1;
+	mFrames[mWriteIndex].clear();
+	renderSubmitted();
+}
+
+void RenderPipeline::resubmit()
+{
+	if (mFrameCount == 0) { return; } // nothing submitted yet
+	presentRendered();
+	renderSubmitted();
+}
+
+void RenderPipeline::setPipelined(bool pipelined)
+{
+	if (pipelined == isPipelined()) { return; }
+	if (pipelined) {
+		startThread();
+	} else {
+		stopThread();
+	}
+	debugPrintf("RenderPipeline: %s rendering\n", (pipelined ? "pipelined" : "serial"));
+}
+
+void RenderPipeline::logStats() const
+{
+	debugPrintf("RenderPipeline: %llu frames %s, waited for the render thread %llu frames, avg %.3fms max %.3fms\n",
+				mStats.frames, (isPipelined() ? "pipelined" : "serial"), mStats.framesWaited,
+				(mStats.framesWaited > 0 ? mStats.waitMillis / mStats.framesWaited : 0.0),
+				mStats.maxWaitMillis);
+}
+
+// Constructor / destructor
+RenderPipeline::RenderPipeline(const RenderFunc &renderFunc, const PresentFunc &presentFunc,
+							   bool pipelined, uint64_t affinityMask) :
+	mWriteIndex(0),
+	mRenderIndex(0),
+	mRenderFunc(renderFunc),
+	mPresentFunc(presentFunc),
+	mAffinityMask(affinityMask),
+	mFrameCount(0),
+	mPending(false),
+	mStopping(false),
+	mPresentPending(false)
+{
+	_ASSERTE(mRenderFunc && mPresentFunc);
+	memset(&mStats, 0, sizeof(mStats));
+	if (pipelined) { startThread(); }
+}
+
+/*---------------------------------------------------------------------
+	Draws and presents the frame in flight before the render thread stops
+---------------------------------------------------------------------*/
+RenderPipeline::~RenderPipeline()
+{
+	stopThread();
+}
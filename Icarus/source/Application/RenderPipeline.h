@@ -0,0 +1,137 @@
+/* RenderPipeline.h
+Author: Jeff Kiah
+Orig.Date: 10/17/2026
+*/
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <functional>
+#include <boost/noncopyable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/thread.hpp>
+#include "Render/RenderFrame.h"
+
+using std::shared_ptr;
+using std::unique_ptr;
+
+///// STRUCTURES /////
+
+/*=============================================================================
+class RenderPipeline
+	Hands each frame's RenderFrame from the main thread to the renderer.
+	Pipelined, the frame is drawn on a render thread of its own while the
+	main thread updates the next frame into the other of two RenderFrames,
+	so update and render overlap and a frame reaches the screen one frame
+	later than it would serially. Submitting waits only if the render
+	thread is still drawing the frame before, that is when rendering takes
+	longer than updating. Serial, the frame is drawn on the main thread as
+	it is submitted, which is easier to debug and can be switched to at any
+	time between frames.
+	Only drawing moves to the render thread. The present function runs on
+	the main thread, once the frame is drawn and before the next one is
+	handed over, because Present can need the window's message thread and
+	the main thread would be waiting in submit.
+	While pipelined, the render function owns the renderer's immediate
+	context, so other main thread code that uses it must call
+	waitForRender first, which the renderer's waitForContext does once
+	the pipeline is installed with setContextWait.
+=============================================================================*/
+class RenderPipeline : private boost::noncopyable {
+	public:
+		///// DEFINITIONS /////
+		typedef std::function<void(const RenderFrame &)>	RenderFunc;
+		typedef std::function<void()>						PresentFunc;
+
+		struct Stats {
+			uint64_t	frames;				// frames rendered
+			uint64_t	framesWaited;		// submits that waited for the render thread
+			double		waitMillis;			// total time the main thread waited
+			double		maxWaitMillis;
+		};
+
+	private:
+		///// VARIABLES /////
+		RenderFrame						mFrames[2];
+		uint32_t						mWriteIndex;	// the frame the main thread fills
+		uint32_t						mRenderIndex;	// the last frame submitted
+		RenderFunc						mRenderFunc;
+		PresentFunc						mPresentFunc;
+		unique_ptr<boost::thread>		mThread;		// null while serial
+		boost::mutex					mMutex;
+		boost::condition_variable		mSubmitted;		// signaled when a frame is submitted or on stop
+		boost::condition_variable		mRendered;		// signaled when the render thread finishes a frame
+		uint64_t						mAffinityMask;
+		uint64_t						mFrameCount;
+		Stats							mStats;
+		bool							mPending;		// guarded by mMutex, a submitted frame isn't drawn yet
+		bool							mStopping;		// guarded by mMutex
+		bool							mPresentPending;	// main thread only, a frame handed to the render thread isn't presented yet
+
+		///// FUNCTIONS /////
+		void	renderLoop();
+		void	startThread();
+		void	stopThread();
+
+		/*---------------------------------------------------------------------
+			Waits for the frame handed to the render thread and presents it
+			here on the main thread
+		---------------------------------------------------------------------*/
+		void	presentRendered();
+
+		/*---------------------------------------------------------------------
+			Draws and presents mFrames[mRenderIndex] here when serial, or
+			passes it to the render thread to draw
+		---------------------------------------------------------------------*/
+		void	renderSubmitted();
+
+	public:
+		/*---------------------------------------------------------------------
+			The frame for the main thread to fill this update, empty but for
+			what was added since the last submit
+		---------------------------------------------------------------------*/
+		RenderFrame &	writeFrame()	{ return mFrames[mWriteIndex]; }
+
+		/*---------------------------------------------------------------------
+			Presents the frame drawn before, renders the write frame, then
+			makes the other frame the write frame and clears it
+		---------------------------------------------------------------------*/
+		void	submit();
+
+		/*---------------------------------------------------------------------
+			Renders the last submitted frame again without taking the write
+			frame, such as while the application is paused
+		---------------------------------------------------------------------*/
+		void	resubmit();
+
+		/*---------------------------------------------------------------------
+			Returns once the render thread has drawn every submitted frame.
+			Main thread only, another thread could see a frame submitted
+			right after it returns.
+		---------------------------------------------------------------------*/
+		void	waitForRender();
+
+		/*---------------------------------------------------------------------
+			Switches between pipelined and serial rendering, waiting for the
+			frame in flight and presenting it. Main thread only.
+		---------------------------------------------------------------------*/
+		void	setPipelined(bool pipelined);
+		bool	isPipelined() const		{ return (mThread != 0); }
+
+		const Stats &	stats() const	{ return mStats; }
+		void	logStats() const;
+
+		// Constructor / destructor
+		/*---------------------------------------------------------------------
+			renderFunc draws a frame, on the render thread when pipelined, and
+			presentFunc shows it, always on the main thread. The render thread
+			runs at ThreadClass_Latency priority on the cores of affinityMask,
+			0 for any
+		---------------------------------------------------------------------*/
+		explicit RenderPipeline(const RenderFunc &renderFunc, const PresentFunc &presentFunc,
+								bool pipelined, uint64_t affinityMask = 0);
+		~RenderPipeline();
+};
+
+typedef shared_ptr<RenderPipeline>	RenderPipelinePtr;
@@ -20,6 +20,13 @@ class Settings {
 		bool fullscreen;		// true if fullscreen mode desired
 		bool fullscreenSet;		// true if fullscreen mode actually set, false if windowed
 		bool vsync;				// applies to fullscreen mode only
+		unsigned int eventBudgetMillis;	// time allowed per frame for queued events, 0 for no limit
+		unsigned int processBudgetMillis;	// time allowed per frame for processes, async ones are deferred past it, 0 for no limit
+		unsigned int threadPoolMaxThreads;	// cap on threads running ThreadProcesses, more wait for one to finish
+		bool pipelinedRender;	// render each frame on the render thread while the next updates, false to render serially for debugging
+		bool recordEvents;		// record raised and triggered events, saved to eventTraceFile on exit
+		string eventTraceFile;	// example "eventtrace.bin"
+		string replayEventTrace;	// trace file to replay at startup, empty for none
 
 		string dataDir;			// example "data/"
 
@@ -44,6 +51,13 @@ class Settings {
 			refreshRate(60),
 			fullscreen(false), fullscreenSet(false),
 			vsync(true),
+			eventBudgetMillis(4),
+			processBudgetMillis(8),
+			threadPoolMaxThreads(4),
+			pipelinedRender(true),
+			recordEvents(false),
+			eventTraceFile("eventtrace.bin"),
+			replayEventTrace(),
 			dataDir("data/")
 		{}
 		~Settings() {}
@@ -10,6 +10,7 @@ Started: 5/16/12
 #include "Application/Settings.h"
 #include "Application/Application.h"
 #include "Application/Timer.h"
+#include "Application/Benchmark.h"
 
 using std::unique_ptr;
 
@@ -41,6 +42,12 @@ int WINAPI wWinMain(HINSTANCE hInstance, HINSTANCE, PWSTR pCmdLine, int nCmdShow
 		return 0;
 	}
 
+	// -benchmark runs the benchmark suite instead of the game and exits, writing benchmark.txt and
+	// comparing against benchmark_baseline.txt if there is one (a copy of an earlier report)
+	if (pCmdLine && wcsstr(pCmdLine, L"-benchmark")) {
+		return (runBenchmarkSuite("benchmark.txt", "benchmark_baseline.txt") ? 0 : 1);
+	}
+
 	// init window and input devices
 	if (!win32.initWindow()) { return 0; }
 	if (!win32.initInputDevices()) { return 0; }
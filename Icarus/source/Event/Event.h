@@ -13,6 +13,7 @@
 #include <boost/noncopyable.hpp>
 #include <boost/any.hpp>
 #include <iostream>
+#include "ScriptData.h"
 #include "Utility/Debug.h"
 
 using std::string;	using std::shared_ptr;
@@ -36,6 +37,36 @@ enum EventSource : uint8_t {
 	EventSource_Remote			// allow the event to be raised/triggered from remote client
 };
 
+/*=============================================================================
+	Priority class of an event type, set when the type is registered. Queued
+	events are handled in class order each frame. High events are always
+	handled in the frame they are queued, Normal and Low events stop when the
+	notifyQueued budget runs out and roll over to the next frame, where they
+	are aged up a class after rolling over enough times so they can't starve.
+=============================================================================*/
+enum EventPriority : uint8_t {
+	EventPriority_High = 0,		// handled every frame regardless of the time budget
+	EventPriority_Normal,		// default
+	EventPriority_Low,			// first to roll over when the budget runs out
+	EventPriority_MAX			// not a priority, reference for array size
+};
+
+/*=============================================================================
+	Coalescing policy of an event type, set with
+	EventManager::setEventCoalescing. A coalescing type keeps at most one
+	queued event per subject (see Event::subject) in the active queue. When an
+	event of the same type and subject is raised again before notifyQueued,
+	Latest replaces the queued event with the new one, and Accumulate merges
+	the new event into the queued one with the type's EventMergeFunc. Either
+	way the queued event keeps its place in the queue. Triggered events are
+	never coalesced.
+=============================================================================*/
+enum EventCoalescing : uint8_t {
+	EventCoalescing_None = 0,	// every raised event is queued, default
+	EventCoalescing_Latest,		// latest raised event per subject wins
+	EventCoalescing_Accumulate	// raised events per subject are merged into the first
+};
+
 /*=============================================================================
 	Empty events can be triggered by string shortcut (instead of defining an
 	explicit class for each type. Also is treated as a special case in the
@@ -49,20 +80,60 @@ enum EventDataType : uint8_t {
 
 class Event;
 class RegisteredEvent;
+class BinaryWriter;
+class BinaryReader;
+class BitReader;
+typedef uint32_t			EventTypeId;	// interned event type, a 32-bit hash of the event type name
 typedef shared_ptr<Event>	EventPtr;
 typedef shared_ptr<RegisteredEvent>	RegEventPtr;
-typedef pair<string, any>	AnyVarsValue;	// key/value pair where string is key and value utilizes boost::any
-typedef list<AnyVarsValue>	AnyVars;		// list of key/value pairs. This does not provide constant time
-											// random access to elements, so lists should generally be short
+typedef void (*EventMergeFunc)(Event &queued, const Event &raised);	// folds raised into queued, for EventCoalescing_Accumulate
+
+///// FUNCTIONS /////
+
+/*=============================================================================
+	Interns an event type name into its EventTypeId using 32-bit FNV-1a. Ids
+	are computed once, when the event type is registered or when a class
+	initializes its static sEventTypeId, so dispatch never hashes strings. The
+	EventManager detects collisions between different names at registration.
+=============================================================================*/
+inline EventTypeId eventTypeIdOf(const char *eventType)
+{
+	uint32_t hash = 2166136261U;
+	for (const char *c = eventType; *c != '\0'; ++c) {
+		hash ^= static_cast<uint8_t>(*c);
+		hash *= 16777619U;
+	}
+	return hash;
+}
+
+inline EventTypeId eventTypeIdOf(const string &eventType) { return eventTypeIdOf(eventType.c_str()); }
+
+/*=============================================================================
+	Packs an event type id and a subject (see Event::subject) into one key,
+	for coalescing queued events and routing events to subject listeners
+=============================================================================*/
+inline uint64_t eventSubjectKey(EventTypeId eventTypeId, uint32_t subject)
+{
+	return (static_cast<uint64_t>(eventTypeId) << 32) | subject;
+}
+
 ///// STRUCTURES /////
 
 /*=============================================================================
 class Event
 	An abstract base class for all Event types to inherit from. There are pure
 	virtual methods to be overloaded. type() should usually return a const
-	reference to a static string variable with the event type name. mTime and
-	mState are private because derived classes should not try to manage those
-	attributes since EventManager does that job.
+	reference to a static string variable with the event type name, and
+	typeId() should return a static EventTypeId initialized from that name with
+	eventTypeIdOf. The string is only used for debugging and script lookup, all
+	dispatch is done on the id. mTime and mState are private because derived
+	classes should not try to manage those attributes since EventManager does
+	that job.
+	Create events with EventManager::make<T> rather than new, so the event and
+	its shared_ptr control block come from the pooled event allocator.
+	Events with data should override serialize() to write their payload for
+	the EventRecorder, and provide a static deserialize(BinaryReader &) to be
+	replayed, see ReplayableCodeOnlyEvent.
 =============================================================================*/
 class Event : private boost::noncopyable {
 	friend class EventManager;	// allow EventManager to reach private and protected members
@@ -71,34 +142,37 @@ class Event : private boost::noncopyable {
 		// Don't allow derived classes to modify time and state, we want the EventManager to have control
 		__int64		mTime;		// time (in counts) that the event was created
 		EventState	mState;		// stores new, triggered, raised, and handled - use to query invokation method
-
-	protected:
-		#if defined(_DEBUG) || defined(DEBUG_CONSOLE) // track event instantiations to ensure no memory leaks
-		static int	sNumEventsCreated;
-		static int	sNumEventsDestroyed;
-		#endif
+		uint8_t		mRollovers;	// number of frames the event was left in the queue when the budget ran out
 
 	public:
 		virtual const string &	type() const = 0;
+		virtual EventTypeId		typeId() const = 0;
 		__int64					time() const	{ return mTime; }
 		EventState				state() const	{ return mState; }
 
+		/*---------------------------------------------------------------------
+			Identifies the object the event is about, such as an actor id,
+			so coalescing event types keep one queued event per subject, and
+			listeners subscribed to a subject only see its events. Events
+			without a subject return 0 and coalesce per type.
+		---------------------------------------------------------------------*/
+		virtual uint32_t		subject() const	{ return 0; }
+
+		/*---------------------------------------------------------------------
+			Writes the event's data for the EventRecorder. Empty events have
+			no payload and don't need to override this.
+		---------------------------------------------------------------------*/
+		virtual void			serialize(BinaryWriter &out) const {}
+
 		// Constructor
 		explicit Event() :
 			mTime(0),				// Don't record at instantiation, EventManager records when queued or triggered.
-			mState(EventState_New)	// EventManager records when queued or triggered.
-		{
-			#if defined(_DEBUG) || defined(DEBUG_CONSOLE)
-			++sNumEventsCreated;
-			#endif
-		}
+			mState(EventState_New),	// EventManager records when queued or triggered.
+			mRollovers(0)
+		{}
 
 		// Destructor
-		virtual ~Event() {
-			#if defined(_DEBUG) || defined(DEBUG_CONSOLE)
-			++sNumEventsDestroyed;
-			#endif
-		}
+		virtual ~Event() {}
 };
 
 /*=============================================================================
@@ -108,7 +182,12 @@ class ScriptableEvent
 	from script, just inherit from Event instead. This adds two new attributes,
 	some public interfaces to deal with the new attributes, a new virtual
 	function to be overloaded, and requires a new constructor signature to be
-	implemented in the derived class (const AnyVars &).
+	implemented in the derived class (const ScriptData &).
+	The script data is a flat ScriptData blob laid out by the event type's
+	ScriptDataSchema. The derived class keeps the schema in a static
+	sScriptSchema member, and an enum of its field indices in the order they
+	were added, so building and reading the data never looks fields up by
+	name. See ScriptData.h.
 	**NOTE**
 	Event handlers for ScriptableEvents should treat any custom event data as
 	immutable, since serialization to/from script data only occurs once in an
@@ -120,30 +199,31 @@ class ScriptableEvent
 =============================================================================*/
 class ScriptableEvent : public Event {
 	protected:
-		AnyVars	mScriptData;		// adds a private var to store event data for script handlers
-		bool	mScriptDataBuilt;	// tracks whether the event data has been built (only built when
-									// fired from script, or if it actually has a script handler)
+		ScriptData	mScriptData;		// adds a private var to store event data for script handlers
+		bool		mScriptDataBuilt;	// tracks whether the event data has been built (only built when
+										// fired from script, or if it actually has a script handler)
 	public:
 		/*---------------------------------------------------------------------
 			Check this prior to calling buildScriptData when handling a script
 			event so you only incur the overhead of building once for any event
 		---------------------------------------------------------------------*/
-		bool			isScriptDataBuilt() const { return mScriptDataBuilt; }
+		bool				isScriptDataBuilt() const { return mScriptDataBuilt; }
 		/*---------------------------------------------------------------------
 			Get access to the script data
 		---------------------------------------------------------------------*/
-		const AnyVars &	getScriptData() const { return mScriptData; }
+		const ScriptData &	getScriptData() const { return mScriptData; }
 
 		/*---------------------------------------------------------------------
-			Scriptable events should overload this to build the mEventData list
-			from its native property values. It should also set mEventDataBuilt
-			to true before returning.
+			Scriptable events should overload this to reset mScriptData with
+			the type's schema and set each field from its native property
+			values by index. It should also set mScriptDataBuilt to true
+			before returning.
 		---------------------------------------------------------------------*/
 		virtual void	buildScriptData() = 0;
 
 		/*---------------------------------------------------------------------
 			This constructor would be called on the code side, does not set
-			event data (initializes empty list).
+			event data (initializes an empty blob).
 		---------------------------------------------------------------------*/
 		explicit ScriptableEvent() :
 			Event(),
@@ -153,13 +233,13 @@ class ScriptableEvent : public Event {
 		/*---------------------------------------------------------------------
 			This constructor would be called by the script manager for an event
 			fired from script. Derived classes should implement a constructor
-			with the same signature and convert AnyVar values to native object
+			with the same signature and read the fields into native object
 			properties. The constructor would call this to init the the base
-			class.
+			class. Copying the blob is a single allocation.
 		---------------------------------------------------------------------*/
-		explicit ScriptableEvent(const AnyVars &eventData) :
+		explicit ScriptableEvent(const ScriptData &eventData) :
 			Event(),
-			mScriptData(eventData),	// nice, the std::list, std::pair and boost::any are all copy constructible
+			mScriptData(eventData),
 			mScriptDataBuilt(true)
 		{}
 		virtual ~ScriptableEvent() {}
@@ -169,26 +249,41 @@ class ScriptableEvent : public Event {
 class ScriptEvent
 	ScriptEvent is registered in script, so we know it will only have script
 	handlers. For that reason, any data passed in the event doesn't need to be
-	translated to and from native C++ types, basically pass whatever data
-	object as the only occupant of the AnyVars list, and it will just be passed
-	right back untouched. This acts as a simple pass-through class.
+	translated to and from native C++ types, the ScriptData laid out by the
+	schema the type was registered with is passed right back untouched. This
+	acts as a simple pass-through class.
 =============================================================================*/
 class ScriptEvent : public ScriptableEvent {
-	friend class ScriptDefinedEvent;
+	public:
+		/*---------------------------------------------------------------------
+			Only ScriptDefinedEvent can create a Key, so only it can construct
+			ScriptEvents, while still letting EventManager::make reach the
+			public constructor
+		---------------------------------------------------------------------*/
+		class Key {
+			friend class ScriptDefinedEvent;
+			Key() {}
+		};
+
 	private:
-		string	mEventType;
+		string		mEventType;
+		EventTypeId	mEventTypeId;
 
+	public:
 		/*---------------------------------------------------------------------
 			To prevent programmers from inheriting this by mistake (instead of
-			ScriptableEvent) made constructor private and friended
-			class ScriptDefinedEvent where this is called.
+			ScriptableEvent) the constructor requires a Key, which only
+			class ScriptDefinedEvent can create.
 		---------------------------------------------------------------------*/
-		explicit ScriptEvent(const string &eventType, const AnyVars &eventData) :
+		explicit ScriptEvent(Key, const string &eventType, const ScriptData &eventData) :
 			ScriptableEvent(eventData),
-			mEventType(eventType)
+			mEventType(eventType),
+			mEventTypeId(eventTypeIdOf(eventType))
 		{}
-	public:
-		virtual const string & type() const { return mEventType; }
+
+
+		virtual const string &	type() const	{ return mEventType; }
+		virtual EventTypeId		typeId() const	{ return mEventTypeId; }
 
 		/*---------------------------------------------------------------------
 			Since this is a pass-through object, the event data will always be
@@ -217,17 +312,39 @@ class EmptyEvent
 	programmer remembers to always register new event types.
 =============================================================================*/
 class EmptyEvent : public Event {
-	friend class EventManager;
+	public:
+		/*---------------------------------------------------------------------
+			Only EventManager can create a Key, see the constructor below
+		---------------------------------------------------------------------*/
+		class Key {
+			friend class EventManager;
+			Key() {}
+		};
+
 	private:
-		string	mEventType;
+		string		mEventType;
+		EventTypeId	mEventTypeId;
 
-		// Constructors
-		explicit EmptyEvent(const string &eventType) :	// We don't want empty events being created anywhere, so to avoid the
-			Event(),									// unsafe practice of constructing these manually, it is made private.
-			mEventType(eventType)						// Friending EventManager lets it create these from raise and trigger
-		{}												// by string methods.
 	public:
-		virtual const string & type() const { return mEventType; }
+		/*---------------------------------------------------------------------
+			Always null, empty events carry no script data. This lets
+			ScriptCallableCodeEvent<EmptyEvent> compile, it only reads the
+			schema for EventDataType_NotEmpty types.
+		---------------------------------------------------------------------*/
+		static const ScriptDataSchemaPtr sScriptSchema;
+
+		// Constructors
+		// We don't want empty events being created anywhere, so to avoid the unsafe practice of
+		// constructing these manually, it requires a Key that only EventManager can create. This
+		// lets EventManager create these from raise and trigger by string methods through make.
+		explicit EmptyEvent(Key, const string &eventType, EventTypeId eventTypeId) :
+			Event(),
+			mEventType(eventType),
+			mEventTypeId(eventTypeId)
+		{}
+
+		virtual const string &	type() const	{ return mEventType; }
+		virtual EventTypeId		typeId() const	{ return mEventTypeId; }
 		
 		/*---------------------------------------------------------------------
 			This contructor is only made public so the program will compile
@@ -238,10 +355,10 @@ class EmptyEvent : public Event {
 			Empty events can be created from script, but are handled as a
 			special case to avoid overhead, so no need for this constructor to
 			ever be called (just needs to be here to compile). If I had derived
-			from ScriptableEvent, it would carry an unneeded AnyVars attribute.
+			from ScriptableEvent, it would carry an unneeded ScriptData attribute.
 		---------------------------------------------------------------------*/
-		explicit EmptyEvent(const AnyVars &) {
-			_ASSERTE(false && "Shouldn't be calling EmptyEvent(const AnyVars &) constructor!");
+		explicit EmptyEvent(const ScriptData &) {
+			_ASSERTE(false && "Shouldn't be calling EmptyEvent(const ScriptData &) constructor!");
 		}
 		// Destructor
 		virtual ~EmptyEvent() {}
@@ -0,0 +1,290 @@
+/* EventChannel.h
+Author: Jeff Kiah
+Orig.Date: 10/17/2026
+*/
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include "Event.h"
+#include "Utility/Debug.h"
+
+using std::vector;
+using std::shared_ptr;
+
+///// DEFINITIONS /////
+
+typedef uint32_t	SubscriptionId;	// returned by EventChannel::subscribe, pass to unsubscribe
+
+///// STRUCTURES /////
+
+/*=============================================================================
+class IEventChannel
+	Type-erased base of EventChannel so the EventManager can own channels of
+	every event type and flush their queues from notifyQueued. Virtual calls
+	only happen once per channel per frame, never per event or per delegate.
+=============================================================================*/
+class IEventChannel {
+	public:
+		/*---------------------------------------------------------------------
+			Delivers every event raised on the channel since the last flush.
+			Events raised while flushing are held until the next flush.
+		---------------------------------------------------------------------*/
+		virtual void	flush() = 0;
+
+		/*---------------------------------------------------------------------
+			Drops queued events without delivering them
+		---------------------------------------------------------------------*/
+		virtual void	clear() = 0;
+
+		virtual const string &	type() const = 0;
+		virtual EventTypeId		typeId() const = 0;
+
+		virtual ~IEventChannel() {}
+};
+
+typedef shared_ptr<IEventChannel>	EventChannelPtr;
+
+/*=============================================================================
+class EventChannel
+	A statically typed event path that runs alongside the EventPtr system.
+	Listeners subscribe a typed handler, bool (const TEvent &), and events are
+	delivered by const reference straight from the channel's queue, so there
+	is no shared_ptr per event, no virtual call per handler and no downcast in
+	the handler. Subscribers are kept in a contiguous array sorted by priority
+	(1 is highest, 0 is FIFO after all prioritized), and dispatch is a single
+	loop calling each delegate's stub through a plain function pointer. As
+	with listeners, a handler returning true consumes the event.
+	TEvent does not need to derive from Event, it only needs a static
+	sEventType string and a static sEventTypeId. A channel is opted into by
+	registering the event type with TypedCodeOnlyEvent<TEvent>, and fetched
+	with EventManager::channel<TEvent>(). Channel events are code-only, they
+	are not seen by wildcard listeners, script or the EventPtr queue.
+	Not thread safe, subscribe, raise and trigger from the main thread only.
+	Subscribing or unsubscribing from inside a handler is allowed, removed
+	delegates are compacted after dispatch and added delegates are first
+	called on the next event.
+=============================================================================*/
+template <typename TEvent>
+class EventChannel : public IEventChannel {
+	private:
+		///// DEFINITIONS /////
+		typedef bool (*StubProc)(void *, const TEvent &);
+
+		/*---------------------------------------------------------------------
+			Holds an owned functor for subscribeCallable, deleted by the
+			channel when unsubscribed
+		---------------------------------------------------------------------*/
+		struct ICallableHolder {
+			virtual ~ICallableHolder() {}
+		};
+		template <typename TCallable>
+		struct CallableHolder : public ICallableHolder {
+			TCallable	mCallable;
+			static bool stub(void *obj, const TEvent &e) { return static_cast<CallableHolder *>(obj)->mCallable(e); }
+			explicit CallableHolder(TCallable &&callable) : mCallable(std::move(callable)) {}
+		};
+
+		struct Delegate {
+			void *				mObject;	// listener, holder, or null for free functions
+			StubProc			mStub;		// null once unsubscribed during dispatch
+			uint32_t			mPriority;
+			SubscriptionId		mId;
+			ICallableHolder *	mHolder;	// owned functor, if any
+		};
+
+		///// VARIABLES /////
+		vector<Delegate>	mDelegates;
+		vector<TEvent>		mQueue[2];		// double-buffered, raised events go to mQueue[mActiveQueue]
+		uint32_t			mActiveQueue;
+		SubscriptionId		mNextId;
+		uint32_t			mDispatchDepth;	// > 0 while handlers are running, triggers can nest
+		bool				mNeedsCompact;
+
+		///// FUNCTIONS /////
+		template <typename TListener, bool (TListener::*Proc)(const TEvent &)>
+		static bool memberStub(void *obj, const TEvent &e) { return (static_cast<TListener *>(obj)->*Proc)(e); }
+
+		template <bool (*Proc)(const TEvent &)>
+		static bool freeStub(void *, const TEvent &e) { return (*Proc)(e); }
+
+		SubscriptionId	insertDelegate(void *obj, StubProc stub, uint32_t priority, ICallableHolder *holder);
+		void			compact();
+
+	public:
+		/*---------------------------------------------------------------------
+			Subscribes a listener's member function, called as
+			channel.subscribe<Listener, &Listener::onEvent>(this). The member
+			pointer is a template argument so the call inlines into the stub.
+		---------------------------------------------------------------------*/
+		template <typename TListener, bool (TListener::*Proc)(const TEvent &)>
+		SubscriptionId	subscribe(TListener *listener, uint32_t priority = 0)
+		{
+			return insertDelegate(listener, &memberStub<TListener, Proc>, priority, 0);
+		}
+
+		/*---------------------------------------------------------------------
+			Subscribes a free or static function, channel.subscribe<&onEvent>()
+		---------------------------------------------------------------------*/
+		template <bool (*Proc)(const TEvent &)>
+		SubscriptionId	subscribe(uint32_t priority = 0)
+		{
+			return insertDelegate(0, &freeStub<Proc>, priority, 0);
+		}
+
+		/*---------------------------------------------------------------------
+			Subscribes any callable taking const TEvent & and returning bool,
+			such as a lambda. The channel takes ownership of a copy.
+		---------------------------------------------------------------------*/
+		template <typename TCallable>
+		SubscriptionId	subscribeCallable(TCallable callable, uint32_t priority = 0)
+		{
+			CallableHolder<TCallable> *holder = new CallableHolder<TCallable>(std::move(callable));
+			return insertDelegate(holder, &CallableHolder<TCallable>::stub, priority, holder);
+		}
+
+		/*---------------------------------------------------------------------
+			Removes a subscription, returns false if the id was not found
+		---------------------------------------------------------------------*/
+		bool	unsubscribe(SubscriptionId id);
+
+		/*---------------------------------------------------------------------
+			Delivers the event to subscribers immediately, in priority order,
+			until one consumes it. Returns true if consumed.
+		---------------------------------------------------------------------*/
+		bool	trigger(const TEvent &e);
+
+		/*---------------------------------------------------------------------
+			Queues the event by value for delivery in the next
+			EventManager::notifyQueued
+		---------------------------------------------------------------------*/
+		void	raise(const TEvent &e)	{ mQueue[mActiveQueue].push_back(e); }
+		void	raise(TEvent &&e)		{ mQueue[mActiveQueue].push_back(std::move(e)); }
+
+		size_t	numSubscribers() const	{ return mDelegates.size(); }
+		size_t	numQueued() const		{ return mQueue[mActiveQueue].size(); }
+
+		///// IEventChannel /////
+		virtual void	flush();
+		virtual void	clear()			{ mQueue[0].clear(); mQueue[1].clear(); }
+		virtual const string &	type() const	{ return TEvent::sEventType; }
+		virtual EventTypeId		typeId() const	{ return TEvent::sEventTypeId; }
+
+		// Constructor / destructor
+		explicit EventChannel() :
+			mActiveQueue(0), mNextId(1), mDispatchDepth(0), mNeedsCompact(false)
+		{}
+		virtual ~EventChannel();
+};
+
+///// FUNCTIONS /////
+
+template <typename TEvent>
+SubscriptionId EventChannel<TEvent>::insertDelegate(void *obj, StubProc stub, uint32_t priority, ICallableHolder *holder)
+{
+	Delegate d = { obj, stub, priority, mNextId++, holder };
+
+	// same ordering rule as listener registration, prioritized first (1 highest), then FIFO
+	typename vector<Delegate>::iterator di = mDelegates.begin(), end = mDelegates.end();
+	if (priority != 0) {
+		while (di != end && di->mPriority != 0 && di->mPriority <= priority) { ++di; }
+	} else {
+		di = end;
+	}
+	if (mDispatchDepth > 0) {
+		// keep indices of the running dispatch loop stable, sorted in by compact() afterwards
+		mDelegates.push_back(d);
+		mNeedsCompact = true;
+	} else {
+		mDelegates.insert(di, d);
+	}
+	return d.mId;
+}
+
+template <typename TEvent>
+bool EventChannel<TEvent>::unsubscribe(SubscriptionId id)
+{
+	for (size_t i = 0; i < mDelegates.size(); ++i) {
+		Delegate &d = mDelegates[i];
+		if (d.mId == id && d.mStub != 0) {
+			if (mDispatchDepth > 0) {
+				// tombstone, removed after dispatch since the handler may be unsubscribing itself
+				d.mStub = 0;
+				mNeedsCompact = true;
+			} else {
+				delete d.mHolder;
+				mDelegates.erase(mDelegates.begin() + i);
+			}
+			return true;
+		}
+	}
+	return false;
+}
+
+/*---------------------------------------------------------------------
+	Removes tombstones and sorts delegates added during dispatch into
+	priority order. A stable sort keeps FIFO order within a priority.
+---------------------------------------------------------------------*/
+template <typename TEvent>
+void EventChannel<TEvent>::compact()
+{
+	vector<Delegate> sorted;
+	sorted.reserve(mDelegates.size());
+	for (size_t i = 0; i < mDelegates.size(); ++i) {
+		if (mDelegates[i].mStub != 0) {
+			sorted.push_back(mDelegates[i]);
+		} else {
+			delete mDelegates[i].mHolder;
+		}
+	}
+	std::stable_sort(sorted.begin(), sorted.end(), [](const Delegate &a, const Delegate &b) {
+		// priority 0 sorts last
+		return (a.mPriority - 1) < (b.mPriority - 1);
+	});
+	mDelegates.swap(sorted);
+	mNeedsCompact = false;
+}
+
+template <typename TEvent>
+bool EventChannel<TEvent>::trigger(const TEvent &e)
+{
+	bool consumed = false;
+	++mDispatchDepth;
+	// indexed loop, delegates added by a handler may reallocate the array
+	const size_t numDelegates = mDelegates.size();
+	for (size_t i = 0; i < numDelegates; ++i) {
+		const Delegate &d = mDelegates[i];
+		if (d.mStub != 0 && d.mStub(d.mObject, e)) {
+			consumed = true;
+			break;
+		}
+	}
+	--mDispatchDepth;
+	if (mDispatchDepth == 0 && mNeedsCompact) { compact(); }
+	return consumed;
+}
+
+template <typename TEvent>
+void EventChannel<TEvent>::flush()
+{
+	// flip queues so events raised by handlers wait for the next flush
+	uint32_t processQueue = mActiveQueue;
+	mActiveQueue = (mActiveQueue == 0) ? 1 : 0;
+
+	vector<TEvent> &queue = mQueue[processQueue];
+	for (size_t e = 0; e < queue.size(); ++e) {
+		trigger(queue[e]);
+	}
+	queue.clear(); // keeps capacity, so a steady stream of events stops allocating
+}
+
+template <typename TEvent>
+EventChannel<TEvent>::~EventChannel()
+{
+	for (size_t i = 0; i < mDelegates.size(); ++i) {
+		delete mDelegates[i].mHolder;
+	}
+}
@@ -7,9 +7,9 @@
 #pragma once
 
 #include "Event.h"
-#include "../Utility/ConcurrentQueue.h"
+#include "../Utility/LockFreeQueue.h"
 
-typedef ConcurrentQueue<EventPtr>	ThreadSafeEventQueue;
+typedef MPSCQueue<EventPtr>	ThreadSafeEventQueue;
 
 /*=============================================================================
 class IEventHandler
@@ -75,7 +75,8 @@ class ThreadEventHandler
 	the handler, instead of calling a functor to handle them. The handler
 	should be created in the main thread, because registration with the manager
 	is not thread safe. The thread process can waitPop() items from the queue
-	to handle them.
+	to handle them. The queue is a bounded lock-free MPSC queue, so the worker
+	thread must be the only one popping from it.
 =============================================================================*/
 class ThreadEventHandler : public IEventHandler {
 	public:
@@ -11,6 +11,7 @@
 
 EventManagerWeakPtr	EventListener::s_eventMgr;
 const string EventListener::sWildcardType("*"); // defines the wildcard event type string for listeners
+const EventTypeId EventListener::sWildcardTypeId(eventTypeIdOf(EventListener::sWildcardType));
 
 /*-----------------------------------------------------------------------------
 	Inserts a handler functor for an event type, adding it to the
@@ -18,9 +19,10 @@ const string EventListener::sWildcardType("*"); // defines the wildcard event ty
 -----------------------------------------------------------------------------*/
 bool EventListener::insertEventHandler(const string &eventType, const IEventHandlerPtr &handler)
 {
-	EventHandlerMap::const_iterator ei = mHandlerMap.find(eventType);
+	EventTypeId eventTypeId = eventTypeIdOf(eventType);
+	EventHandlerMap::const_iterator ei = mHandlerMap.find(eventTypeId);
 	if (ei == mHandlerMap.end()) { // event type handler does not exist yet
-		EventHandlerMapResult r = mHandlerMap.insert(EventHandlerMapValue(eventType, handler));
+		EventHandlerMapResult r = mHandlerMap.insert(EventHandlerMapValue(eventTypeId, handler));
 		debugPrintf("%s: handler created for event type \"%s\"\n", mName.c_str(), eventType.c_str());
 		_ASSERTE(r.second == true);
 	} else { // event type handler already exists
@@ -37,7 +39,7 @@ bool EventListener::insertEventHandler(const string &eventType, const IEventHand
 bool EventListener::removeEventHandler(const string &eventType)
 {
 	// check for event type in the map
-	EventHandlerMap::iterator ei = mHandlerMap.find(eventType);
+	EventHandlerMap::iterator ei = mHandlerMap.find(eventTypeIdOf(eventType));
 	if (ei == mHandlerMap.end()) {
 		debugPrintf("%s: handler not found for event type \"%s\", not removed\n", mName.c_str(), eventType.c_str());
 		return false;
@@ -49,9 +51,11 @@ bool EventListener::removeEventHandler(const string &eventType)
 
 /*-----------------------------------------------------------------------------
 	Calls insertEventHandler, and registers the listener with EventManager for
-	the event type. Passes priority along to listener registration function
+	the event type. Passes priority and concurrency along to listener
+	registration function
 -----------------------------------------------------------------------------*/
-bool EventListener::registerEventHandler(const string &eventType, const IEventHandlerPtr &handler, uint32_t priority)
+bool EventListener::registerEventHandler(const string &eventType, const IEventHandlerPtr &handler, uint32_t priority,
+										 ListenerConcurrency concurrency)
 {
 	// perform the insert, and if it fails, exit early
 	if (!insertEventHandler(eventType, handler)) { return false; }
@@ -60,7 +64,7 @@ bool EventListener::registerEventHandler(const string &eventType, const IEventHa
 	EventManagerPtr eventMgr(s_eventMgr.lock());
 	if (!eventMgr) { return false; }
 
-	eventMgr->registerListener(eventType, this, priority); // register listener with manager
+	eventMgr->registerListener(eventType, this, priority, concurrency); // register listener with manager
 	return true;
 }
 
@@ -77,10 +81,66 @@ bool EventListener::unregisterEventHandler(const string &eventType)
 	EventManagerPtr eventMgr(s_eventMgr.lock());
 	if (!eventMgr) { return false; }
 
-	eventMgr->removeListener(eventType, this); // remove listener from manager
+	EventTypeId eventTypeId = eventTypeIdOf(eventType);
+	if (mSubjectTypes.erase(eventTypeId) > 0) {
+		unsubscribeSubjects(*eventMgr, eventTypeId);
+		eventMgr->retireListenerMetrics(eventTypeId, this);
+	} else {
+		eventMgr->removeListener(eventTypeId, this); // remove listener from manager
+	}
+	return true;
+}
+
+/*-----------------------------------------------------------------------------
+	Inserts the handler only, the listener is registered with the EventManager
+	per subject by subscribeSubject
+-----------------------------------------------------------------------------*/
+bool EventListener::registerSubjectHandler(const string &eventType, const IEventHandlerPtr &handler)
+{
+	if (!insertEventHandler(eventType, handler)) { return false; }
+	mSubjectTypes.insert(eventTypeIdOf(eventType));
+	return true;
+}
+
+bool EventListener::subscribeSubject(const string &eventType, uint32_t subject, uint32_t priority,
+									 ListenerConcurrency concurrency)
+{
+	EventTypeId eventTypeId = eventTypeIdOf(eventType);
+	if (mSubjectTypes.find(eventTypeId) == mSubjectTypes.end()) {
+		debugPrintf("%s: no subject handler for event type \"%s\", subject %u not subscribed\n", mName.c_str(), eventType.c_str(), subject);
+		return false;
+	}
+	EventManagerPtr eventMgr(s_eventMgr.lock());
+	if (!eventMgr || !eventMgr->registerListener(eventType, subject, this, priority, concurrency)) { return false; }
+
+	mSubjects.insert(eventSubjectKey(eventTypeId, subject));
 	return true;
 }
 
+bool EventListener::unsubscribeSubject(const string &eventType, uint32_t subject)
+{
+	EventTypeId eventTypeId = eventTypeIdOf(eventType);
+	if (mSubjects.erase(eventSubjectKey(eventTypeId, subject)) == 0) { return false; }
+
+	EventManagerPtr eventMgr(s_eventMgr.lock());
+	if (!eventMgr) { return false; }
+
+	return eventMgr->removeListener(eventTypeId, subject, this);
+}
+
+void EventListener::unsubscribeSubjects(EventManager &eventMgr, EventTypeId eventTypeId)
+{
+	SubjectSet::iterator si = mSubjects.begin();
+	while (si != mSubjects.end()) {
+		if (static_cast<EventTypeId>(*si >> 32) == eventTypeId) {
+			eventMgr.removeListener(eventTypeId, static_cast<uint32_t>(*si), this);
+			si = mSubjects.erase(si);
+		} else {
+			++si;
+		}
+	}
+}
+
 /*-----------------------------------------------------------------------------
 	Cleanup for when listener is destroyed or being reset. Unregisters all
 	remaining handlers in the map. If the derived listener hasn't explicitly
@@ -88,15 +148,23 @@ bool EventListener::unregisterEventHandler(const string &eventType)
 -----------------------------------------------------------------------------*/
 void EventListener::clearHandlers()
 {
-	// this loop unregisters all remaining handlers
-	EventHandlerMap::const_iterator ei = mHandlerMap.begin(),
-									end = mHandlerMap.end();
-	while (ei != end) {
-		const string key(ei->first);
-		++ei;
-		unregisterEventHandler(key);
+	// this loop unregisters all remaining handlers from the EventManager by id
+	EventManagerPtr eventMgr(s_eventMgr.lock());
+	if (eventMgr) {
+		EventHandlerMap::const_iterator ei = mHandlerMap.begin(),
+										end = mHandlerMap.end();
+		for (; ei != end; ++ei) {
+			if (mSubjectTypes.find(ei->first) != mSubjectTypes.end()) {
+				unsubscribeSubjects(*eventMgr, ei->first);
+				eventMgr->retireListenerMetrics(ei->first, this);
+			} else {
+				eventMgr->removeListener(ei->first, this);
+			}
+		}
 	}
 	mHandlerMap.clear();
+	mSubjectTypes.clear();
+	mSubjects.clear();
 }
 
 /*-----------------------------------------------------------------------------
@@ -108,11 +176,11 @@ void EventListener::clearHandlers()
 bool EventListener::handle(const EventPtr &ePtr)
 {
 	// handle specific event type registrations
-	EventHandlerMap::const_iterator ei = mHandlerMap.find((*ePtr).type());
+	EventHandlerMap::const_iterator ei = mHandlerMap.find((*ePtr).typeId());
 	if (ei == mHandlerMap.end()) {
 		// if a specific event handler is not found for this type, check for any wildcard handlers
 		// so in this case, specific handlers in a listener will override the wildcard for any event type
-		ei = mHandlerMap.find(EventListener::sWildcardType);
+		ei = mHandlerMap.find(EventListener::sWildcardTypeId);
 		if (ei != mHandlerMap.end()) {
 			(*ei->second)(ePtr); // ignore return value for wildcard event handlers
 			return false;
@@ -7,11 +7,13 @@
 #pragma once;
 
 #include <hash_map>
+#include <hash_set>
 #include <string>
 #include <memory>
 #include "EventHandler.h"
 
 using std::hash_map;
+using stdext::hash_set;
 using std::string;
 using std::pair;
 using std::shared_ptr;
@@ -20,6 +22,23 @@ using std::weak_ptr;
 class EventManager;
 typedef weak_ptr<EventManager> EventManagerWeakPtr;
 
+///// DEFINITIONS /////
+
+/*=============================================================================
+	Declared per event type when a listener registers. Exclusive handlers run
+	on the main thread in priority order and may consume the event. Concurrent
+	handlers are read-only observers, EventManager::notifyQueued batches the
+	events they receive and runs each concurrent listener's batch as one job
+	on the worker pool, in parallel with other concurrent listeners but never
+	with itself. Their return value is ignored, they can't consume, and they
+	must use raiseThreadSafe to raise events of their own. Triggered events
+	always run all handlers immediately on the calling thread.
+=============================================================================*/
+enum ListenerConcurrency : uint8_t {
+	ListenerConcurrency_Exclusive = 0,	// default, handler may mutate state and consume the event
+	ListenerConcurrency_Concurrent		// handler only observes, safe to run on a worker thread
+};
+
 /*=============================================================================
 class EventListener
 	EventListener is registered with EventManager to receive notifications of
@@ -34,26 +53,38 @@ class EventListener
 	picked up by the generic handler. To override, use the insertEventHandler
 	and removeEventHandler functions in the constructor/destructor instead of
 	registerEventHandler and unregisterEventHandler.
+	**Subject Handlers**
+	A listener that only cares about some objects, such as the actors it
+	tracks, registers its handler with registerSubjectHandler and then calls
+	subscribeSubject for each object. It is only notified of events whose
+	subject matches one of its subscriptions, see Event::subject.
 =============================================================================*/
 class EventListener {
 	friend class EventManager;
 	public:
 		///// DEFINITIONS /////
-		typedef shared_ptr<IEventHandler>				IEventHandlerPtr;
-		typedef pair<string, IEventHandlerPtr>			EventHandlerMapValue;
-		typedef hash_map<string, IEventHandlerPtr>		EventHandlerMap;
-		typedef pair<EventHandlerMap::iterator, bool>	EventHandlerMapResult;
+		typedef shared_ptr<IEventHandler>					IEventHandlerPtr;
+		typedef pair<EventTypeId, IEventHandlerPtr>			EventHandlerMapValue;
+		typedef hash_map<EventTypeId, IEventHandlerPtr>		EventHandlerMap;
+		typedef pair<EventHandlerMap::iterator, bool>		EventHandlerMapResult;
+		typedef hash_set<uint64_t>							SubjectSet;			// eventSubjectKey of each subscription
+		typedef hash_set<EventTypeId>						SubjectTypeSet;
 
-		static const string	sWildcardType;	// stores the wildcard event type string
+		static const string			sWildcardType;		// stores the wildcard event type string
+		static const EventTypeId	sWildcardTypeId;	// interned id of the wildcard event type
 		
 	protected:
 		///// VARIABLES /////
 		static EventManagerWeakPtr	s_eventMgr; // dependency is injected at startup when EventManager is created
 
 		string				mName;			// name of the listener, mostly for debugging
-		EventHandlerMap		mHandlerMap;	// map of functors, one for each event type that is listened for
+		EventHandlerMap		mHandlerMap;	// map of functors keyed by interned event type id, one for each type
 											// the listener registers event types and functors with itself which
-		///// FUNCTIONS /////				// also registers the listener with the event manager for that event type
+											// also registers the listener with the event manager for that event type
+		SubjectTypeSet		mSubjectTypes;	// types whose handler was registered per subject, not type-wide
+		SubjectSet			mSubjects;		// the subjects subscribed to, for each of those types
+
+		///// FUNCTIONS /////
 
 		/*---------------------------------------------------------------------
 			Inserts a handler functor for an event type, adding it to the
@@ -69,10 +100,11 @@ class EventListener {
 
 		/*---------------------------------------------------------------------
 			Calls insertEventHandler, and registers the listener with
-			EventManager for the event type. Passes priority along to listener
-			registration function
+			EventManager for the event type. Passes priority and concurrency
+			along to listener registration function
 		---------------------------------------------------------------------*/
-		bool registerEventHandler(const string &eventType, const IEventHandlerPtr &handler, uint32_t priority);
+		bool registerEventHandler(const string &eventType, const IEventHandlerPtr &handler, uint32_t priority,
+								  ListenerConcurrency concurrency = ListenerConcurrency_Exclusive);
 		
 		/*---------------------------------------------------------------------
 			Register a handler with listener priority 0 (FIFO)
@@ -87,6 +119,28 @@ class EventListener {
 		---------------------------------------------------------------------*/
 		bool unregisterEventHandler(const string &eventType);
 
+		/*---------------------------------------------------------------------
+			Inserts a handler for an event type without registering the
+			listener for the whole type, it receives the events of the
+			subjects it subscribes to. Undone by unregisterEventHandler,
+			which also drops the subscriptions.
+		---------------------------------------------------------------------*/
+		bool registerSubjectHandler(const string &eventType, const IEventHandlerPtr &handler);
+
+		/*---------------------------------------------------------------------
+			Subscribes to, or drops, the events of one subject of a type
+			registered with registerSubjectHandler. Priority and concurrency
+			are per subscription, as for type-wide registration.
+		---------------------------------------------------------------------*/
+		bool subscribeSubject(const string &eventType, uint32_t subject, uint32_t priority = 0,
+							  ListenerConcurrency concurrency = ListenerConcurrency_Exclusive);
+		bool unsubscribeSubject(const string &eventType, uint32_t subject);
+
+		/*---------------------------------------------------------------------
+			Drops every subject subscription of a type
+		---------------------------------------------------------------------*/
+		void unsubscribeSubjects(EventManager &eventMgr, EventTypeId eventTypeId);
+
 		/*---------------------------------------------------------------------
 			Cleanup for when listener is destroyed or being reset. Unregisters
 			all remaining handlers in the map. If the derived listener hasn't
@@ -7,47 +7,277 @@
 #include "EventManager.h"
 #include "RegisteredEvents.h"
 #include "Application/Timer.h"
-#include "Utility/ConcurrentQueue.h"
+#include "EventRecorder.h"
+#include "EventMetrics.h"
+#include "Utility/LockFreeQueue.h"
+#include "Utility/BinaryStream.h"
+#include "Utility/BitStream.h"
+#include "Utility/JobSystem.h"
+#include <algorithm>
+#include <cstring>
+
+///// VARIABLES /////
+
+EventManagerWeakPtr	RegisteredEvent::sEventMgr;
+const ScriptDataSchemaPtr EmptyEvent::sScriptSchema;
+
+///// FUNCTIONS /////
+
+/*-----------------------------------------------------------------------------
+	Listener tables are kept sorted by priority, 1 highest, with priority 0
+	(FIFO) entries last. Mapping 0 to the largest key lets upper_bound find
+	the insert position for both, after existing entries of equal priority.
+-----------------------------------------------------------------------------*/
+static inline uint32_t listenerSortKey(uint32_t priority)
+{
+	return priority - 1; // 0 wraps to UINT32_MAX
+}
 
 ////////// class EventManager //////////
 
+/*-----------------------------------------------------------------------------
+	Calls a listener's handler for the event, timing it when metrics are
+	enabled. Returns true if the handler consumed the event.
+-----------------------------------------------------------------------------*/
+bool EventManager::callHandler(EventListener &listener, const EventPtr &ePtr) const
+{
+	if (!m_metrics) {
+		return listener.handle(ePtr);
+	}
+	int64_t startCounts = Timer::queryCounts();
+	bool consumed = listener.handle(ePtr);
+	m_metrics->recordHandler(listener, (*ePtr).typeId(), Timer::queryCounts() - startCounts, consumed);
+	return consumed;
+}
+
 /*-----------------------------------------------------------------------------
 	Notifies listeners of a single event raised or triggered
 -----------------------------------------------------------------------------*/
-void EventManager::notifyListeners(const EventPtr &ePtr) const
+void EventManager::notifyListeners(const EventPtr &ePtr)
 {
+	const int64_t startCounts = (m_metrics ? Timer::queryCounts() : 0);
+	bool consumed = false;
+	++m_dispatchDepth;
+
 	// this section is for listeners of the wildcard type EventListener::sWildcardType
 	// if the handler returns true to consume, will not stop propagation here
-	EventTypeMap::const_iterator ei = m_eventTypeMap.find(EventListener::sWildcardType);
+	// tables are walked by index up to their size at the start, a handler registering a listener
+	// appends to the table and may reallocate it, see registerListener
+	EventTypeMap::iterator ei = m_eventTypeMap.find(EventListener::sWildcardTypeId);
 	if (ei != m_eventTypeMap.end()) {
-		ListenerList::const_iterator li, end = ei->second.end();
-		for (li = ei->second.begin(); li != end; ++li) {
-			(*li).first->handle(ePtr);
+		ListenerTable &table = ei->second;
+		const size_t numListeners = table.size();
+		for (size_t l = 0; l < numListeners; ++l) {
+			EventListener *lPtr = table[l].mListener;
+			if (lPtr) { callHandler(*lPtr, ePtr); }
+		}
+	}
+
+	// this section looks for listeners actually registered for the specific event, type-wide
+	// and for its subject, and will honor the return value of true for consumed events
+	ListenerTable *typeTable = 0, *subjectTable = 0;
+	findListenerTables(*ePtr, typeTable, subjectTable);
+	ListenerMergeWalk walk(typeTable, subjectTable);
+	ListenerTableValue entry;
+	while (walk.next(entry)) {
+		// if a handler returns true, it consumes the event and stops propagation
+		if (callHandler(*entry.mListener, ePtr)) {
+			consumed = true;
+			#ifdef _DEBUG
+			if (!walk.done()) {
+				debugPrintf("EventMgr: Listener \"%s\" consumed event of type \"%s\", listeners skipped\n",
+					entry.mListener->name().c_str(), (*ePtr).type().c_str());
+			}
+			#endif
+			break;
 		}
 	}
+	(*ePtr).mState = EventState_Handled;
 
-	// this section looks for listeners actually registered for the specific event
-	// and will honor the return value of true for consumed events
-	ei = m_eventTypeMap.find((*ePtr).type());
+	--m_dispatchDepth;
+	if (m_dispatchDepth == 0 && (!m_dirtyListenerTables.empty() || !m_dirtySubjectTables.empty())) { compactListenerTables(); }
+
+	if (m_metrics) {
+		m_metrics->countTriggered((*ePtr).typeId());
+		m_metrics->recordDispatch((*ePtr).typeId(), Timer::queryCounts() - startCounts, consumed);
+	}
+}
+
+/*-----------------------------------------------------------------------------
+	Notifies the exclusive listeners of a queued event in priority order, and
+	appends the event to the batch of each concurrent listener it reaches
+	before being consumed. Concurrent listeners ahead of a consuming listener
+	still see the event, the ones behind it don't, same as inline dispatch.
+-----------------------------------------------------------------------------*/
+void EventManager::notifyQueuedListeners(const EventPtr &ePtr)
+{
+	const int64_t startCounts = (m_metrics ? Timer::queryCounts() : 0);
+	bool consumed = false;
+	++m_dispatchDepth;
+
+	// wildcard listeners, consume is ignored
+	EventTypeMap::iterator ei = m_eventTypeMap.find(EventListener::sWildcardTypeId);
 	if (ei != m_eventTypeMap.end()) {
-		ListenerList::const_iterator li, end = ei->second.end();
-		for (li = ei->second.begin(); li != end; ++li) {
-			// if a handler returns true, it consumes the event and stops propagation
-			bool consumed = (*li).first->handle(ePtr);
-			if (consumed) {
-				#ifdef _DEBUG
-				ListenerList::const_iterator li_check = li;
-				++li_check;
-				if (li_check != end) {
-					debugPrintf("EventMgr: Listener \"%s\" consumed event of type \"%s\", listeners skipped\n",
-						(*li).first->name().c_str(), (*ePtr).type().c_str());
-				}
-				#endif
-				break;
+		ListenerTable &table = ei->second;
+		const size_t numListeners = table.size();
+		for (size_t l = 0; l < numListeners; ++l) {
+			const ListenerTableValue entry = table[l];
+			if (!entry.mListener) { continue; }
+			if (entry.mConcurrency == ListenerConcurrency_Concurrent) {
+				batchConcurrent(entry.mListener, ePtr);
+			} else {
+				callHandler(*entry.mListener, ePtr);
 			}
 		}
 	}
+
+	// listeners of the specific event type and its subject, exclusive listeners can consume
+	ListenerTable *typeTable = 0, *subjectTable = 0;
+	findListenerTables(*ePtr, typeTable, subjectTable);
+	ListenerMergeWalk walk(typeTable, subjectTable);
+	ListenerTableValue entry;
+	while (walk.next(entry)) {
+		if (entry.mConcurrency == ListenerConcurrency_Concurrent) {
+			batchConcurrent(entry.mListener, ePtr);
+		} else if (callHandler(*entry.mListener, ePtr)) {
+			consumed = true;
+			break;
+		}
+	}
 	(*ePtr).mState = EventState_Handled;
+
+	--m_dispatchDepth;
+	if (m_dispatchDepth == 0 && (!m_dirtyListenerTables.empty() || !m_dirtySubjectTables.empty())) { compactListenerTables(); }
+
+	// concurrent handlers run later and are not part of the dispatch time
+	if (m_metrics) {
+		m_metrics->recordDispatch((*ePtr).typeId(), Timer::queryCounts() - startCounts, consumed);
+	}
+}
+
+/*-----------------------------------------------------------------------------
+	Returns the next live entry of the two tables in priority order, skipping
+	tombstones, or false when both are done
+-----------------------------------------------------------------------------*/
+bool EventManager::ListenerMergeWalk::next(ListenerTableValue &entry)
+{
+	for (;;) {
+		if (mT < mTypeSize) {
+			if (mS < mSubjectSize &&
+				listenerSortKey((*mSubjectTable)[mS].mPriority) < listenerSortKey((*mTypeTable)[mT].mPriority))
+			{
+				entry = (*mSubjectTable)[mS++];
+			} else {
+				entry = (*mTypeTable)[mT++];
+			}
+		} else if (mS < mSubjectSize) {
+			entry = (*mSubjectTable)[mS++];
+		} else {
+			return false;
+		}
+		if (entry.mListener) { return true; }
+	}
+}
+
+/*-----------------------------------------------------------------------------
+	The subject lookup is skipped entirely while no listener has subscribed to
+	a subject, so types without subject listeners pay nothing for routing
+-----------------------------------------------------------------------------*/
+void EventManager::findListenerTables(const Event &e, ListenerTable *&typeTable, ListenerTable *&subjectTable)
+{
+	EventTypeMap::iterator ei = m_eventTypeMap.find(e.typeId());
+	typeTable = (ei != m_eventTypeMap.end() ? &ei->second : 0);
+	subjectTable = 0;
+	if (!m_subjectTableMap.empty()) {
+		SubjectTableMap::iterator si = m_subjectTableMap.find(eventSubjectKey(e.typeId(), e.subject()));
+		if (si != m_subjectTableMap.end()) { subjectTable = &si->second; }
+	}
+}
+
+void EventManager::batchConcurrent(EventListener *lPtr, const EventPtr &ePtr)
+{
+	ConcurrentBatchIndex::const_iterator bi = m_concurrentBatchIndex.find(lPtr);
+	if (bi != m_concurrentBatchIndex.end()) {
+		m_concurrentBatches[bi->second].mEvents.push_back(ePtr);
+	} else {
+		m_concurrentBatchIndex.insert(ConcurrentBatchIndex::value_type(lPtr, m_concurrentBatches.size()));
+		m_concurrentBatches.push_back(ConcurrentBatch());
+		m_concurrentBatches.back().mListener = lPtr;
+		m_concurrentBatches.back().mEvents.push_back(ePtr);
+	}
+}
+
+/*-----------------------------------------------------------------------------
+	Runs the concurrent listener batches on the job system, one job per
+	listener so each listener sees its events in queue order and is never run
+	in parallel with itself. The main thread helps run jobs while it waits.
+-----------------------------------------------------------------------------*/
+void EventManager::runConcurrentBatches()
+{
+	if (m_concurrentBatches.empty()) { return; }
+	_ASSERTE(m_jobSystem);
+
+	JobSystem::JobCounter counter;
+	const bool timed = (m_metrics != 0);
+	for (size_t b = 0; b < m_concurrentBatches.size(); ++b) {
+		ConcurrentBatch *batch = &m_concurrentBatches[b];
+		m_jobSystem->submit([batch, timed]() {
+			if (batch->mListener) {
+				// each job owns its batch, so handler times are kept there until the main thread records them
+				if (timed) { batch->mHandlerCounts.resize(batch->mEvents.size()); }
+				for (size_t e = 0; e < batch->mEvents.size(); ++e) {
+					int64_t startCounts = (timed ? Timer::queryCounts() : 0);
+					batch->mListener->handle(batch->mEvents[e]);
+					if (timed) { batch->mHandlerCounts[e] = Timer::queryCounts() - startCounts; }
+				}
+			}
+		}, &counter);
+	}
+	m_jobSystem->waitFor(counter);
+
+	if (timed) {
+		for (size_t b = 0; b < m_concurrentBatches.size(); ++b) {
+			const ConcurrentBatch &batch = m_concurrentBatches[b];
+			for (size_t e = 0; batch.mListener && e < batch.mHandlerCounts.size(); ++e) {
+				m_metrics->recordHandler(*batch.mListener, (*batch.mEvents[e]).typeId(), batch.mHandlerCounts[e], false);
+			}
+		}
+	}
+
+	m_concurrentBatches.clear();
+	m_concurrentBatchIndex.clear();
+}
+
+/*-----------------------------------------------------------------------------
+	Interns the event type name, storing it in the name map the first time it
+	is seen. Returns false if the name collides with another name already
+	interned to the same id.
+-----------------------------------------------------------------------------*/
+bool EventManager::internEventType(const string &eventType, EventTypeId &outEventTypeId)
+{
+	outEventTypeId = eventTypeIdOf(eventType);
+	EventNameMap::const_iterator ni = m_eventNameMap.find(outEventTypeId);
+	if (ni == m_eventNameMap.end()) {
+		m_eventNameMap.insert(EventNameMapValue(outEventTypeId, eventType));
+		return true;
+	}
+	if (ni->second != eventType) {
+		debugPrintf("EventMgr: event type \"%s\" collides with \"%s\" on id 0x%08x!\n", eventType.c_str(), ni->second.c_str(), outEventTypeId);
+		_ASSERTE(false && "Event type id collision, rename one of the event types");
+		return false;
+	}
+	return true;
+}
+
+/*-----------------------------------------------------------------------------
+	Returns the name an event type id was interned from, or an empty string if
+	the id has never been seen
+-----------------------------------------------------------------------------*/
+const string & EventManager::getEventTypeName(EventTypeId eventTypeId) const
+{
+	static const string sUnknownType;
+	EventNameMap::const_iterator ni = m_eventNameMap.find(eventTypeId);
+	return (ni != m_eventNameMap.end() ? ni->second : sUnknownType);
 }
 
 /*-----------------------------------------------------------------------------
@@ -55,13 +285,16 @@ void EventManager::notifyListeners(const EventPtr &ePtr) const
 -----------------------------------------------------------------------------*/
 void EventManager::raise(const EventPtr &ePtr)
 {	// Take the pointer passed in and fill with info like time, class that raised event, etc.
-	if (!isEventTypeRegistered((*ePtr).type())) {
+	RegEventMap::const_iterator ri = m_regEventMap.find((*ePtr).typeId());
+	if (ri == m_regEventMap.end()) {
 		debugPrintf("EventMgr: cannot raise \"%s\" event, not registered\n", (*ePtr).type().c_str());
 		return;
 	}
 	(*ePtr).mState = EventState_Raised;
 	(*ePtr).mTime = Timer::queryCounts();
-	m_eventQueue[m_activeQueue].push_back(ePtr);
+	// events fired from a listener are left out, replaying their cause fires them again
+	if (m_recorder && m_dispatchDepth == 0) { m_recorder->record(*ePtr, EventState_Raised); }
+	queueEvent(ePtr, *ri->second);
 	debugPrintf("EventMgr: \"%s\" event raised\n", (*ePtr).type().c_str());
 }
 /*-----------------------------------------------------------------------------
@@ -71,29 +304,163 @@ void EventManager::raise(const EventPtr &ePtr)
 -----------------------------------------------------------------------------*/
 void EventManager::raise(const string &eventType)
 {
-	RegEventMap::const_iterator ri = m_regEventMap.find(eventType);
+	EventTypeId eventTypeId = eventTypeIdOf(eventType);
+	if (!isEventTypeRegistered(eventTypeId)) {
+		debugPrintf("EventMgr: cannot raise \"%s\" event, not registered\n", eventType.c_str());
+		return;
+	}
+	raise(eventTypeId);
+}
+
+void EventManager::raise(EventTypeId eventTypeId)
+{
+	RegEventMap::const_iterator ri = m_regEventMap.find(eventTypeId);
 	if (ri != m_regEventMap.end()) {
 		_ASSERTE(ri->second->isEmpty() && "Cannot raise non-empty event with this interface, use EventPtr interface");
 		if (ri->second->isEmpty()) {
-			EventPtr ePtr(new EmptyEvent(eventType));
+			EventPtr ePtr(make<EmptyEvent>(EmptyEvent::Key(), getEventTypeName(eventTypeId), eventTypeId));
 			(*ePtr).mState = EventState_Raised;
 			(*ePtr).mTime = Timer::queryCounts();
-			m_eventQueue[m_activeQueue].push_back(ePtr);
+			if (m_recorder && m_dispatchDepth == 0) { m_recorder->record(*ePtr, EventState_Raised); }
+			queueEvent(ePtr, *ri->second);
 			debugPrintf("EventMgr: \"%s\" event raised\n", (*ePtr).type().c_str());
 		} else {
 			// add message to release logging
 		}
 	} else {
-		debugPrintf("EventMgr: cannot raise \"%s\" event, not registered\n", eventType.c_str());
+		debugPrintf("EventMgr: cannot raise event id 0x%08x, not registered\n", eventTypeId);
 	}
 }
 
+/*-----------------------------------------------------------------------------
+	Adds a raised event to the active queue of its priority class. For types
+	with a coalescing policy, an event already queued this frame for the same
+	subject is replaced by or merges in the new event instead, keeping its
+	place in the queue. Events rolled over from an earlier frame aren't in the
+	index, so a new event for their subject is queued behind them.
+-----------------------------------------------------------------------------*/
+void EventManager::queueEvent(const EventPtr &ePtr, const RegisteredEvent &reg)
+{
+	EventQueue &queue = m_eventQueue[m_activeQueue][reg.getEventPriority()];
+	EventCoalescing coalescing = reg.getEventCoalescing();
+	if (m_metrics) { m_metrics->countRaised((*ePtr).typeId()); }
+	if (coalescing == EventCoalescing_None) {
+		queue.push_back(ePtr);
+		return;
+	}
+
+	uint64_t key = eventSubjectKey((*ePtr).typeId(), (*ePtr).subject());
+	CoalesceIndex::iterator ci = m_coalesceIndex.find(key);
+	if (ci == m_coalesceIndex.end()) {
+		queue.push_back(ePtr);
+		m_coalesceIndex.insert(CoalesceIndexValue(key, --queue.end()));
+		return;
+	}
+
+	EventPtr &queuedPtr = *(ci->second);
+	if (coalescing == EventCoalescing_Latest) {
+		queuedPtr = ePtr;
+	} else {
+		reg.getMergeFunc()(*queuedPtr, *ePtr);
+	}
+	++m_pumpStats.coalesced[reg.getEventPriority()];
+}
+
+/*-----------------------------------------------------------------------------
+	Schedules an event to be raised once Timer::queryCounts() reaches counts.
+	The due tick rounds up, so the event is never raised early.
+-----------------------------------------------------------------------------*/
+ScheduledEventId EventManager::raiseAt(int64_t counts, const EventPtr &ePtr)
+{
+	if (!isEventTypeRegistered((*ePtr).typeId())) {
+		debugPrintf("EventMgr: cannot schedule \"%s\" event, not registered\n", (*ePtr).type().c_str());
+		return 0;
+	}
+	ScheduledEventId id = m_nextScheduledId++;
+	ScheduledEvent scheduled = { id, ePtr };
+	uint64_t dueTick = (counts > 0 ? static_cast<uint64_t>((counts + m_countsPerTick - 1) / m_countsPerTick) : 0);
+	m_timerWheel.schedule(dueTick, std::move(scheduled));
+	m_pendingScheduled.insert(id);
+	return id;
+}
+
+ScheduledEventId EventManager::raiseAfter(double delayMillis, const EventPtr &ePtr)
+{
+	int64_t delayCounts = static_cast<int64_t>(delayMillis * 0.001 * static_cast<double>(Timer::timerFreq()));
+	return raiseAt(Timer::queryCounts() + (delayCounts > 0 ? delayCounts : 0), ePtr);
+}
+
+/*-----------------------------------------------------------------------------
+	Cancelled events stay in the wheel until their tick comes up and are
+	dropped then, since the wheel has no cheap removal
+-----------------------------------------------------------------------------*/
+bool EventManager::cancelScheduled(ScheduledEventId id)
+{
+	return (m_pendingScheduled.erase(id) > 0);
+}
+
+void EventManager::raiseScheduled()
+{
+	uint64_t nowTick = static_cast<uint64_t>(Timer::queryCounts() / m_countsPerTick);
+	m_timerWheel.advance(nowTick, [this](ScheduledEvent &scheduled) {
+		if (m_pendingScheduled.erase(scheduled.mId) > 0) {
+			raise(scheduled.mEvent);
+		}
+	});
+}
+
+/*-----------------------------------------------------------------------------
+	Recreates an event of a registered type from a recorded payload, for
+	replay. Empty events are created directly, others through the
+	registration's deserialize.
+-----------------------------------------------------------------------------*/
+EventPtr EventManager::deserializeEvent(EventTypeId eventTypeId, BinaryReader &in) const
+{
+	RegEventMap::const_iterator ri = m_regEventMap.find(eventTypeId);
+	if (ri == m_regEventMap.end()) {
+		debugPrintf("EventMgr: cannot deserialize event id 0x%08x, not registered\n", eventTypeId);
+		return EventPtr();
+	}
+	if (ri->second->isEmpty()) {
+		return make<EmptyEvent>(EmptyEvent::Key(), getEventTypeName(eventTypeId), eventTypeId);
+	}
+	EventPtr ePtr(ri->second->deserialize(in));
+	if (!ePtr || !in.ok()) {
+		debugPrintf("EventMgr: cannot deserialize \"%s\" event\n", getEventTypeName(eventTypeId).c_str());
+		return EventPtr();
+	}
+	return ePtr;
+}
+
+/*-----------------------------------------------------------------------------
+	Recreates a remote event from a received packet. The payload is read in
+	place through the type's wire schema.
+-----------------------------------------------------------------------------*/
+EventPtr EventManager::readRemoteEvent(EventTypeId eventTypeId, BitReader &in, int targetClientId) const
+{
+	RegEventMap::const_iterator ri = m_regEventMap.find(eventTypeId);
+	if (ri == m_regEventMap.end() || !ri->second->remoteAllowed()) {
+		debugPrintf("EventMgr: cannot read remote event id 0x%08x, not registered as remote\n", eventTypeId);
+		return EventPtr();
+	}
+	if (ri->second->isEmpty()) {
+		return make<EmptyEvent>(EmptyEvent::Key(), getEventTypeName(eventTypeId), eventTypeId);
+	}
+	WireReader wireIn(in, *ri->second->getWireSchema());
+	EventPtr ePtr(ri->second->readRemote(wireIn, targetClientId));
+	if (!ePtr || !in.ok()) {
+		debugPrintf("EventMgr: cannot read remote \"%s\" event\n", getEventTypeName(eventTypeId).c_str());
+		return EventPtr();
+	}
+	return ePtr;
+}
+
 /*-----------------------------------------------------------------------------
 	Multithread safe raise methods
 -----------------------------------------------------------------------------*/
 void EventManager::raiseThreadSafe(const EventPtr &ePtr)
 {
-	if (!isEventTypeRegistered((*ePtr).type())) {
+	if (!isEventTypeRegistered((*ePtr).typeId())) {
 		debugPrintf("EventMgr: cannot raise \"%s\" event, not registered\n", (*ePtr).type().c_str());
 		return;
 	}
@@ -105,11 +472,21 @@ void EventManager::raiseThreadSafe(const EventPtr &ePtr)
 
 void EventManager::raiseThreadSafe(const string &eventType)
 {
-	RegEventMap::const_iterator ri = m_regEventMap.find(eventType);
+	EventTypeId eventTypeId = eventTypeIdOf(eventType);
+	if (!isEventTypeRegistered(eventTypeId)) {
+		debugPrintf("EventMgr: cannot raise \"%s\" event, not registered\n", eventType.c_str());
+		return;
+	}
+	raiseThreadSafe(eventTypeId);
+}
+
+void EventManager::raiseThreadSafe(EventTypeId eventTypeId)
+{
+	RegEventMap::const_iterator ri = m_regEventMap.find(eventTypeId);
 	if (ri != m_regEventMap.end()) {
 		_ASSERTE(ri->second->isEmpty() && "Cannot raise non-empty event with this interface, use EventPtr interface");
 		if (ri->second->isEmpty()) {
-			EventPtr ePtr(new EmptyEvent(eventType));
+			EventPtr ePtr(make<EmptyEvent>(EmptyEvent::Key(), getEventTypeName(eventTypeId), eventTypeId));
 			(*ePtr).mState = EventState_Raised;
 			(*ePtr).mTime = Timer::queryCounts();
 			m_threadEventQueue.push(ePtr);
@@ -118,7 +495,7 @@ void EventManager::raiseThreadSafe(const string &eventType)
 			// add message to release logging
 		}
 	} else {
-		debugPrintf("EventMgr: cannot raise \"%s\" event, not registered\n", eventType.c_str());
+		debugPrintf("EventMgr: cannot raise event id 0x%08x, not registered\n", eventTypeId);
 	}
 }
 
@@ -127,13 +504,14 @@ void EventManager::raiseThreadSafe(const string &eventType)
 -----------------------------------------------------------------------------*/
 void EventManager::trigger(const EventPtr &ePtr)
 {
-	if (!isEventTypeRegistered((*ePtr).type())) {
+	if (!isEventTypeRegistered((*ePtr).typeId())) {
 		debugPrintf("EventMgr: cannot trigger \"%s\" event, not registered\n", (*ePtr).type().c_str());
 		return;
 	}
 	debugPrintf("EventMgr: \"%s\" event triggered\n", (*ePtr).type().c_str());
 	(*ePtr).mState = EventState_Triggered;
 	(*ePtr).mTime = Timer::queryCounts();
+	if (m_recorder && m_dispatchDepth == 0) { m_recorder->record(*ePtr, EventState_Triggered); }
 	notifyListeners(ePtr);
 }
 /*-----------------------------------------------------------------------------
@@ -143,27 +521,39 @@ void EventManager::trigger(const EventPtr &ePtr)
 -----------------------------------------------------------------------------*/
 void EventManager::trigger(const string &eventType)
 {
-	RegEventMap::const_iterator ri = m_regEventMap.find(eventType);
+	EventTypeId eventTypeId = eventTypeIdOf(eventType);
+	if (!isEventTypeRegistered(eventTypeId)) {
+		debugPrintf("EventMgr: cannot trigger \"%s\" event, not registered\n", eventType.c_str());
+		return;
+	}
+	trigger(eventTypeId);
+}
+
+void EventManager::trigger(EventTypeId eventTypeId)
+{
+	RegEventMap::const_iterator ri = m_regEventMap.find(eventTypeId);
 	if (ri != m_regEventMap.end()) {
 		_ASSERTE(ri->second->isEmpty() && "Cannot trigger non-empty event with this interface, use EventPtr interface");
 		if (ri->second->isEmpty()) {
-			EventPtr ePtr(new EmptyEvent(eventType));
-			debugPrintf("EventMgr: \"%s\" event triggered\n", eventType.c_str());
+			EventPtr ePtr(make<EmptyEvent>(EmptyEvent::Key(), getEventTypeName(eventTypeId), eventTypeId));
+			debugPrintf("EventMgr: \"%s\" event triggered\n", (*ePtr).type().c_str());
 			(*ePtr).mState = EventState_Triggered;
 			(*ePtr).mTime = Timer::queryCounts();
+			if (m_recorder && m_dispatchDepth == 0) { m_recorder->record(*ePtr, EventState_Triggered); }
 			notifyListeners(ePtr);
 		} else {
 			// add message to release logging
 		}
 	} else {
-		debugPrintf("EventMgr: cannot trigger \"%s\" event, not registered\n", eventType.c_str());
+		debugPrintf("EventMgr: cannot trigger event id 0x%08x, not registered\n", eventTypeId);
 	}
 }
 
 /*-----------------------------------------------------------------------------
-	Run through the queue and notify listeners, then purge the queue
-	If maxMillis > 0, the loop will exit after time expires, and remaining
-	events will be processed next frame
+	Run through the queue and notify listeners, then purge the queue.
+	Events are handled by priority class, High first. If maxMillis > 0, the
+	budget is checked before each Normal or Low event, and once it runs out
+	the remaining events roll over to the next frame.
 -----------------------------------------------------------------------------*/
 void EventManager::notifyQueued(uint32_t maxMillis)
 {
@@ -173,8 +563,17 @@ void EventManager::notifyQueued(uint32_t maxMillis)
 	// program stutter or hang. Can't do much about this case except design worker threads carefully
 	// to not send events too often.
 	EventPtr ePtr;
+	size_t numThreadEvents = 0;
 	while (m_threadEventQueue.tryPop(ePtr)) {
-		notifyListeners(ePtr);
+		if (m_recorder) { m_recorder->record(*ePtr, EventState_Raised); }
+		if (m_metrics) { m_metrics->countRaised((*ePtr).typeId()); }
+		notifyQueuedListeners(ePtr);
+		++numThreadEvents;
+	}
+
+	// raise the timed events that are due, they go in the active queue and are handled with it below
+	if (!m_timerWheel.empty()) {
+		raiseScheduled();
 	}
 
 	// Now work on the regular event queue
@@ -183,46 +582,147 @@ void EventManager::notifyQueued(uint32_t maxMillis)
 	m_activeQueue = (m_activeQueue == 0) ? 1 : 0;
 	clearEventQueue(m_activeQueue); // make sure new active queue starts empty, but should already be empty
 
-	// run through the now inactive queue and notify listeners to handle each event
-	// may not reach end of queue if time expires
-	Timer timer;
-	timer.start();
-	EventQueue::const_iterator	ei = m_eventQueue[processQueue].begin(),
-								end = m_eventQueue[processQueue].end();
-	int temp = 0;
-	while (ei != end) {
-		notifyListeners(*ei);
-		++temp;
-		++ei;
-		m_eventQueue[processQueue].pop_front();
-		// if maxMillis is exceeded, time to break out of the loop
-		// timer.stop() is an expensive call, consider calling this conditional once per 10 events or something
-		if (timer.stop() > maxMillis && maxMillis != 0) break;
-	}
-
-	// if there are remaining events in the queue, push them to front of active queue so they'll be processed first next frame
-	// clears the inactive queue if not already empty
-	if (m_eventQueue[processQueue].size() > 0) {
-		debugPrintf("%i queued events rolled over\n", m_eventQueue[processQueue].size());
-		do {
-			m_eventQueue[m_activeQueue].push_front(m_eventQueue[processQueue].back());
-			m_eventQueue[processQueue].pop_back();
-		} while (m_eventQueue[processQueue].size() > 0);
+	if (m_metrics) {
+		size_t depth = numThreadEvents;
+		for (int p = EventPriority_High; p < EventPriority_MAX; ++p) {
+			depth += m_eventQueue[processQueue][p].size();
+		}
+		m_metrics->recordQueueDepth(depth);
+	}
+
+	// run through the now inactive queues and notify listeners to handle each event, by priority class
+	// Normal and Low classes may not reach the end of their queue if time expires
+	const int64_t startCounts = Timer::queryCounts();
+	const int64_t budgetCounts = static_cast<int64_t>(maxMillis) * Timer::timerFreq() / 1000;
+	const double millisPerCount = Timer::secondsPerCount() * 1000.0;
+	int64_t nowCounts = startCounts;
+	bool overBudget = false;
+
+	for (int p = EventPriority_High; p < EventPriority_MAX && !overBudget; ++p) {
+		EventQueue &queue = m_eventQueue[processQueue][p];
+		while (!queue.empty()) {
+			if (p != EventPriority_High && maxMillis != 0 && nowCounts - startCounts >= budgetCounts) {
+				overBudget = true;
+				break;
+			}
+			const EventPtr &queuedPtr = queue.front();
+
+			double staleMillis = static_cast<double>(nowCounts - (*queuedPtr).mTime) * millisPerCount;
+			++m_pumpStats.handled[p];
+			m_pumpStats.totalStaleMillis[p] += staleMillis;
+			if (staleMillis > m_pumpStats.maxStaleMillis[p]) { m_pumpStats.maxStaleMillis[p] = staleMillis; }
+			if ((*queuedPtr).mRollovers > 0) {
+				++m_pumpStats.handledLate[p];
+				m_pumpStats.totalLateStaleMillis[p] += staleMillis;
+				if (staleMillis > m_pumpStats.maxLateStaleMillis[p]) { m_pumpStats.maxLateStaleMillis[p] = staleMillis; }
+			}
+
+			notifyQueuedListeners(queuedPtr);
+			queue.pop_front();
+			nowCounts = Timer::queryCounts();
+		}
+	}
+
+	// if there are remaining events in the queues, move them to the front of the active queues so they'll be
+	// processed first next frame, this clears the inactive queues
+	if (overBudget) {
+		++m_pumpStats.framesOverBudget;
+		rolloverQueued(processQueue);
+	}
+
+	// exclusive handlers are done for this pass, now let the concurrent observers see their events
+	runConcurrentBatches();
+
+	// deliver events raised on the typed channels, these are not subject to maxMillis
+	for (size_t c = 0; c < m_eventChannels.size(); ++c) {
+		m_eventChannels[c]->flush();
+	}
+}
+
+/*-----------------------------------------------------------------------------
+	Moves events left in the processed queue to the front of the active queue,
+	keeping their order and ahead of events raised this frame. An event that
+	has rolled over m_promoteAfterRollovers times since it last moved is aged
+	up a priority class, so a steady load of higher priority events can delay
+	low priority events but never starve them.
+-----------------------------------------------------------------------------*/
+void EventManager::rolloverQueued(uint32_t processQueue)
+{
+	EventQueue carried[EventPriority_MAX];
+	size_t numCarried = 0;
+
+	for (int p = EventPriority_High; p < EventPriority_MAX; ++p) {
+		EventQueue &queue = m_eventQueue[processQueue][p];
+		while (!queue.empty()) {
+			Event &e = *queue.front();
+			if (e.mRollovers < UINT8_MAX) { ++e.mRollovers; }
+			++m_pumpStats.rolledOver[p];
+			++numCarried;
+
+			int target = p;
+			if (p > EventPriority_High && e.mRollovers % m_promoteAfterRollovers == 0) {
+				++m_pumpStats.promoted[p];
+				target = p - 1;
+			}
+			// splice moves the list node, no allocation
+			carried[target].splice(carried[target].end(), queue, queue.begin());
+		}
+	}
+	for (int p = EventPriority_High; p < EventPriority_MAX; ++p) {
+		EventQueue &active = m_eventQueue[m_activeQueue][p];
+		active.splice(active.begin(), carried[p]);
+	}
+	debugPrintf("EventMgr: %u queued events rolled over\n", (uint32_t)numCarried);
+}
+
+void EventManager::resetPumpStats()
+{
+	memset(&m_pumpStats, 0, sizeof(EventPumpStats));
+}
+
+void EventManager::logPumpStats() const
+{
+	static const char *sPriorityName[EventPriority_MAX] = { "High", "Normal", "Low" };
+	debugPrintf("EventMgr: pump stats, %llu frames over budget, %llu thread safe raises overflowed the queue\n",
+				m_pumpStats.framesOverBudget, m_threadEventQueue.overflowed());
+	for (int p = EventPriority_High; p < EventPriority_MAX; ++p) {
+		uint64_t handled = m_pumpStats.handled[p];
+		uint64_t late = m_pumpStats.handledLate[p];
+		debugPrintf("  %-6s handled %llu, coalesced %llu, stale avg %.3fms max %.3fms, rolled over %llu, promoted %llu, late %llu avg %.3fms max %.3fms\n",
+					sPriorityName[p], handled, m_pumpStats.coalesced[p],
+					(handled > 0 ? m_pumpStats.totalStaleMillis[p] / handled : 0.0), m_pumpStats.maxStaleMillis[p],
+					m_pumpStats.rolledOver[p], m_pumpStats.promoted[p], late,
+					(late > 0 ? m_pumpStats.totalLateStaleMillis[p] / late : 0.0), m_pumpStats.maxLateStaleMillis[p]);
 	}
 }
 
 /*-----------------------------------------------------------------------------
 	Registers an event type so that it may be triggered or raised. The
 	RegisteredEvent implementation will determine if the event can be triggered
-	from script or just code. Returns true if registration is successful.
+	from script or just code. priority sets the class queued events of this
+	type are handled in. Returns true if registration is successful.
 -----------------------------------------------------------------------------*/
-bool EventManager::registerEventType(const string &eventType, const RegEventPtr &regPtr)
+bool EventManager::registerEventType(const string &eventType, const RegEventPtr &regPtr,
+									 EventPriority priority)
 {
-	RegEventMap::iterator ri = m_regEventMap.find(eventType);
+	EventTypeId eventTypeId = 0;
+	if (!internEventType(eventType, eventTypeId)) {
+		debugPrintf("EventMgr: failed to register event type \"%s\", id collision\n", eventType.c_str());
+		return false;
+	}
+	RegEventMap::iterator ri = m_regEventMap.find(eventTypeId);
 	if (ri == m_regEventMap.end()) { // not yet registered, good
-		RegEventMapResult r = m_regEventMap.insert(RegEventMapValue(eventType, regPtr));
+		regPtr->setEventPriority(priority);
+		RegEventMapResult r = m_regEventMap.insert(RegEventMapValue(eventTypeId, regPtr));
 		if (r.second) {
 			debugPrintf("EventMgr: event type \"%s\" registered\n", eventType.c_str());
+			// create the typed channel if the registration opts into one
+			EventChannelPtr chPtr(regPtr->createChannel());
+			if (chPtr) {
+				_ASSERTE(chPtr->typeId() == eventTypeId && "Typed channel must be registered with TEvent::sEventType");
+				m_eventChannelMap.insert(EventChannelMapValue(eventTypeId, chPtr));
+				m_eventChannels.push_back(chPtr.get());
+			}
 		} else {
 			debugPrintf("EventMgr: event type \"%s\" failed to register!\n", eventType.c_str());
 		}
@@ -233,81 +733,219 @@ bool EventManager::registerEventType(const string &eventType, const RegEventPtr
 	return false;
 }
 
+/*-----------------------------------------------------------------------------
+	Creates or destroys the metrics layer. Enabling while already enabled
+	keeps the metrics gathered so far.
+-----------------------------------------------------------------------------*/
+void EventManager::enableMetrics(bool enable)
+{
+	if (enable && !m_metrics) {
+		m_metrics.reset(new EventMetrics());
+		debugPrintf("EventMgr: metrics enabled\n");
+	} else if (!enable && m_metrics) {
+		m_metrics.reset();
+		debugPrintf("EventMgr: metrics disabled\n");
+	}
+}
+
+bool EventManager::dumpMetrics(const string &filename) const
+{
+	if (!m_metrics) {
+		debugPrintf("EventMgr: metrics not enabled, nothing to dump\n");
+		return false;
+	}
+	return m_metrics->dump(filename, *this);
+}
+
+/*-----------------------------------------------------------------------------
+	Sets the coalescing policy of a registered event type. The policy applies
+	to events raised from now on, events already queued are left alone.
+-----------------------------------------------------------------------------*/
+bool EventManager::setEventCoalescing(EventTypeId eventTypeId, EventCoalescing coalescing, EventMergeFunc merge)
+{
+	RegEventMap::iterator ri = m_regEventMap.find(eventTypeId);
+	if (ri == m_regEventMap.end()) {
+		debugPrintf("EventMgr: cannot set coalescing of event id 0x%08x, not registered\n", eventTypeId);
+		return false;
+	}
+	_ASSERTE((coalescing != EventCoalescing_Accumulate || merge) && "Accumulate coalescing requires a merge function");
+	if (coalescing == EventCoalescing_Accumulate && !merge) {
+		return false;
+	}
+	ri->second->setEventCoalescing(coalescing, merge);
+	debugPrintf("EventMgr: event type \"%s\" coalescing set to %d\n", getEventTypeName(eventTypeId).c_str(), coalescing);
+	return true;
+}
+
+/*-----------------------------------------------------------------------------
+	Duplicates are found with a linear scan of the contiguous table, and the
+	insert position with a binary search. During dispatch the entry is appended
+	instead, and sorted into place when dispatch finishes.
+-----------------------------------------------------------------------------*/
+bool EventManager::insertListenerEntry(ListenerTable &table, const ListenerTableValue &entry)
+{
+	// check that listener doesn't already exist, tombstones have a null listener so never match
+	for (size_t l = 0; l < table.size(); ++l) {
+		if (table[l].mListener == entry.mListener) { return false; }
+	}
+	if (m_dispatchDepth > 0) {
+		// a dispatch loop may be walking this table by index, don't move its entries
+		table.push_back(entry);
+	} else {
+		ListenerTable::iterator li = std::upper_bound(table.begin(), table.end(), entry,
+			[](const ListenerTableValue &a, const ListenerTableValue &b) {
+				return listenerSortKey(a.mPriority) < listenerSortKey(b.mPriority);
+			});
+		table.insert(li, entry);
+	}
+	return true;
+}
+
+/*-----------------------------------------------------------------------------
+	During dispatch the entry is left as a tombstone, and the table is
+	compacted when dispatch finishes
+-----------------------------------------------------------------------------*/
+bool EventManager::removeListenerEntry(ListenerTable &table, EventListener *lPtr)
+{
+	for (size_t l = 0; l < table.size(); ++l) {
+		if (table[l].mListener == lPtr) {	// match
+			if (m_dispatchDepth > 0) {
+				table[l].mListener = 0;
+			} else {
+				table.erase(table.begin() + l);
+			}
+			return true;
+		}
+	}
+	return false;
+}
+
 /*-----------------------------------------------------------------------------
 	Returns true if added, false if already exists, with priority (1 is highest
 	priority, 0 is no priority or FIFO order). If event type does not exist it
-	is added. An O(n) operation since it traverses the existing list for
-	duplicates.
+	is added.
 -----------------------------------------------------------------------------*/
-bool EventManager::registerListener(const string &eventType, EventListener *lPtr, uint32_t priority)
+bool EventManager::registerListener(const string &eventType, EventListener *lPtr, uint32_t priority,
+									ListenerConcurrency concurrency)
 {
 	_ASSERTE(lPtr);
 
-	EventTypeMap::iterator ei = m_eventTypeMap.find(eventType);
-	if (ei == m_eventTypeMap.end()) {	// event type does not exist yet, so add it and register the listener
-		EventTypeMapResult r = m_eventTypeMap.insert(EventTypeMapValue(eventType, ListenerList()));
-		debugPrintf("EventMgr: event type \"%s\" created in listener map\n", eventType.c_str());
-		(*r.first).second.push_back(ListenerListValue(lPtr,priority));
-		debugPrintf("EventMgr: listener \"%s\" for event type \"%s\" registered with priority %d\n", lPtr->name().c_str(), eventType.c_str(), priority);
+	EventTypeId eventTypeId = 0;
+	if (!internEventType(eventType, eventTypeId)) {
+		debugPrintf("EventMgr: listener \"%s\" for event type \"%s\" not registered, id collision\n", lPtr->name().c_str(), eventType.c_str());
+		return false;
+	}
+	// a listener in both tables would be notified twice
+	uint32_t numSubjects = subjectCount(lPtr, eventTypeId);
+	if (numSubjects > 0) {
+		debugPrintf("EventMgr: listener \"%s\" is subscribed to %u subjects of event type \"%s\", not registered type-wide\n", lPtr->name().c_str(), numSubjects, eventType.c_str());
+		return false;
+	}
+	ListenerTableValue entry = { lPtr, priority, concurrency };
+	if (concurrency == ListenerConcurrency_Concurrent && !m_jobSystem) {
+		m_jobSystem = std::make_shared<JobSystem>(JobSystem::defaultNumThreads());
+	}
+
+	EventTypeMap::iterator ei = m_eventTypeMap.find(eventTypeId);
+	if (ei == m_eventTypeMap.end()) {	// event type does not exist yet, so add it
+		EventTypeMapResult r = m_eventTypeMap.insert(EventTypeMapValue(eventTypeId, ListenerTable()));
 		_ASSERTE(r.second == true);
+		ei = r.first;
+		debugPrintf("EventMgr: event type \"%s\" created in listener map\n", eventType.c_str());
+	}
+
+	if (!insertListenerEntry(ei->second, entry)) {
+		debugPrintf("EventMgr: listener \"%s\" for event type \"%s\" already exists, not registered\n", lPtr->name().c_str(), eventType.c_str());
+		return false;
+	}
+	if (m_dispatchDepth > 0) {
+		markListenerTableDirty(eventTypeId);
+	}
+	debugPrintf("EventMgr: listener \"%s\" for event type \"%s\" registered with priority %d\n", lPtr->name().c_str(), eventType.c_str(), priority);
+
+	return true;
+}
 
-	} else { // event type exists, check that listener doesn't already exist
-		ListenerList::iterator	li, lPriorityInsert = (*ei).second.begin(),
-								end = (*ei).second.end();
-		for (li = (*ei).second.begin(); li != end; ++li) {
-			// 1) check the whole list to see if it's a repeat
-			if ((*li).first == lPtr) {
-				debugPrintf("EventMgr: listener \"%s\" for event type \"%s\" already exists, not registered\n", lPtr->name().c_str(), eventType.c_str());
+/*-----------------------------------------------------------------------------
+	Subject subscriptions come and go with the objects they follow, so unlike
+	type-wide registration they are only logged when they fail
+-----------------------------------------------------------------------------*/
+bool EventManager::registerListener(const string &eventType, uint32_t subject, EventListener *lPtr, uint32_t priority,
+									ListenerConcurrency concurrency)
+{
+	_ASSERTE(lPtr);
+
+	EventTypeId eventTypeId = 0;
+	if (!internEventType(eventType, eventTypeId)) {
+		debugPrintf("EventMgr: listener \"%s\" for event type \"%s\" not registered, id collision\n", lPtr->name().c_str(), eventType.c_str());
+		return false;
+	}
+	// a listener in both tables would be notified twice
+	EventTypeMap::const_iterator ei = m_eventTypeMap.find(eventTypeId);
+	if (ei != m_eventTypeMap.end()) {
+		const ListenerTable &typeTable = ei->second;
+		for (size_t l = 0; l < typeTable.size(); ++l) {
+			if (typeTable[l].mListener == lPtr) {
+				debugPrintf("EventMgr: listener \"%s\" is registered for all of event type \"%s\", subject %u not registered\n", lPtr->name().c_str(), eventType.c_str(), subject);
 				return false;
 			}
-			// 2) find where it would be inserted if based on priority
-			if (((priority >= (*li).second) && ((*li).second != 0)) || (priority == 0)) ++lPriorityInsert;
-		}
-		if (priority == 0) { // just add to back of list for FIFO order
-			(*ei).second.push_back(ListenerListValue(lPtr,0));
-			debugPrintf("EventMgr: listener \"%s\" for event type \"%s\" registered with priority %d\n", lPtr->name().c_str(), eventType.c_str(), priority);
-		} else { // insert in priority order
-			(*ei).second.insert(lPriorityInsert, ListenerListValue(lPtr,priority));
-			debugPrintf("EventMgr: listener \"%s\" for event type \"%s\" registered with priority %d\n", lPtr->name().c_str(), eventType.c_str(), priority);
 		}
 	}
+	ListenerTableValue entry = { lPtr, priority, concurrency };
+	if (concurrency == ListenerConcurrency_Concurrent && !m_jobSystem) {
+		m_jobSystem = std::make_shared<JobSystem>(JobSystem::defaultNumThreads());
+	}
 
+	uint64_t subjectKey = eventSubjectKey(eventTypeId, subject);
+	SubjectTableMap::iterator si = m_subjectTableMap.find(subjectKey);
+	if (si == m_subjectTableMap.end()) {
+		si = m_subjectTableMap.insert(SubjectTableMapValue(subjectKey, ListenerTable())).first;
+	}
+	if (!insertListenerEntry(si->second, entry)) {
+		debugPrintf("EventMgr: listener \"%s\" for event type \"%s\" subject %u already exists, not registered\n", lPtr->name().c_str(), eventType.c_str(), subject);
+		return false;
+	}
+	countSubject(lPtr, eventTypeId, true);
+	if (m_dispatchDepth > 0) {
+		markSubjectTableDirty(subjectKey);
+	}
 	return true;
 }
-		
+
 /*-----------------------------------------------------------------------------
 	Removes a listener from an event type, if event type has no more listeners
 	it is removed
 -----------------------------------------------------------------------------*/
-bool EventManager::removeListener(const string &eventType, EventListener *lPtr)
+bool EventManager::removeListener(EventTypeId eventTypeId, EventListener *lPtr)
 {
 	_ASSERTE(lPtr);
+	const string &eventType = getEventTypeName(eventTypeId);
 
 	// check for event type in the map
-	EventTypeMap::iterator ei = m_eventTypeMap.find(eventType);
+	EventTypeMap::iterator ei = m_eventTypeMap.find(eventTypeId);
 	if (ei == m_eventTypeMap.end()) {
 		debugPrintf("EventMgr: event type \"%s\" not found, listener \"%s\" not removed\n", eventType.c_str(), lPtr->name().c_str());
 		return false;
 	}
 
-	size_t startSize = (*ei).second.size();	// store size of the list before attempting a removal
-
-	// remove the matching listener in the event type's list
-	ListenerList::iterator li, end = (*ei).second.end();
-	for (li = (*ei).second.begin(); li != end; ++li) {
-		if ((*li).first == lPtr) {	// match
-			(*ei).second.erase(li);
-			debugPrintf("EventMgr: listener \"%s\" for event type \"%s\" removed\n", lPtr->name().c_str(), eventType.c_str());
-			break;
-		}
+	// remove the matching listener in the event type's table
+	ListenerTable &table = ei->second;
+	bool removed = removeListenerEntry(table, lPtr);
+	if (removed) {
+		if (m_dispatchDepth > 0) { markListenerTableDirty(eventTypeId); }
+		debugPrintf("EventMgr: listener \"%s\" for event type \"%s\" removed\n", lPtr->name().c_str(), eventType.c_str());
 	}
-	if ((*ei).second.size() == startSize) {
+	// drop events of this type batched for the listener, it may be going away before the batch runs
+	dropBatchedEvents(lPtr, eventTypeId, false, 0);
+	retireListenerMetrics(eventTypeId, lPtr);
+	if (!removed) {
 		debugPrintf("EventMgr: listener \"%s\" for event type \"%s\" not found, not removed\n", lPtr->name().c_str(), eventType.c_str());
-		return false;	// listener not found for removal in the list
+		return false;	// listener not found for removal in the table
 	}
 
-	// if the event type has no more listeners, it can be removed from the map
-	if ((*ei).second.size() == 0) {
+	// if the event type has no more listeners, it can be removed from the map, but not while a
+	// dispatch may hold a reference to the table, compactListenerTables does it then
+	if (table.empty()) {
 		m_eventTypeMap.erase(ei);
 		debugPrintf("EventMgr: event type \"%s\" removed from listener map, no more listeners\n", eventType.c_str());
 	}
@@ -315,27 +953,186 @@ bool EventManager::removeListener(const string &eventType, EventListener *lPtr)
 	return true;	
 }
 
+bool EventManager::removeListener(EventTypeId eventTypeId, uint32_t subject, EventListener *lPtr)
+{
+	_ASSERTE(lPtr);
+	uint64_t subjectKey = eventSubjectKey(eventTypeId, subject);
+	SubjectTableMap::iterator si = m_subjectTableMap.find(subjectKey);
+	if (si == m_subjectTableMap.end() || !removeListenerEntry(si->second, lPtr)) {
+		debugPrintf("EventMgr: listener \"%s\" for event type \"%s\" subject %u not found, not removed\n",
+					lPtr->name().c_str(), getEventTypeName(eventTypeId).c_str(), subject);
+		return false;
+	}
+	countSubject(lPtr, eventTypeId, false);
+	dropBatchedEvents(lPtr, eventTypeId, true, subject);
+	if (m_dispatchDepth > 0) {
+		markSubjectTableDirty(subjectKey);
+	} else if (si->second.empty()) {
+		m_subjectTableMap.erase(si);
+	}
+	return true;
+}
+
+void EventManager::countSubject(EventListener *lPtr, EventTypeId eventTypeId, bool subscribed)
+{
+	vector<SubjectCount> &counts = m_subjectCounts[lPtr];
+	for (size_t c = 0; c < counts.size(); ++c) {
+		if (counts[c].first != eventTypeId) { continue; }
+		if (subscribed) {
+			++counts[c].second;
+		} else if (--counts[c].second == 0) {
+			counts[c] = counts.back();
+			counts.pop_back();
+			if (counts.empty()) { m_subjectCounts.erase(lPtr); }
+		}
+		return;
+	}
+	if (!subscribed) {
+		_ASSERTE(false && "subject unsubscribed that was never counted");
+		if (counts.empty()) { m_subjectCounts.erase(lPtr); }
+		return;
+	}
+	counts.push_back(SubjectCount(eventTypeId, 1));
+}
+
+uint32_t EventManager::subjectCount(EventListener *lPtr, EventTypeId eventTypeId) const
+{
+	SubjectCountMap::const_iterator ci = m_subjectCounts.find(lPtr);
+	if (ci == m_subjectCounts.end()) { return 0; }
+	const vector<SubjectCount> &counts = ci->second;
+	for (size_t c = 0; c < counts.size(); ++c) {
+		if (counts[c].first == eventTypeId) { return counts[c].second; }
+	}
+	return 0;
+}
+
+void EventManager::retireListenerMetrics(EventTypeId eventTypeId, EventListener *lPtr)
+{
+	if (m_metrics) {
+		m_metrics->retireListener(lPtr, eventTypeId);
+	}
+}
+
+void EventManager::dropBatchedEvents(EventListener *lPtr, EventTypeId eventTypeId, bool subjectOnly, uint32_t subject)
+{
+	ConcurrentBatchIndex::iterator bi = m_concurrentBatchIndex.find(lPtr);
+	if (bi == m_concurrentBatchIndex.end()) { return; }
+
+	ConcurrentBatch &batch = m_concurrentBatches[bi->second];
+	if (eventTypeId == EventListener::sWildcardTypeId) {
+		batch.mEvents.clear();
+	} else {
+		batch.mEvents.erase(std::remove_if(batch.mEvents.begin(), batch.mEvents.end(),
+							[eventTypeId, subjectOnly, subject](const EventPtr &ePtr) {
+								return ((*ePtr).typeId() == eventTypeId && (!subjectOnly || (*ePtr).subject() == subject));
+							}),
+							batch.mEvents.end());
+	}
+	if (batch.mEvents.empty()) {
+		batch.mListener = 0;
+		m_concurrentBatchIndex.erase(bi);
+	}
+}
+
+void EventManager::markListenerTableDirty(EventTypeId eventTypeId)
+{
+	if (std::find(m_dirtyListenerTables.begin(), m_dirtyListenerTables.end(), eventTypeId) == m_dirtyListenerTables.end()) {
+		m_dirtyListenerTables.push_back(eventTypeId);
+	}
+}
+
+void EventManager::markSubjectTableDirty(uint64_t subjectKey)
+{
+	if (std::find(m_dirtySubjectTables.begin(), m_dirtySubjectTables.end(), subjectKey) == m_dirtySubjectTables.end()) {
+		m_dirtySubjectTables.push_back(subjectKey);
+	}
+}
+
+/*-----------------------------------------------------------------------------
+	Removes tombstones and sorts appended entries into priority order. A stable
+	sort keeps FIFO order within a priority.
+-----------------------------------------------------------------------------*/
+void EventManager::compactListenerTable(ListenerTable &table)
+{
+	table.erase(std::remove_if(table.begin(), table.end(),
+				[](const ListenerTableValue &entry) { return entry.mListener == 0; }),
+				table.end());
+	std::stable_sort(table.begin(), table.end(),
+		[](const ListenerTableValue &a, const ListenerTableValue &b) {
+			return listenerSortKey(a.mPriority) < listenerSortKey(b.mPriority);
+		});
+}
+
+/*-----------------------------------------------------------------------------
+	Applies the registrations and removals deferred during dispatch, see
+	compactListenerTable. Tables left empty are removed.
+-----------------------------------------------------------------------------*/
+void EventManager::compactListenerTables()
+{
+	_ASSERTE(m_dispatchDepth == 0);
+	for (size_t d = 0; d < m_dirtyListenerTables.size(); ++d) {
+		EventTypeMap::iterator ei = m_eventTypeMap.find(m_dirtyListenerTables[d]);
+		if (ei == m_eventTypeMap.end()) { continue; }
+
+		compactListenerTable(ei->second);
+		if (ei->second.empty()) {
+			debugPrintf("EventMgr: event type \"%s\" removed from listener map, no more listeners\n", getEventTypeName(ei->first).c_str());
+			m_eventTypeMap.erase(ei);
+		}
+	}
+	m_dirtyListenerTables.clear();
+
+	for (size_t d = 0; d < m_dirtySubjectTables.size(); ++d) {
+		SubjectTableMap::iterator si = m_subjectTableMap.find(m_dirtySubjectTables[d]);
+		if (si == m_subjectTableMap.end()) { continue; }
+
+		compactListenerTable(si->second);
+		if (si->second.empty()) {
+			m_subjectTableMap.erase(si);
+		}
+	}
+	m_dirtySubjectTables.clear();
+}
+
 EventManagerPtr EventManager::create(unique_ptr<EventSnooper> &es)
 {
 	EventManagerPtr eventMgr(new EventManager(es));
 	// inject pointer to the dependent classes
 	EventListener::s_eventMgr = eventMgr;
+	RegisteredEvent::sEventMgr = eventMgr;
 
 	return eventMgr;
 }
 
 EventManager::EventManager(unique_ptr<EventSnooper> &es) :
 	m_activeQueue(0),
+	m_dispatchDepth(0),
+	m_promoteAfterRollovers(4),
+	m_countsPerTick(Timer::timerFreq() >= 1000 ? Timer::timerFreq() / 1000 : 1),
+	m_timerWheel(static_cast<uint64_t>(Timer::queryCounts() / m_countsPerTick)),
+	m_nextScheduledId(1),
 	m_threadEventQueue(),
 	m_eventSnooper(std::move(es))
-{}
+{
+	resetPumpStats();
+}
 
 EventManager::~EventManager()
 {
+	m_jobSystem.reset();
+	logPumpStats();
 	clearEventQueue(0);
 	clearEventQueue(1);
+	m_timerWheel.clear();
+	m_pendingScheduled.clear();
 	clearListeners();
-	debugPrintf("EventMgr: created %d events, destroyed %d\n", Event::sNumEventsCreated, Event::sNumEventsDestroyed);
+	for (size_t c = 0; c < m_eventChannels.size(); ++c) {
+		m_eventChannels[c]->clear();
+	}
+	SlabPool::Stats stats = getAllocStats();
+	debugPrintf("EventMgr: event pool allocated %llu, freed %llu (%llu remote, %llu large), %lld bytes in use, %llu slabs\n",
+				stats.allocations, stats.deallocations, stats.remoteDeallocations, stats.largeAllocations,
+				stats.bytesInUse, stats.slabs);
 }
 
 ////////// class EventSnooper //////////
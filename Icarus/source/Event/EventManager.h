@@ -15,6 +15,44 @@ Event System notes:
 	event-registration has been created manually. When an event is fired, only valid listeners will
 	be notified (if, for example, a script listener registers for a code-only event before the event
 	type is actually registered).
+
+	The listeners of each event type are kept in a contiguous table sorted by priority, so dispatch
+	is a linear walk over an array. Listeners may register and unregister from inside handlers, the
+	change is deferred until the outermost dispatch returns, see compactListenerTables.
+
+	Listeners of per-object event types can subscribe to a single subject (see Event::subject) with
+	registerListener(eventType, subject, ...) instead of the whole type. Subject listeners are kept
+	in their own table per (type, subject), and dispatch walks it merged with the type's table in
+	priority order, so an event only reaches the listeners of its own subject plus the type-wide
+	ones, rather than every listener filtering every event.
+
+	Event type names are interned into 32-bit EventTypeIds the first time they are seen (by
+	registerEventType or registerListener), and both maps are keyed by id so dispatch never hashes
+	or compares strings. Names are kept in a separate table for debugging and script lookup, and a
+	second name hashing to an id already in use is rejected as a collision.
+
+	Events are created with EventManager::make<T>, which allocates the event and its shared_ptr
+	control block as one block from a per-thread SlabPool. The raised event queues draw their list
+	nodes from the same pool, so in steady state raising an event does not touch the heap. The
+	pool's counters replace the old debug-only created/destroyed tracking, see getAllocStats.
+
+	Code-only event types can opt into a statically typed EventChannel<TEvent> by registering with
+	TypedCodeOnlyEvent<TEvent>. Channel events are plain structs raised and delivered by reference
+	to typed delegates, skipping the shared_ptr, virtual handler call and downcast of the EventPtr
+	path. Channels are flushed by notifyQueued after the EventPtr queue.
+
+	High frequency event types can be set to coalesce with setEventCoalescing. Raising one looks up
+	its (type, subject) key in an index of the active queue, and an event already queued for that key
+	is replaced or merged into instead of queueing another, so the queue holds at most one event per
+	subject no matter how often it is raised between frames.
+
+	raiseAfter and raiseAt hold an event in a TimerWheel with 1ms ticks until it is due, and
+	notifyQueued raises the due events into the queue before processing it, so a timed event costs
+	nothing per frame while it waits, where a Process polling for the same delay runs every frame.
+
+	enableMetrics turns on an EventMetrics instrumentation layer, counting events per type and timing
+	every dispatch and handler call into histograms, with a report written by dumpMetrics. Disabled,
+	it costs a null pointer check per dispatch and handler call.
 Features:
 	* Allows custom event types with custom data carried by event
 	* Allows for events defined at run time and through script
@@ -22,9 +60,13 @@ Features:
 	* Event Handlers auto-register with Listeners
 	* Event Handlers can be prioritized so events are handled in the correct order, else FIFO
 	* Handlers can consume events to prevent further propagation
+	* Read-only observers can register as concurrent, queued events are batched per listener and
+		handled on the JobSystem while exclusive handlers keep priority order and consume semantics
 	* Wildcard listeners see all events, and can handle them via generic or type-specific handlers
+	* Listeners can subscribe to the events of one subject of a type, such as a single actor
 	* Events cannot be fired until their type has been registered
-	* Events types include code-only, code/script, and script-defined
+	* Events types include code-only, code/script, script-defined, and remote
+	* Remote events are bit packed by a per-type WireSchema into transport packets, see RemoteEventLink
 	* Listeners can be safely registered before corresponding event type is registered (eliminates
 		order of creation issues)
 --------------------------------*/
@@ -33,24 +75,36 @@ Features:
 
 #include <string>
 #include <list>
+#include <vector>
+#include <utility>
 #include <hash_map>
+#include <hash_set>
 #include "EventListener.h"
 #include "Event.h"
+#include "EventChannel.h"
+#include "Utility/PoolAllocator.h"
+#include "Utility/TimerWheel.h"
 #include "Utility/Debug.h"
 
 using std::string;
 using std::list;
+using std::vector;
 using std::pair;
 using std::shared_ptr;
 using std::weak_ptr;
 using std::unique_ptr;
 using std::hash_map;
+using stdext::hash_set;
 
 // Forward declarations
 class EventSnooper;
-template<typename T> class ConcurrentQueue;
+class EventRecorder;
+class EventMetrics;
+template<typename T> class MPSCQueue;
+class JobSystem;
 
-typedef ConcurrentQueue<EventPtr>	ThreadSafeEventQueue;
+typedef MPSCQueue<EventPtr>	ThreadSafeEventQueue;
+typedef uint64_t			ScheduledEventId;	// identifies an event scheduled by raiseAt/raiseAfter, 0 is invalid
 
 /*=============================================================================
 class EventManager
@@ -60,18 +114,96 @@ class EventManager
 	types event before they have been registered.
 =============================================================================*/
 class EventManager {
-	private:
+	public:
 		///// DEFINITIONS /////
 
-		typedef pair<EventListener*, uint32_t>		ListenerListValue;	// pairs the listener pointer with priority
-		typedef list<ListenerListValue>				ListenerList;		// stores listeners along with their priority
-		typedef pair<string, ListenerList>			EventTypeMapValue;	// value pair of the event type map
-		typedef hash_map<string, ListenerList>		EventTypeMap;		// hash_map to store lists of event listeners
-		typedef pair<EventTypeMap::iterator, bool>	EventTypeMapResult;	// result of inserting elements into the event type map
-		typedef pair<string, RegEventPtr>			RegEventMapValue;	// value pair of the event registration map
-		typedef hash_map<string, RegEventPtr>		RegEventMap;		// hash_map to store lists of event registrations
-		typedef pair<RegEventMap::iterator, bool>	RegEventMapResult;	// result of inserting elements into event registration map
-		typedef list<EventPtr>						EventQueue;
+		/*---------------------------------------------------------------------
+			Counters kept by notifyQueued for each event priority class.
+			Staleness is the time from raise to the start of handling.
+		---------------------------------------------------------------------*/
+		struct EventPumpStats {
+			uint64_t	handled[EventPriority_MAX];			// queued events handled
+			uint64_t	rolledOver[EventPriority_MAX];		// times an event was carried to the next frame
+			uint64_t	promoted[EventPriority_MAX];		// events aged up out of this class
+			uint64_t	handledLate[EventPriority_MAX];		// handled events that had rolled over at least once
+			double		totalStaleMillis[EventPriority_MAX];
+			double		maxStaleMillis[EventPriority_MAX];
+			double		totalLateStaleMillis[EventPriority_MAX];	// staleness of the handledLate events only
+			double		maxLateStaleMillis[EventPriority_MAX];
+			uint64_t	coalesced[EventPriority_MAX];		// raised events replaced or merged into a queued event
+			uint64_t	framesOverBudget;						// notifyQueued calls that ran out of time
+		};
+
+	private:
+
+		/*---------------------------------------------------------------------
+			A listener registration for one event type
+		---------------------------------------------------------------------*/
+		struct ListenerTableValue {
+			EventListener *		mListener;		// null for a listener removed during dispatch
+			uint32_t			mPriority;		// 1 is highest priority, 0 is no priority or FIFO order
+			ListenerConcurrency	mConcurrency;	// exclusive handlers run inline, concurrent are batched to workers
+		};
+		typedef vector<ListenerTableValue>				ListenerTable;		// contiguous, sorted by priority with FIFO entries last
+		typedef pair<EventTypeId, ListenerTable>		EventTypeMapValue;	// value pair of the event type map
+		typedef hash_map<EventTypeId, ListenerTable>	EventTypeMap;		// hash_map to store tables of event listeners
+		typedef pair<EventTypeMap::iterator, bool>		EventTypeMapResult;	// result of inserting elements into the event type map
+		typedef pair<uint64_t, ListenerTable>			SubjectTableMapValue;
+		typedef hash_map<uint64_t, ListenerTable>		SubjectTableMap;	// (type id, subject) key to the subject's listeners
+		typedef pair<EventTypeId, RegEventPtr>			RegEventMapValue;	// value pair of the event registration map
+		typedef hash_map<EventTypeId, RegEventPtr>		RegEventMap;		// hash_map to store lists of event registrations
+		typedef pair<RegEventMap::iterator, bool>		RegEventMapResult;	// result of inserting elements into event registration map
+		typedef pair<EventTypeId, string>				EventNameMapValue;	// value pair of the event name map
+		typedef hash_map<EventTypeId, string>			EventNameMap;		// interned id back to its name, for debugging and script lookup
+		/*---------------------------------------------------------------------
+			Queued events collected for one concurrent listener during
+			notifyQueued, handled in order by a single worker job
+		---------------------------------------------------------------------*/
+		struct ConcurrentBatch {
+			EventListener *		mListener;		// null if the listener was removed before the batch ran
+			vector<EventPtr>	mEvents;
+			vector<int64_t>		mHandlerCounts;	// handler time per event, filled when metrics are enabled
+		};
+		typedef hash_map<EventListener*, size_t>		ConcurrentBatchIndex;	// listener to its index in m_concurrentBatches
+		typedef pair<EventTypeId, uint32_t>				SubjectCount;		// event type and the number of its subjects subscribed to
+		typedef hash_map<EventListener*, vector<SubjectCount> > SubjectCountMap; // listener to its subject subscription counts, one per type
+		typedef pair<EventTypeId, EventChannelPtr>		EventChannelMapValue;
+		typedef hash_map<EventTypeId, EventChannelPtr>	EventChannelMap;	// typed channels of TypedCodeOnlyEvent registrations
+		/*---------------------------------------------------------------------
+			An event held by the timer wheel until it is due
+		---------------------------------------------------------------------*/
+		struct ScheduledEvent {
+			ScheduledEventId	mId;
+			EventPtr			mEvent;
+		};
+		typedef hash_set<ScheduledEventId>				ScheduledEventIdSet;
+		typedef PoolAllocator<EventPtr, SlabPool_Event>	EventQueueAllocator;
+		typedef list<EventPtr, EventQueueAllocator>		EventQueue;			// queue nodes come from the event pool
+		typedef pair<uint64_t, EventQueue::iterator>	CoalesceIndexValue;
+		typedef hash_map<uint64_t, EventQueue::iterator> CoalesceIndex;		// (type id, subject) key to its event in the active queue
+
+		/*---------------------------------------------------------------------
+			Walks the type-wide and subject listener tables of an event as a
+			single table in priority order, type-wide listeners first among
+			equal priorities. Sizes are captured at the start, like the
+			single table walks, so entries appended during dispatch are not
+			visited. Either table may be null.
+		---------------------------------------------------------------------*/
+		class ListenerMergeWalk {
+			private:
+				const ListenerTable *	mTypeTable;
+				const ListenerTable *	mSubjectTable;
+				size_t					mT, mTypeSize;
+				size_t					mS, mSubjectSize;
+			public:
+				bool next(ListenerTableValue &entry);
+				bool done() const { return (mT == mTypeSize && mS == mSubjectSize); }
+				explicit ListenerMergeWalk(const ListenerTable *typeTable, const ListenerTable *subjectTable) :
+					mTypeTable(typeTable), mSubjectTable(subjectTable),
+					mT(0), mTypeSize(typeTable ? typeTable->size() : 0),
+					mS(0), mSubjectSize(subjectTable ? subjectTable->size() : 0)
+				{}
+		};
 
 		// add a type returned by listeners for consumed vs. not consumed (allowing further notifications of the event)
 		// so a high priority listener may choose to consume an event before others are notified
@@ -80,19 +212,45 @@ class EventManager {
 
 		RegEventMap		m_regEventMap;		// maps registration types to event types
 		EventTypeMap	m_eventTypeMap;		// maps listeners to their event types
-		EventQueue		m_eventQueue[2];		// double-buffered list of events that have been raised
+		SubjectTableMap	m_subjectTableMap;	// maps subject listeners to their (event type, subject)
+		SubjectCountMap	m_subjectCounts;	// subject subscriptions per listener and type, so type-wide registration needn't walk the subject tables
+		EventNameMap	m_eventNameMap;		// maps interned event type ids to their names
+		EventChannelMap	m_eventChannelMap;	// maps event type ids to their typed channels
+		vector<IEventChannel*> m_eventChannels; // channels in registration order, flushed by notifyQueued
+		EventQueue		m_eventQueue[2][EventPriority_MAX];	// double-buffered lists of raised events, one per priority class
 		uint32_t		m_activeQueue;		// the active event queue is written to while the inactive queue is being processed
+		uint32_t		m_dispatchDepth;	// > 0 while listeners are being notified, triggers can nest
+		vector<EventTypeId> m_dirtyListenerTables; // tables changed during dispatch, compacted after
+		vector<uint64_t> m_dirtySubjectTables;	// subject tables changed during dispatch
+		uint8_t			m_promoteAfterRollovers; // rolled over events move up a priority class after this many frames
+		EventPumpStats	m_pumpStats;		// accumulated by notifyQueued
+		CoalesceIndex	m_coalesceIndex;	// queued events of coalescing types in the active queue
+		int64_t			m_countsPerTick;	// Timer counts per timer wheel tick
+		TimerWheel<ScheduledEvent> m_timerWheel; // events waiting on raiseAt/raiseAfter, ticks are milliseconds
+		ScheduledEventIdSet	m_pendingScheduled;	// ids in the timer wheel not yet raised or cancelled
+		ScheduledEventId	m_nextScheduledId;
 
 		unique_ptr<EventSnooper> m_eventSnooper; // wildcard event listener
+		shared_ptr<EventRecorder> m_recorder;	// records raised and triggered events when set
+		unique_ptr<EventMetrics> m_metrics;		// instrumentation, null when disabled
 
-		ThreadSafeEventQueue m_threadEventQueue; // thread-safe event queue, used for inter-thread events
+		ThreadSafeEventQueue m_threadEventQueue; // lock-free MPSC event queue, used for inter-thread events
+
+		shared_ptr<JobSystem>	m_jobSystem;		// runs concurrent listeners, shared or created with the first one registered
+		vector<ConcurrentBatch>	m_concurrentBatches;	// per-listener batches built by notifyQueued
+		ConcurrentBatchIndex	m_concurrentBatchIndex;
 
 		///// FUNCTIONS /////
 
 		/*---------------------------------------------------------------------
 			Cleanup for when manager is destroyed or being reset
 		---------------------------------------------------------------------*/
-		void clearListeners() { m_eventTypeMap.clear(); }
+		void clearListeners()
+		{
+			m_eventTypeMap.clear();
+			m_subjectTableMap.clear();
+			m_subjectCounts.clear();
+		}
 
 		/*---------------------------------------------------------------------
 			Purge event queue (usually done each frame, called by notifyQueued)
@@ -100,29 +258,162 @@ class EventManager {
 		void clearEventQueue(uint32_t queueToClear)
 		{
 			_ASSERTE(queueToClear == 0 || queueToClear == 1);
-			m_eventQueue[queueToClear].clear();
+			for (int p = 0; p < EventPriority_MAX; ++p) {
+				m_eventQueue[queueToClear][p].clear();
+			}
+			// the index only ever refers to the active queue, and is stale once the queues flip
+			m_coalesceIndex.clear();
 		}
 
+		/*---------------------------------------------------------------------
+			Adds a raised event to the active queue of its priority class,
+			or coalesces it with the event already queued for its subject
+		---------------------------------------------------------------------*/
+		void queueEvent(const EventPtr &ePtr, const RegisteredEvent &reg);
+
+		/*---------------------------------------------------------------------
+			Raises the scheduled events that have come due, called at the
+			start of notifyQueued
+		---------------------------------------------------------------------*/
+		void raiseScheduled();
+
+		/*---------------------------------------------------------------------
+			Moves events left in the processed queue to the front of the
+			active queue when the budget runs out, aging them up a class
+			every m_promoteAfterRollovers frames
+		---------------------------------------------------------------------*/
+		void rolloverQueued(uint32_t processQueue);
+
+		/*---------------------------------------------------------------------
+			Calls a listener's handler, timing it when metrics are enabled
+		---------------------------------------------------------------------*/
+		bool callHandler(EventListener &listener, const EventPtr &ePtr) const;
+
 		/*---------------------------------------------------------------------
 			Notifies listeners of a single event raised or triggered
 		---------------------------------------------------------------------*/
-		void notifyListeners(const EventPtr &ePtr) const;
+		void notifyListeners(const EventPtr &ePtr);
+
+		/*---------------------------------------------------------------------
+			Notifies the exclusive listeners of a queued event in priority
+			order, and appends the event to the batch of each concurrent
+			listener it reaches before being consumed
+		---------------------------------------------------------------------*/
+		void notifyQueuedListeners(const EventPtr &ePtr);
+		void batchConcurrent(EventListener *lPtr, const EventPtr &ePtr);
+
+		/*---------------------------------------------------------------------
+			Listener tables are not reordered while a dispatch is walking
+			them. Registrations during dispatch are appended and removals
+			leave a tombstone, then the table is marked dirty and compacted
+			once the outermost dispatch returns.
+		---------------------------------------------------------------------*/
+		void markListenerTableDirty(EventTypeId eventTypeId);
+		void markSubjectTableDirty(uint64_t subjectKey);
+		void compactListenerTables();
+		static void compactListenerTable(ListenerTable &table);
+
+		/*---------------------------------------------------------------------
+			Adds a listener entry in priority order, or appends it during
+			dispatch. Returns false if the listener is already in the table.
+		---------------------------------------------------------------------*/
+		bool insertListenerEntry(ListenerTable &table, const ListenerTableValue &entry);
+
+		/*---------------------------------------------------------------------
+			Removes a listener's entry, or leaves a tombstone during dispatch.
+			Returns false if the listener is not in the table.
+		---------------------------------------------------------------------*/
+		bool removeListenerEntry(ListenerTable &table, EventListener *lPtr);
+
+		/*---------------------------------------------------------------------
+			Counts a listener's subject subscription of a type in or out, and
+			returns how many of the type's subjects it subscribes to
+		---------------------------------------------------------------------*/
+		void		countSubject(EventListener *lPtr, EventTypeId eventTypeId, bool subscribed);
+		uint32_t	subjectCount(EventListener *lPtr, EventTypeId eventTypeId) const;
+
+		/*---------------------------------------------------------------------
+			Finds the listener tables an event is dispatched to, the type's
+			table and the table of the event's subject, null if none
+		---------------------------------------------------------------------*/
+		void findListenerTables(const Event &e, ListenerTable *&typeTable, ListenerTable *&subjectTable);
+
+		/*---------------------------------------------------------------------
+			Drops events batched for a concurrent listener that is being
+			removed, all of them for the wildcard type, otherwise those of
+			the event type, and only of the subject if subjectOnly is set
+		---------------------------------------------------------------------*/
+		void dropBatchedEvents(EventListener *lPtr, EventTypeId eventTypeId, bool subjectOnly, uint32_t subject);
+
+		/*---------------------------------------------------------------------
+			Runs the concurrent listener batches on the job system, and
+			waits for them to finish
+		---------------------------------------------------------------------*/
+		void runConcurrentBatches();
+
+		/*---------------------------------------------------------------------
+			Interns the event type name, storing it in the name map the first
+			time it is seen. Returns false if the name collides with another
+			name already interned to the same id.
+		---------------------------------------------------------------------*/
+		bool internEventType(const string &eventType, EventTypeId &outEventTypeId);
 
 		// private constructor, use create
 		explicit EventManager(unique_ptr<EventSnooper> &es);
 
 	public:
+		/*---------------------------------------------------------------------
+			Creates an event of type TEvent, forwarding args to its
+			constructor. The event and its control block are allocated
+			together from the calling thread's event pool, and may be
+			released on any thread. Use this instead of new for all events.
+		---------------------------------------------------------------------*/
+		template <typename TEvent, typename... Args>
+		static shared_ptr<TEvent> make(Args&&... args)
+		{
+			return std::allocate_shared<TEvent>(PoolAllocator<TEvent, SlabPool_Event>(), std::forward<Args>(args)...);
+		}
+
+		/*---------------------------------------------------------------------
+			Returns the event pool's allocation counters, summed over all
+			threads. Includes event queue nodes.
+		---------------------------------------------------------------------*/
+		static SlabPool::Stats getAllocStats() { return SlabPool::stats(SlabPool_Event); }
+
 		/*---------------------------------------------------------------------
 			Add event to the queue, queue is processed each frame
 		---------------------------------------------------------------------*/
 		void raise(const EventPtr &ePtr);
 
+		/*---------------------------------------------------------------------
+			Raise an event once it is due, at a Timer::queryCounts() time or
+			after a delay. Due events are raised at the start of the first
+			notifyQueued call at or after their time, to 1ms resolution, and
+			are then handled with that frame's queue. Returns an id for
+			cancelScheduled, or 0 if the event type isn't registered.
+		---------------------------------------------------------------------*/
+		ScheduledEventId raiseAt(int64_t counts, const EventPtr &ePtr);
+		ScheduledEventId raiseAfter(double delayMillis, const EventPtr &ePtr);
+
+		/*---------------------------------------------------------------------
+			Cancels an event scheduled by raiseAt or raiseAfter that hasn't
+			been raised yet. Returns false if the id is unknown, already
+			raised or already cancelled.
+		---------------------------------------------------------------------*/
+		bool cancelScheduled(ScheduledEventId id);
+
+		/*---------------------------------------------------------------------
+			Number of scheduled events waiting to be raised
+		---------------------------------------------------------------------*/
+		size_t numScheduled() const { return m_pendingScheduled.size(); }
+
 		/*---------------------------------------------------------------------
 			Add a no-data event to the queue, queue is processed each frame.
 			This cannot be used to trigger events where the registered type
 			specifies "EventData_NotEmpty".
 		---------------------------------------------------------------------*/
 		void raise(const string &eventType);
+		void raise(EventTypeId eventTypeId);
 
 		/*---------------------------------------------------------------------
 			Invoke listeners immediately, does not queue the event
@@ -135,55 +426,180 @@ class EventManager {
 			specifies "EventData_NotEmpty".
 		---------------------------------------------------------------------*/
 		void trigger(const string &eventType);
+		void trigger(EventTypeId eventTypeId);
 
 		/*---------------------------------------------------------------------
-			Run through the queue and notify listeners, then purge the queue
+			Run through the queue and notify listeners, then purge the queue.
+			Events are handled by priority class, High first. If maxMillis >
+			0, Normal and Low events left when the budget runs out roll over
+			to the next frame ahead of newly raised events.
 		---------------------------------------------------------------------*/
 		void notifyQueued(uint32_t maxMillis);
 
+		/*---------------------------------------------------------------------
+			Event pump statistics, see EventPumpStats
+		---------------------------------------------------------------------*/
+		const EventPumpStats &	getPumpStats() const { return m_pumpStats; }
+		void					resetPumpStats();
+		void					logPumpStats() const;
+
+		/*---------------------------------------------------------------------
+			Sets how many frames a rolled over event waits before it moves up
+			a priority class, minimum 1
+		---------------------------------------------------------------------*/
+		void setPromoteAfterRollovers(uint8_t frames) { m_promoteAfterRollovers = (frames > 0 ? frames : 1); }
+
 		/*---------------------------------------------------------------------
 			Registers an event type so that it may be triggered or raised. The
 			RegisteredEvent implementation will determine if the event can be
-			triggered from script or just code. Returns true if registration
+			triggered from script or just code. priority sets the class queued
+			events of this type are handled in. Returns true if registration
 			is successful.
 		---------------------------------------------------------------------*/
-		bool registerEventType(const string &eventType, const RegEventPtr &regPtr);
+		bool registerEventType(const string &eventType, const RegEventPtr &regPtr,
+							   EventPriority priority = EventPriority_Normal);
+
+		/*---------------------------------------------------------------------
+			Sets the coalescing policy of a registered event type, see
+			EventCoalescing. EventCoalescing_Accumulate requires a merge
+			function. Returns false if the type isn't registered.
+		---------------------------------------------------------------------*/
+		bool setEventCoalescing(EventTypeId eventTypeId, EventCoalescing coalescing, EventMergeFunc merge = 0);
+		bool setEventCoalescing(const string &eventType, EventCoalescing coalescing, EventMergeFunc merge = 0)
+		{
+			return setEventCoalescing(eventTypeIdOf(eventType), coalescing, merge);
+		}
 
 		/*---------------------------------------------------------------------
 			Returns a shared ptr to RegisteredEvent metadata for an event type
 		---------------------------------------------------------------------*/
-		RegEventPtr getRegEventPtr(const string &eventType) const
+		RegEventPtr getRegEventPtr(EventTypeId eventTypeId) const
 		{
-			RegEventMap::const_iterator ri = m_regEventMap.find(eventType);
+			RegEventMap::const_iterator ri = m_regEventMap.find(eventTypeId);
 			if (ri != m_regEventMap.end()) return RegEventPtr(ri->second);
 			return RegEventPtr(); // return a null internal pointer if not found
 		}
+		RegEventPtr getRegEventPtr(const string &eventType) const { return getRegEventPtr(eventTypeIdOf(eventType)); }
 
 		/*---------------------------------------------------------------------
 			Returns true if event type has already been registered in the
 			RegisteredEvent table (doesn't care about listener table)
 		---------------------------------------------------------------------*/
-		bool isEventTypeRegistered(const string &eventType) const { return (m_regEventMap.find(eventType) != m_regEventMap.end()); }
+		bool isEventTypeRegistered(EventTypeId eventTypeId) const { return (m_regEventMap.find(eventTypeId) != m_regEventMap.end()); }
+		bool isEventTypeRegistered(const string &eventType) const { return isEventTypeRegistered(eventTypeIdOf(eventType)); }
+
+		/*---------------------------------------------------------------------
+			Returns the typed channel of an event type registered with
+			TypedCodeOnlyEvent<TEvent>, or null if it wasn't. The channel
+			lives as long as the manager, so callers can keep the pointer.
+		---------------------------------------------------------------------*/
+		template <typename TEvent>
+		EventChannel<TEvent> * channel() const
+		{
+			EventChannelMap::const_iterator ci = m_eventChannelMap.find(TEvent::sEventTypeId);
+			if (ci != m_eventChannelMap.end()) return static_cast<EventChannel<TEvent> *>(ci->second.get());
+			debugPrintf("EventMgr: event type \"%s\" has no typed channel\n", TEvent::sEventType.c_str());
+			return 0;
+		}
+
+		/*---------------------------------------------------------------------
+			Returns the name an event type id was interned from, or an empty
+			string if the id has never been seen
+		---------------------------------------------------------------------*/
+		const string & getEventTypeName(EventTypeId eventTypeId) const;
 		
 		/*---------------------------------------------------------------------
 			Returns true if added, false if already exists, with priority
-			(1 is highest priority, 0 is no priority or FIFO order).
-			If event type does not exist it is added. An O(n) operation since
-			it traverses the existing list for duplicates.
+			(1 is highest priority, 0 is no priority or FIFO order) and
+			concurrency class, see ListenerConcurrency. Returns false if the
+			listener is subscribed to any subject of the type.
+			If event type does not exist it is added. Safe to call from a
+			handler, the listener is first notified on the next dispatch.
 		---------------------------------------------------------------------*/
-		bool registerListener(const string &eventType, EventListener *lPtr, uint32_t priority = 0);
+		bool registerListener(const string &eventType, EventListener *lPtr, uint32_t priority = 0,
+							  ListenerConcurrency concurrency = ListenerConcurrency_Exclusive);
 		
 		/*---------------------------------------------------------------------
 			Removes a listener from an event type, if event type has no
-			more listeners it is removed
+			more listeners it is removed. Safe to call from a handler,
+			including for the listener being notified.
+		---------------------------------------------------------------------*/
+		bool removeListener(EventTypeId eventTypeId, EventListener *lPtr);
+		bool removeListener(const string &eventType, EventListener *lPtr) { return removeListener(eventTypeIdOf(eventType), lPtr); }
+
+		/*---------------------------------------------------------------------
+			Subscribes a listener to the events of one subject of a type,
+			see Event::subject. The listener is notified of events whose
+			subject matches, in priority order with the type's other
+			listeners, and may consume them. A listener subscribes to a type
+			either type-wide or per subject, not both, and may hold any
+			number of subjects. Returns false if already subscribed to the
+			subject or registered type-wide. Safe to call from a handler.
+		---------------------------------------------------------------------*/
+		bool registerListener(const string &eventType, uint32_t subject, EventListener *lPtr, uint32_t priority = 0,
+							  ListenerConcurrency concurrency = ListenerConcurrency_Exclusive);
+
+		/*---------------------------------------------------------------------
+			Removes a listener's subscription to one subject. Safe to call
+			from a handler.
+		---------------------------------------------------------------------*/
+		bool removeListener(EventTypeId eventTypeId, uint32_t subject, EventListener *lPtr);
+
+		/*---------------------------------------------------------------------
+			Moves a listener's metrics for an event type to the retired
+			list, done by removeListener for type-wide listeners. Subject
+			listeners call this once they have dropped all their subjects
+			of the type, so subject churn doesn't split their metrics.
+		---------------------------------------------------------------------*/
+		void retireListenerMetrics(EventTypeId eventTypeId, EventListener *lPtr);
+
+		/*---------------------------------------------------------------------
+			Installs an EventRecorder to record the events raised and
+			triggered outside of listeners, pass null to stop recording
+		---------------------------------------------------------------------*/
+		void setRecorder(const shared_ptr<EventRecorder> &recorder) { m_recorder = recorder; }
+		const shared_ptr<EventRecorder> & getRecorder() const { return m_recorder; }
+
+		/*---------------------------------------------------------------------
+			Shares a JobSystem to run concurrent listeners on, otherwise one
+			is created when the first concurrent listener is registered.
+			Set it before registering listeners.
+		---------------------------------------------------------------------*/
+		void setJobSystem(const shared_ptr<JobSystem> &jobSystem) { m_jobSystem = jobSystem; }
+		const shared_ptr<JobSystem> & getJobSystem() const { return m_jobSystem; }
+
+		/*---------------------------------------------------------------------
+			Turns the EventMetrics instrumentation on or off. getMetrics
+			returns null while disabled. dumpMetrics writes the metrics
+			report, returns false if disabled or the file can't be written.
+		---------------------------------------------------------------------*/
+		void			enableMetrics(bool enable);
+		EventMetrics *	getMetrics() const { return m_metrics.get(); }
+		bool			dumpMetrics(const string &filename) const;
+
+		/*---------------------------------------------------------------------
+			Recreates an event of a registered type from a recorded payload,
+			for replay. Empty events are created directly, others through the
+			registration's deserialize. Returns null if the type isn't
+			registered or can't be replayed.
+		---------------------------------------------------------------------*/
+		EventPtr deserializeEvent(EventTypeId eventTypeId, BinaryReader &in) const;
+
+		/*---------------------------------------------------------------------
+			Recreates a remote event of a registered type from its packed
+			payload in a received packet, see RemoteEventLink. Empty events
+			are created directly, others through the registration's
+			readRemote. Returns null if the type isn't registered as remote
+			callable or the payload is truncated.
 		---------------------------------------------------------------------*/
-		bool removeListener(const string &eventType, EventListener *lPtr);
+		EventPtr readRemoteEvent(EventTypeId eventTypeId, BitReader &in, int targetClientId) const;
 
 		/*---------------------------------------------------------------------
 			Multithread safe raise methods
 		---------------------------------------------------------------------*/
 		void raiseThreadSafe(const EventPtr &ePtr);
 		void raiseThreadSafe(const string &eventType);
+		void raiseThreadSafe(EventTypeId eventTypeId);
 
 		// Constructor / Destructor
 		static shared_ptr<EventManager> create(unique_ptr<EventSnooper> &es);
@@ -0,0 +1,174 @@
+/* EventMetrics.cpp
+Author: Jeff Kiah
+Orig.Date: 10/17/2026
+*/
+
+#include "EventMetrics.h"
+#include "EventManager.h"
+#include "Application/Timer.h"
+#include "Utility/Debug.h"
+#include <algorithm>
+#include <cstdio>
+
+////////// class EventMetrics //////////
+
+void EventMetrics::recordDispatch(EventTypeId eventTypeId, int64_t counts, bool consumed)
+{
+	TypeMetrics &tm = mTypes[eventTypeId];
+	++tm.dispatched;
+	if (consumed) { ++tm.consumed; }
+	tm.dispatchCounts.record(counts > 0 ? counts : 0);
+}
+
+void EventMetrics::recordHandler(const EventListener &listener, EventTypeId eventTypeId, int64_t counts, bool consumed)
+{
+	ListenerTypeMap &types = mListeners[&listener];
+	ListenerTypeMap::iterator li = types.find(eventTypeId);
+	if (li == types.end()) {
+		li = types.insert(ListenerTypeMap::value_type(eventTypeId, ListenerMetrics())).first;
+		li->second.listenerName = listener.name();
+		li->second.eventTypeId = eventTypeId;
+	}
+	ListenerMetrics &lm = li->second;
+	if (consumed) { ++lm.consumed; }
+	lm.handlerCounts.record(counts > 0 ? counts : 0);
+}
+
+void EventMetrics::retireListener(const EventListener *listener, EventTypeId eventTypeId)
+{
+	ListenerMetricsMap::iterator mi = mListeners.find(listener);
+	if (mi == mListeners.end()) { return; }
+
+	// wildcard listeners are recorded under the types of the events they saw, so retire them all
+	ListenerTypeMap &types = mi->second;
+	if (eventTypeId == EventListener::sWildcardTypeId) {
+		ListenerTypeMap::const_iterator ti, end = types.end();
+		for (ti = types.begin(); ti != end; ++ti) {
+			mRetired.push_back(ti->second);
+		}
+		types.clear();
+	} else {
+		ListenerTypeMap::iterator ti = types.find(eventTypeId);
+		if (ti != types.end()) {
+			mRetired.push_back(ti->second);
+			types.erase(ti);
+		}
+	}
+	if (types.empty()) {
+		mListeners.erase(mi);
+	}
+}
+
+const EventMetrics::TypeMetrics * EventMetrics::getTypeMetrics(EventTypeId eventTypeId) const
+{
+	TypeMetricsMap::const_iterator ti = mTypes.find(eventTypeId);
+	return (ti != mTypes.end() ? &ti->second : 0);
+}
+
+const EventMetrics::ListenerMetrics * EventMetrics::getListenerMetrics(const EventListener *listener, EventTypeId eventTypeId) const
+{
+	ListenerMetricsMap::const_iterator mi = mListeners.find(listener);
+	if (mi == mListeners.end()) { return 0; }
+	ListenerTypeMap::const_iterator ti = mi->second.find(eventTypeId);
+	return (ti != mi->second.end() ? &ti->second : 0);
+}
+
+vector<const EventMetrics::ListenerMetrics *> EventMetrics::getCostliestListeners(size_t maxResults) const
+{
+	vector<const ListenerMetrics *> results;
+	ListenerMetricsMap::const_iterator mi, mend = mListeners.end();
+	for (mi = mListeners.begin(); mi != mend; ++mi) {
+		ListenerTypeMap::const_iterator ti, tend = mi->second.end();
+		for (ti = mi->second.begin(); ti != tend; ++ti) {
+			results.push_back(&ti->second);
+		}
+	}
+	for (size_t r = 0; r < mRetired.size(); ++r) {
+		results.push_back(&mRetired[r]);
+	}
+
+	std::sort(results.begin(), results.end(),
+		[](const ListenerMetrics *a, const ListenerMetrics *b) {
+			return a->handlerCounts.total() > b->handlerCounts.total();
+		});
+	if (results.size() > maxResults) {
+		results.resize(maxResults);
+	}
+	return results;
+}
+
+bool EventMetrics::dump(const string &filename, const EventManager &eventMgr) const
+{
+	FILE *file = fopen(filename.c_str(), "w");
+	if (!file) {
+		debugPrintf("EventMetrics: could not open \"%s\" for writing\n", filename.c_str());
+		return false;
+	}
+	const double usPerCount = Timer::secondsPerCount() * 1000000.0;
+	const double seconds = Timer::secondsSince(mStartCounts);
+
+	fprintf(file, "Event metrics over %.2f seconds\n\n", seconds);
+	fprintf(file, "Queue depth per notifyQueued: frames %llu, mean %.1f, p50 %llu, p99 %llu, max %llu\n\n",
+			mQueueDepth.count(), mQueueDepth.mean(), mQueueDepth.percentile(50.0),
+			mQueueDepth.percentile(99.0), mQueueDepth.maxValue());
+
+	// event types, most total dispatch time first
+	vector<pair<EventTypeId, const TypeMetrics *> > types;
+	TypeMetricsMap::const_iterator ti, tend = mTypes.end();
+	for (ti = mTypes.begin(); ti != tend; ++ti) {
+		types.push_back(std::make_pair(ti->first, &ti->second));
+	}
+	std::sort(types.begin(), types.end(),
+		[](const pair<EventTypeId, const TypeMetrics *> &a, const pair<EventTypeId, const TypeMetrics *> &b) {
+			return a.second->dispatchCounts.total() > b.second->dispatchCounts.total();
+		});
+
+	fprintf(file, "%-32s %10s %10s %10s %8s %10s %10s %10s %10s %12s\n", "event type", "raised", "triggered",
+			"dispatched", "consume%", "p50 us", "p99 us", "max us", "mean us", "total ms");
+	for (size_t t = 0; t < types.size(); ++t) {
+		const TypeMetrics &tm = *types[t].second;
+		const LatencyHistogram &h = tm.dispatchCounts;
+		fprintf(file, "%-32s %10llu %10llu %10llu %8.1f %10.2f %10.2f %10.2f %10.2f %12.3f\n",
+				eventMgr.getEventTypeName(types[t].first).c_str(), tm.raised, tm.triggered, tm.dispatched,
+				(tm.dispatched > 0 ? 100.0 * tm.consumed / tm.dispatched : 0.0),
+				h.percentile(50.0) * usPerCount, h.percentile(99.0) * usPerCount, h.maxValue() * usPerCount,
+				h.mean() * usPerCount, h.total() * usPerCount * 0.001);
+	}
+
+	// listeners, most total handler time first
+	vector<const ListenerMetrics *> listeners(getCostliestListeners(SIZE_MAX));
+	fprintf(file, "\n%-32s %-32s %10s %8s %10s %10s %10s %10s %12s\n", "listener", "event type", "calls",
+			"consume%", "p50 us", "p99 us", "max us", "mean us", "total ms");
+	for (size_t l = 0; l < listeners.size(); ++l) {
+		const ListenerMetrics &lm = *listeners[l];
+		const LatencyHistogram &h = lm.handlerCounts;
+		fprintf(file, "%-32s %-32s %10llu %8.1f %10.2f %10.2f %10.2f %10.2f %12.3f\n",
+				lm.listenerName.c_str(), eventMgr.getEventTypeName(lm.eventTypeId).c_str(), h.count(),
+				(h.count() > 0 ? 100.0 * lm.consumed / h.count() : 0.0),
+				h.percentile(50.0) * usPerCount, h.percentile(99.0) * usPerCount, h.maxValue() * usPerCount,
+				h.mean() * usPerCount, h.total() * usPerCount * 0.001);
+	}
+
+	bool ok = (ferror(file) == 0);
+	fclose(file);
+	if (!ok) {
+		debugPrintf("EventMetrics: failed writing \"%s\"\n", filename.c_str());
+		return false;
+	}
+	debugPrintf("EventMetrics: wrote %u event types and %u listeners to \"%s\"\n",
+				(uint32_t)types.size(), (uint32_t)listeners.size(), filename.c_str());
+	return true;
+}
+
+void EventMetrics::reset()
+{
+	mTypes.clear();
+	mListeners.clear();
+	mRetired.clear();
+	mQueueDepth.reset();
+	mStartCounts = Timer::queryCounts();
+}
+
+EventMetrics::EventMetrics() :
+	mStartCounts(Timer::queryCounts())
+{}
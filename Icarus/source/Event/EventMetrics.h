@@ -0,0 +1,109 @@
+/* EventMetrics.h
+Author: Jeff Kiah
+Orig.Date: 10/17/2026
+*/
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <hash_map>
+#include <boost/noncopyable.hpp>
+#include "Event.h"
+#include "Utility/LatencyHistogram.h"
+
+using std::string;
+using std::vector;
+using std::hash_map;
+
+class EventManager;
+class EventListener;
+
+///// STRUCTURES /////
+
+/*=============================================================================
+class EventMetrics
+	Optional instrumentation of the EventManager, created by
+	EventManager::enableMetrics. While enabled, the manager counts every
+	event raised and triggered per type, times each dispatch and each
+	listener's handler call into LatencyHistograms, tracks how often
+	handlers consume, and samples the queue depth once per notifyQueued.
+	Times are in Timer counts, converted to microseconds in the report.
+	When disabled the manager holds no metrics object and the only cost is
+	a null check per dispatch and handler call.
+	All recording happens on the main thread. Concurrent listener timings
+	are collected in their batches and recorded after the batches finish.
+=============================================================================*/
+class EventMetrics : private boost::noncopyable {
+	public:
+		///// DEFINITIONS /////
+		struct TypeMetrics {
+			uint64_t			raised;
+			uint64_t			triggered;
+			uint64_t			dispatched;		// raised events handled plus triggered events
+			uint64_t			consumed;		// dispatches stopped by a consuming handler
+			LatencyHistogram	dispatchCounts;	// time to run all handlers for one event
+			TypeMetrics() : raised(0), triggered(0), dispatched(0), consumed(0) {}
+		};
+
+		struct ListenerMetrics {
+			string				listenerName;
+			EventTypeId			eventTypeId;
+			uint64_t			consumed;
+			LatencyHistogram	handlerCounts;	// time per handler call, count() is the number of calls
+			ListenerMetrics() : eventTypeId(0), consumed(0) {}
+		};
+
+	private:
+		typedef hash_map<EventTypeId, TypeMetrics>			TypeMetricsMap;
+		typedef hash_map<EventTypeId, ListenerMetrics>		ListenerTypeMap;
+		typedef hash_map<const EventListener*, ListenerTypeMap> ListenerMetricsMap;
+
+		///// VARIABLES /////
+		TypeMetricsMap			mTypes;
+		ListenerMetricsMap		mListeners;		// keyed by live listener, then event type
+		vector<ListenerMetrics>	mRetired;		// metrics of listeners since removed, kept for the report
+		LatencyHistogram		mQueueDepth;	// queued events at the start of each notifyQueued
+		int64_t					mStartCounts;
+
+	public:
+		/*---------------------------------------------------------------------
+			Recording, called by the EventManager
+		---------------------------------------------------------------------*/
+		void countRaised(EventTypeId eventTypeId)		{ ++mTypes[eventTypeId].raised; }
+		void countTriggered(EventTypeId eventTypeId)	{ ++mTypes[eventTypeId].triggered; }
+		void recordDispatch(EventTypeId eventTypeId, int64_t counts, bool consumed);
+		void recordHandler(const EventListener &listener, EventTypeId eventTypeId, int64_t counts, bool consumed);
+		void recordQueueDepth(size_t depth)				{ mQueueDepth.record(depth); }
+
+		/*---------------------------------------------------------------------
+			Moves a removed listener's metrics for an event type out of the
+			live table, so a new listener at the same address starts fresh.
+			The wildcard type retires all of the listener's metrics.
+		---------------------------------------------------------------------*/
+		void retireListener(const EventListener *listener, EventTypeId eventTypeId);
+
+		/*---------------------------------------------------------------------
+			Queries. Returned pointers are valid until the next record call.
+		---------------------------------------------------------------------*/
+		const TypeMetrics *		getTypeMetrics(EventTypeId eventTypeId) const;
+		const ListenerMetrics *	getListenerMetrics(const EventListener *listener, EventTypeId eventTypeId) const;
+		const LatencyHistogram & getQueueDepth() const { return mQueueDepth; }
+
+		/*---------------------------------------------------------------------
+			Returns up to maxResults listener entries, live and retired, with
+			the most total handler time first
+		---------------------------------------------------------------------*/
+		vector<const ListenerMetrics *> getCostliestListeners(size_t maxResults) const;
+
+		/*---------------------------------------------------------------------
+			Writes a text report of all metrics, event type names are looked
+			up in eventMgr. Returns false if the file could not be written.
+		---------------------------------------------------------------------*/
+		bool dump(const string &filename, const EventManager &eventMgr) const;
+
+		void reset();
+
+		// Constructor
+		explicit EventMetrics();
+};
@@ -0,0 +1,197 @@
+/* EventRecorder.cpp
+Author: Jeff Kiah
+Orig.Date: 10/17/2026
+*/
+
+#include "EventRecorder.h"
+#include "EventManager.h"
+#include "Application/Timer.h"
+#include "Utility/BinaryStream.h"
+#include "Utility/Debug.h"
+#include <fstream>
+
+////////// class EventRecorder //////////
+
+void EventRecorder::record(const Event &e, EventState how)
+{
+	if (!mRecording) { return; }
+
+	mScratch.clear();
+	BinaryWriter payloadWriter(mScratch);
+	e.serialize(payloadWriter);
+
+	EventRecordHeader header;
+	header.payloadSize = static_cast<uint32_t>(mScratch.size());
+	header.typeId = e.typeId();
+	header.time = e.time();
+	header.state = static_cast<uint8_t>(how);
+
+	const size_t recordSize = sizeof(EventRecordHeader) + mScratch.size();
+	if (recordSize > mChunkSize) {
+		debugPrintf("EventRecorder: \"%s\" payload of %u bytes is larger than a chunk, not recorded\n",
+					e.type().c_str(), header.payloadSize);
+		++mNumDropped;
+		return;
+	}
+
+	// start a new chunk if this record doesn't fit, recycling the oldest when the ring is full
+	if (mChunks.empty() || mChunks.back().mData.size() + recordSize > mChunkSize) {
+		vector<uint8_t> data;
+		if (mChunks.size() >= mMaxChunks) {
+			mNumDropped += mChunks.front().mNumRecords;
+			data.swap(mChunks.front().mData); // keep the capacity
+			data.clear();
+			mChunks.pop_front();
+		} else {
+			data.reserve(mChunkSize);
+		}
+		mChunks.push_back(Chunk());
+		mChunks.back().mData.swap(data);
+	}
+
+	Chunk &chunk = mChunks.back();
+	BinaryWriter chunkWriter(chunk.mData);
+	chunkWriter.write(header);
+	chunkWriter.writeBytes(mScratch.empty() ? 0 : &mScratch[0], mScratch.size());
+	++chunk.mNumRecords;
+	++mNumRecorded;
+
+	mTypesSeen.insert(header.typeId);
+}
+
+bool EventRecorder::save(const string &filename, const EventManager &eventMgr) const
+{
+	std::ofstream file(filename.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!file) {
+		debugPrintf("EventRecorder: could not open \"%s\" for writing\n", filename.c_str());
+		return false;
+	}
+
+	vector<uint8_t> buffer;
+	BinaryWriter out(buffer);
+
+	EventTraceFileHeader header;
+	header.magic = EventTraceMagic;
+	header.version = EventTraceVersion;
+	header.timerFreq = Timer::timerFreq();
+	header.numNames = static_cast<uint32_t>(mTypesSeen.size());
+	header.numRecords = 0;
+	for (size_t c = 0; c < mChunks.size(); ++c) {
+		header.numRecords += mChunks[c].mNumRecords;
+	}
+	header.numDropped = mNumDropped;
+	out.write(header);
+
+	hash_set<EventTypeId>::const_iterator ti, end = mTypesSeen.end();
+	for (ti = mTypesSeen.begin(); ti != end; ++ti) {
+		out.write(*ti);
+		out.writeString(eventMgr.getEventTypeName(*ti));
+	}
+	file.write(reinterpret_cast<const char *>(&buffer[0]), buffer.size());
+
+	for (size_t c = 0; c < mChunks.size(); ++c) {
+		const vector<uint8_t> &data = mChunks[c].mData;
+		if (!data.empty()) {
+			file.write(reinterpret_cast<const char *>(&data[0]), data.size());
+		}
+	}
+
+	if (!file) {
+		debugPrintf("EventRecorder: failed writing \"%s\"\n", filename.c_str());
+		return false;
+	}
+	debugPrintf("EventRecorder: saved %u events to \"%s\", %llu dropped\n", header.numRecords, filename.c_str(), mNumDropped);
+	return true;
+}
+
+void EventRecorder::clear()
+{
+	mChunks.clear();
+	mTypesSeen.clear();
+	mNumRecorded = 0;
+	mNumDropped = 0;
+}
+
+EventRecorder::EventRecorder(size_t chunkSize, size_t maxChunks) :
+	mChunkSize(chunkSize),
+	mMaxChunks(maxChunks > 0 ? maxChunks : 1),
+	mNumRecorded(0),
+	mNumDropped(0),
+	mRecording(true)
+{
+	_ASSERTE(chunkSize > sizeof(EventRecordHeader));
+}
+
+////////// class EventTrace //////////
+
+bool EventTrace::load(const string &filename)
+{
+	mData.clear();
+	mRecords.clear();
+	mNames.clear();
+
+	std::ifstream file(filename.c_str(), std::ios::in | std::ios::binary | std::ios::ate);
+	if (!file) {
+		debugPrintf("EventTrace: could not open \"%s\"\n", filename.c_str());
+		return false;
+	}
+	std::streamoff fileSize = file.tellg();
+	file.seekg(0, std::ios::beg);
+	// tellg returns -1 on failure, check before sizing the buffer with it
+	if (fileSize <= 0) {
+		debugPrintf("EventTrace: could not read \"%s\"\n", filename.c_str());
+		return false;
+	}
+	mData.resize(static_cast<size_t>(fileSize));
+	if (!file.read(reinterpret_cast<char *>(&mData[0]), fileSize)) {
+		debugPrintf("EventTrace: could not read \"%s\"\n", filename.c_str());
+		mData.clear();
+		return false;
+	}
+
+	BinaryReader in(&mData[0], mData.size());
+	EventTraceFileHeader header;
+	in.read(header);
+	if (!in.ok() || header.magic != EventTraceMagic || header.version != EventTraceVersion) {
+		debugPrintf("EventTrace: \"%s\" is not a version %u event trace\n", filename.c_str(), EventTraceVersion);
+		return false;
+	}
+	mTimerFreq = (header.timerFreq > 0 ? header.timerFreq : 1);
+	mNumDropped = header.numDropped;
+
+	mNames.reserve(header.numNames);
+	for (uint32_t n = 0; n < header.numNames && in.ok(); ++n) {
+		EventTypeId typeId = 0;
+		string name;
+		in.read(typeId);
+		in.readString(name);
+		mNames.push_back(std::make_pair(typeId, name));
+	}
+
+	mRecords.reserve(header.numRecords);
+	for (uint32_t r = 0; r < header.numRecords && in.ok(); ++r) {
+		EventRecordHeader recHeader;
+		if (!in.read(recHeader) || recHeader.payloadSize > in.remaining()) { break; }
+		Record rec;
+		rec.typeId = recHeader.typeId;
+		rec.time = recHeader.time;
+		rec.state = static_cast<EventState>(recHeader.state);
+		rec.payload = mData.data() + in.position();
+		rec.payloadSize = recHeader.payloadSize;
+		mRecords.push_back(rec);
+		in.skip(rec.payloadSize);
+	}
+
+	if (mRecords.size() != header.numRecords) {
+		debugPrintf("EventTrace: \"%s\" is truncated, loaded %u of %u events\n", filename.c_str(),
+					(uint32_t)mRecords.size(), header.numRecords);
+	}
+	debugPrintf("EventTrace: loaded %u events from \"%s\"\n", (uint32_t)mRecords.size(), filename.c_str());
+	return !mRecords.empty();
+}
+
+double EventTrace::millisFromStart(size_t r) const
+{
+	_ASSERTE(r < mRecords.size());
+	return static_cast<double>(mRecords[r].time - mRecords[0].time) * 1000.0 / static_cast<double>(mTimerFreq);
+}
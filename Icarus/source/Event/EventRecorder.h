@@ -0,0 +1,169 @@
+/* EventRecorder.h
+Author: Jeff Kiah
+Orig.Date: 10/17/2026
+*/
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <deque>
+#include <hash_set>
+#include <memory>
+#include <boost/noncopyable.hpp>
+#include "Event.h"
+
+using std::string;
+using std::vector;
+using std::deque;
+using stdext::hash_set;
+using std::shared_ptr;
+using std::pair;
+
+class EventManager;
+
+///// DEFINITIONS /////
+
+/*=============================================================================
+	Event trace file layout, all values little-endian:
+		EventTraceFileHeader
+		numNames x { EventTypeId, uint32_t length, chars }
+		numRecords x { EventRecordHeader, payloadSize bytes }
+	Records are in the order they were recorded, oldest first.
+=============================================================================*/
+#pragma pack(push, 1)
+struct EventTraceFileHeader {
+	uint32_t	magic;			// EventTraceMagic
+	uint32_t	version;		// EventTraceVersion
+	int64_t		timerFreq;		// Timer counts per second on the recording machine
+	uint32_t	numNames;		// entries in the event type name table
+	uint32_t	numRecords;
+	uint64_t	numDropped;		// records overwritten by the ring before saving
+};
+
+struct EventRecordHeader {
+	uint32_t	payloadSize;	// bytes following this header
+	EventTypeId	typeId;
+	int64_t		time;			// Event::time() in counts when raised or triggered
+	uint8_t		state;			// EventState_Raised or EventState_Triggered
+};
+#pragma pack(pop)
+
+enum : uint32_t {
+	EventTraceMagic		= 0x56454349,	// "ICEV"
+	EventTraceVersion	= 1
+};
+
+///// STRUCTURES /////
+
+/*=============================================================================
+class EventRecorder
+	Records the events raised or triggered through the EventManager into an
+	in-memory ring of fixed size chunks, for writing to a binary trace file
+	with save(). Each record is the event's type id, time, how it was fired
+	and its serialized payload. When the ring is full the oldest chunk is
+	recycled, so a recorder can be left running and saved after a hitch to
+	capture the events leading up to it. Recording copies the payload into
+	the current chunk and does no file IO or allocation in steady state.
+	Install with EventManager::setRecorder. Thread safe events are recorded
+	when notifyQueued dequeues them, so recording only happens on the main
+	thread. Events raised or triggered by a listener are not recorded,
+	since replaying the event that caused them fires them again.
+=============================================================================*/
+class EventRecorder : private boost::noncopyable {
+	private:
+		///// DEFINITIONS /////
+		struct Chunk {
+			vector<uint8_t>	mData;
+			uint32_t		mNumRecords;
+			Chunk() : mNumRecords(0) {}
+		};
+
+		///// VARIABLES /////
+		deque<Chunk>		mChunks;		// ring of chunks, back is being written
+		vector<uint8_t>		mScratch;		// payload serialization buffer, reused
+		hash_set<EventTypeId> mTypesSeen;	// types to write in the name table
+		size_t				mChunkSize;
+		size_t				mMaxChunks;
+		uint64_t			mNumRecorded;
+		uint64_t			mNumDropped;	// records lost when old chunks were recycled
+		bool				mRecording;
+
+	public:
+		/*---------------------------------------------------------------------
+			Records one event, called by the EventManager
+		---------------------------------------------------------------------*/
+		void record(const Event &e, EventState how);
+
+		/*---------------------------------------------------------------------
+			Writes the ring to a trace file, oldest record first. Type names
+			are looked up in eventMgr. Returns false if the file could not
+			be written.
+		---------------------------------------------------------------------*/
+		bool save(const string &filename, const EventManager &eventMgr) const;
+
+		/*---------------------------------------------------------------------
+			Discards all records
+		---------------------------------------------------------------------*/
+		void clear();
+
+		void		setRecording(bool recording)	{ mRecording = recording; }
+		bool		isRecording() const				{ return mRecording; }
+		uint64_t	numRecorded() const				{ return mNumRecorded; }
+		uint64_t	numDropped() const				{ return mNumDropped; }
+
+		// Constructor / destructor
+		/*---------------------------------------------------------------------
+			The ring holds up to chunkSize * maxChunks bytes of records,
+			default 16MB
+		---------------------------------------------------------------------*/
+		explicit EventRecorder(size_t chunkSize = 64 * 1024, size_t maxChunks = 256);
+		~EventRecorder() {}
+};
+
+typedef shared_ptr<EventRecorder>	EventRecorderPtr;
+
+/*=============================================================================
+class EventTrace
+	A trace file loaded into memory for replay. Records are indexed at load,
+	and each one's payload can be read back with a BinaryReader.
+=============================================================================*/
+class EventTrace : private boost::noncopyable {
+	public:
+		///// DEFINITIONS /////
+		struct Record {
+			EventTypeId		typeId;
+			int64_t			time;
+			EventState		state;
+			const uint8_t *	payload;
+			uint32_t		payloadSize;
+		};
+
+	private:
+		///// VARIABLES /////
+		vector<uint8_t>		mData;
+		vector<Record>		mRecords;
+		vector<pair<EventTypeId, string> > mNames;
+		int64_t				mTimerFreq;
+		uint64_t			mNumDropped;
+
+	public:
+		/*---------------------------------------------------------------------
+			Loads and validates a trace file, returns false on failure
+		---------------------------------------------------------------------*/
+		bool load(const string &filename);
+
+		const vector<Record> &	records() const		{ return mRecords; }
+		const vector<pair<EventTypeId, string> > & names() const { return mNames; }
+		uint64_t				numDropped() const	{ return mNumDropped; }
+
+		/*---------------------------------------------------------------------
+			Milliseconds from the first record to record r, on the recording
+			machine's timer
+		---------------------------------------------------------------------*/
+		double	millisFromStart(size_t r) const;
+
+		explicit EventTrace() : mTimerFreq(1), mNumDropped(0) {}
+};
+
+typedef shared_ptr<EventTrace>	EventTracePtr;
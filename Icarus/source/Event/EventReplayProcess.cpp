@@ -0,0 +1,92 @@
+/* EventReplayProcess.cpp
+Author: Jeff Kiah
+Orig.Date: 10/17/2026
+*/
+
+#include "EventReplayProcess.h"
+#include "Utility/BinaryStream.h"
+#include "Utility/Debug.h"
+
+////////// class EventReplayProcess //////////
+
+bool EventReplayProcess::replayRecord(const EventTrace::Record &rec)
+{
+	BinaryReader in(rec.payload, rec.payloadSize);
+	EventPtr ePtr(m_eventMgr->deserializeEvent(rec.typeId, in));
+	if (!ePtr) { return false; }
+
+	if (rec.state == EventState_Triggered) {
+		m_eventMgr->trigger(ePtr);
+	} else {
+		m_eventMgr->raise(ePtr);
+	}
+	return true;
+}
+
+void EventReplayProcess::onUpdate(double deltaMillis)
+{
+	const vector<EventTrace::Record> &records = m_trace->records();
+	if (mSpeed > 0.0) {
+		mClockMillis += deltaMillis * mSpeed;
+	}
+
+	while (mNextRecord < records.size() &&
+		   (mSpeed <= 0.0 || m_trace->millisFromStart(mNextRecord) <= mClockMillis))
+	{
+		const EventTrace::Record &rec = records[mNextRecord];
+		++mNextRecord;
+
+		// the type id is a hash of the name, make sure it still means the same event
+		const string &name = m_eventMgr->getEventTypeName(rec.typeId);
+		bool known = false;
+		const vector<pair<EventTypeId, string> > &names = m_trace->names();
+		for (size_t n = 0; n < names.size(); ++n) {
+			if (names[n].first == rec.typeId) {
+				known = (names[n].second == name);
+				break;
+			}
+		}
+
+		if (known && replayRecord(rec)) {
+			++mNumReplayed;
+		} else {
+			++mNumSkipped;
+		}
+	}
+
+	if (mNextRecord >= records.size()) {
+		finish();
+	}
+}
+
+bool EventReplayProcess::onInitialize()
+{
+	if (!m_eventMgr || !m_trace || m_trace->records().empty()) {
+		debugPrintf("%s: nothing to replay\n", name().c_str());
+		return false;
+	}
+	mClockMillis = 0.0;
+	mNextRecord = 0;
+	mNumReplayed = 0;
+	mNumSkipped = 0;
+	return true;
+}
+
+void EventReplayProcess::onFinish()
+{
+	debugPrintf("%s: replayed %u events, skipped %u\n", name().c_str(), mNumReplayed, mNumSkipped);
+}
+
+EventReplayProcess::EventReplayProcess(const string &name,
+									   const EventManagerPtr &eventMgr,
+									   const EventTracePtr &trace,
+									   double speed) :
+	Process(name, Process_Run_Frame),
+	m_eventMgr(eventMgr),
+	m_trace(trace),
+	mSpeed(speed),
+	mClockMillis(0.0),
+	mNextRecord(0),
+	mNumReplayed(0),
+	mNumSkipped(0)
+{}
@@ -0,0 +1,55 @@
+/* EventReplayProcess.h
+Author: Jeff Kiah
+Orig.Date: 10/17/2026
+*/
+#pragma once
+
+#include <string>
+#include "Process/Process.h"
+#include "EventManager.h"
+#include "EventRecorder.h"
+
+using std::string;
+
+///// STRUCTURES /////
+
+/*=============================================================================
+class EventReplayProcess
+	Feeds the events of a recorded EventTrace back into an EventManager,
+	raising or triggering each one as it was originally fired. Events are
+	released on the recorded timeline, scaled by speed: 1.0 replays at the
+	original pace, 2.0 at double speed, and 0 replays the whole trace on the
+	first update. Records of types that aren't registered under the same
+	name, or that fail to deserialize, are skipped and counted. The process
+	finishes when the end of the trace is reached.
+=============================================================================*/
+class EventReplayProcess : public Process {
+	private:
+		///// VARIABLES /////
+		EventManagerPtr		m_eventMgr;
+		EventTracePtr		m_trace;
+		double				mSpeed;
+		double				mClockMillis;	// replay time since the first record
+		size_t				mNextRecord;
+		uint32_t			mNumReplayed;
+		uint32_t			mNumSkipped;
+
+		///// FUNCTIONS /////
+		bool replayRecord(const EventTrace::Record &rec);
+
+		virtual void onUpdate(double deltaMillis);
+		virtual bool onInitialize();
+		virtual void onFinish();
+		virtual void onTogglePause() {}
+
+	public:
+		uint32_t	numReplayed() const	{ return mNumReplayed; }
+		uint32_t	numSkipped() const	{ return mNumSkipped; }
+
+		// Constructor / destructor
+		explicit EventReplayProcess(const string &name,
+									const EventManagerPtr &eventMgr,
+									const EventTracePtr &trace,
+									double speed = 1.0);
+		virtual ~EventReplayProcess() {}
+};
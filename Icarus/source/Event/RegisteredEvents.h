@@ -7,6 +7,7 @@
 #pragma once
 
 #include "Event/EventManager.h"
+#include "Event/WireFormat.h"
 #include "Utility/Debug.h"
 
 ///// STRUCTURES /////
@@ -18,12 +19,18 @@ class RegisteredEvent
 	or raised. They are registered using one of the derived types.
 =============================================================================*/
 class RegisteredEvent {
+	friend class EventManager;
 	private:
 		const EventSource		mEventSource;
 		const EventDataType		mEventDataType;
+		EventPriority			mEventPriority;
+		EventCoalescing			mEventCoalescing;
+		EventMergeFunc			mMergeFunc;
 
 	protected:
 		static EventManagerWeakPtr	sEventMgr;	// dependency injected from EventManager when it's created
+		ScriptDataSchemaPtr		mScriptSchema;	// layout of the type's script data, null if it carries none
+		WireSchemaPtr			mWireSchema;	// packing of the type's remote payload, null if it isn't sent remotely
 
 	public:
 		/*---------------------------------------------------------------------
@@ -31,6 +38,29 @@ class RegisteredEvent {
 		---------------------------------------------------------------------*/
 		virtual	bool triggerEventFromSource(const string &eventType, const AnyVars &eventData) const = 0;
 		virtual	bool raiseEventFromSource(const string &eventType, const AnyVars &eventData) const = 0;
+		/*---------------------------------------------------------------------
+			Called from the script manager for events triggered/raised from
+			script. eventData is laid out by getScriptSchema(). Only script
+			callable registrations override these.
+		---------------------------------------------------------------------*/
+		virtual bool triggerEventFromScript(const string &eventType, const ScriptData &eventData) const {
+			_ASSERTE(false && "Tried to trigger a non-script event from script");
+			return false;
+		}
+		virtual bool raiseEventFromScript(const string &eventType, const ScriptData &eventData) const {
+			_ASSERTE(false && "Tried to raise a non-script event from script");
+			return false;
+		}
+		/*---------------------------------------------------------------------
+			Schema of the script data for this event type, registered once
+			with the type. Null for types that carry no script data.
+		---------------------------------------------------------------------*/
+		const ScriptDataSchemaPtr &	getScriptSchema() const { return mScriptSchema; }
+		/*---------------------------------------------------------------------
+			Wire schema of the remote payload for this event type. Null for
+			types that aren't remote callable or carry no data.
+		---------------------------------------------------------------------*/
+		const WireSchemaPtr &	getWireSchema() const { return mWireSchema; }
 		/*---------------------------------------------------------------------
 			This is basically RTTI for this class hierarchy
 		---------------------------------------------------------------------*/
@@ -39,6 +69,23 @@ class RegisteredEvent {
 			Returns data type value
 		---------------------------------------------------------------------*/
 		const EventDataType	getEventDataType() const { return mEventDataType; }
+		/*---------------------------------------------------------------------
+			Priority class of queued events of this type, set by
+			EventManager::registerEventType
+		---------------------------------------------------------------------*/
+		EventPriority		getEventPriority() const { return mEventPriority; }
+		void				setEventPriority(EventPriority priority) { mEventPriority = priority; }
+		/*---------------------------------------------------------------------
+			Coalescing policy of queued events of this type, set by
+			EventManager::setEventCoalescing
+		---------------------------------------------------------------------*/
+		EventCoalescing		getEventCoalescing() const { return mEventCoalescing; }
+		EventMergeFunc		getMergeFunc() const { return mMergeFunc; }
+		void				setEventCoalescing(EventCoalescing coalescing, EventMergeFunc merge)
+		{
+			mEventCoalescing = coalescing;
+			mMergeFunc = merge;
+		}
 		/*---------------------------------------------------------------------
 			returns true if script is allowed to trigger this event type
 		---------------------------------------------------------------------*/
@@ -59,11 +106,32 @@ class RegisteredEvent {
 		bool isEmpty() const {
 			return (mEventDataType == EventDataType_Empty);
 		}
+		/*---------------------------------------------------------------------
+			Registrations that opt into a typed EventChannel return a new
+			channel here, the EventManager takes ownership when the type is
+			registered. All other registrations return null.
+		---------------------------------------------------------------------*/
+		virtual EventChannelPtr createChannel() const { return EventChannelPtr(); }
+		/*---------------------------------------------------------------------
+			Recreates a non-empty event from the payload written by its
+			serialize(), for event trace replay. Registrations that don't
+			support replay return null and the event is skipped.
+		---------------------------------------------------------------------*/
+		virtual EventPtr deserialize(BinaryReader &in) const { return EventPtr(); }
+		/*---------------------------------------------------------------------
+			Recreates a non-empty remote event from a payload packed by its
+			writeWire, straight out of the received packet. Only remote
+			callable registrations override this.
+		---------------------------------------------------------------------*/
+		virtual EventPtr readRemote(WireReader &in, int targetClientId) const { return EventPtr(); }
 
 		// Constructor / destructor
 		explicit RegisteredEvent(const EventSource src, const EventDataType dt) :
 			mEventSource(src),
-			mEventDataType(dt)
+			mEventDataType(dt),
+			mEventPriority(EventPriority_Normal),
+			mEventCoalescing(EventCoalescing_None),
+			mMergeFunc(0)
 		{}
 		virtual ~RegisteredEvent() {}
 };
@@ -96,82 +164,171 @@ class CodeOnlyEvent : public RegisteredEvent {
 		virtual ~CodeOnlyEvent() {}
 };
 
+/*=============================================================================
+class ReplayableCodeOnlyEvent
+	A code-only event that can be replayed from an event trace. TEvent must
+	override serialize() and provide a static EventPtr deserialize(BinaryReader &)
+	that reads the same payload back.
+=============================================================================*/
+template <typename TEvent>
+class ReplayableCodeOnlyEvent : public CodeOnlyEvent {
+	public:
+		virtual EventPtr deserialize(BinaryReader &in) const { return TEvent::deserialize(in); }
+
+		explicit ReplayableCodeOnlyEvent(const EventDataType dt) :
+			CodeOnlyEvent(dt)
+		{}
+		virtual ~ReplayableCodeOnlyEvent() {}
+};
+
+/*=============================================================================
+class TypedCodeOnlyEvent
+	A code-only event that opts into the statically typed EventChannel<TEvent>
+	path. Registering a type with this creates its channel, after which it is
+	raised and handled through EventManager::channel<TEvent>() rather than by
+	EventPtr. TEvent needs static sEventType and sEventTypeId members, and the
+	type should be registered with TEvent::sEventType as its name.
+=============================================================================*/
+template <typename TEvent>
+class TypedCodeOnlyEvent : public CodeOnlyEvent {
+	public:
+		virtual EventChannelPtr createChannel() const { return EventChannelPtr(new EventChannel<TEvent>()); }
+
+		explicit TypedCodeOnlyEvent() :
+			CodeOnlyEvent(EventDataType_NotEmpty)
+		{}
+		virtual ~TypedCodeOnlyEvent() {}
+};
+
 /*=============================================================================
 class ScriptCallableCodeEvent
 	This concrete registered event type is templated by any type of event that
 	needs to be called from script. triggerEventFromScript is called by the
 	script manager's trigger function (which is callable from script) and
-	returns true on success.
+	returns true on success. TEventType must derive from ScriptableEvent and
+	provide a static ScriptDataSchemaPtr sScriptSchema, which is registered
+	with the type.
 =============================================================================*/
 template <typename TEventType>
 class ScriptCallableCodeEvent : public RegisteredEvent {
 	public:
 		/*---------------------------------------------------------------------
-			Creates the event using the event's AnyVars constructor to pass in
-			event data. This implies that all script callable code-defined
-			event types must implement an AnyVars constructor. Then, calls
-			EventManager::trigger.
+			Creates the event using the event's ScriptData constructor to pass
+			in event data. This implies that all script callable code-defined
+			event types must implement a ScriptData constructor. Then, calls
+			EventManager::trigger or raise.
 		---------------------------------------------------------------------*/
-		virtual bool triggerEventFromSource(const string &eventType, const AnyVars &eventData) const {
-			if (isEmpty()) { // handle empty events as a special case, avoid calling the AnyVars constructor
+		virtual bool triggerEventFromScript(const string &eventType, const ScriptData &eventData) const {
+			if (isEmpty()) { // handle empty events as a special case, avoid calling the ScriptData constructor
 				sEventMgr.lock()->trigger(eventType);
 				return true;
-			} else { // for all non-empty events, call the AnyVars constructor
-				EventPtr ePtr(new TEventType(eventData)); // use the event type's AnyVars constructor
+			} else { // for all non-empty events, call the ScriptData constructor
+				_ASSERTE(eventData.schema() == mScriptSchema && "Script data built with the wrong schema");
+				EventPtr ePtr(EventManager::make<TEventType>(eventData)); // use the event type's ScriptData constructor
 				sEventMgr.lock()->trigger(ePtr);
 				return true;
 			}
 		}
-		virtual bool raiseEventFromSource(const string &eventType, const AnyVars &eventData) const {
+		virtual bool raiseEventFromScript(const string &eventType, const ScriptData &eventData) const {
 			if (isEmpty()) {
 				sEventMgr.lock()->raise(eventType);
 				return true;
 			} else {
-				EventPtr ePtr(new TEventType(eventData));
+				_ASSERTE(eventData.schema() == mScriptSchema && "Script data built with the wrong schema");
+				EventPtr ePtr(EventManager::make<TEventType>(eventData));
 				sEventMgr.lock()->raise(ePtr);
 				return true;
 			}
 		}
+		/*---------------------------------------------------------------------
+			Legacy AnyVars path, the named values are copied into a blob by
+			field name and then handled as if fired from script
+		---------------------------------------------------------------------*/
+		virtual bool triggerEventFromSource(const string &eventType, const AnyVars &eventData) const {
+			ScriptData data(isEmpty() ? ScriptDataSchemaPtr() : mScriptSchema);
+			data.assign(eventData);
+			return triggerEventFromScript(eventType, data);
+		}
+		virtual bool raiseEventFromSource(const string &eventType, const AnyVars &eventData) const {
+			ScriptData data(isEmpty() ? ScriptDataSchemaPtr() : mScriptSchema);
+			data.assign(eventData);
+			return raiseEventFromScript(eventType, data);
+		}
 
 		/*---------------------------------------------------------------------
 			Construct this object as a script callable code event
 		---------------------------------------------------------------------*/
 		explicit ScriptCallableCodeEvent(const EventDataType dt) :
 			RegisteredEvent(EventSource_CodeAndScript, dt)
-		{}
+		{
+			if (dt == EventDataType_NotEmpty) {
+				mScriptSchema = TEventType::sScriptSchema;
+			}
+		}
 		virtual ~ScriptCallableCodeEvent() {}
 };
 
+/*=============================================================================
+class ReplayableScriptCallableCodeEvent
+	A script callable code event that can also be replayed from an event
+	trace, TEventType provides serialize() and a static deserialize as for
+	ReplayableCodeOnlyEvent.
+=============================================================================*/
+template <typename TEventType>
+class ReplayableScriptCallableCodeEvent : public ScriptCallableCodeEvent<TEventType> {
+	public:
+		virtual EventPtr deserialize(BinaryReader &in) const { return TEventType::deserialize(in); }
+
+		explicit ReplayableScriptCallableCodeEvent(const EventDataType dt) :
+			ScriptCallableCodeEvent<TEventType>(dt)
+		{}
+		virtual ~ReplayableScriptCallableCodeEvent() {}
+};
+
 /*=============================================================================
 class ScriptDefinedEvent
 	This concrete registered event type is defined in script, and will not have
 	any listeners in code. It is not neccesary to translate data to and from
-	native types to script objects, so this is basically a pass-through.
+	native types to script objects, so this is basically a pass-through. The
+	schema given at registration lays out the data script passes with the
+	event, a type registered without one passes no data.
 =============================================================================*/
 class ScriptDefinedEvent : public RegisteredEvent {
 	public:
 		/*---------------------------------------------------------------------
-			Creates a ScriptEvent, passing any data through the srcData
+			Creates a ScriptEvent, passing any data through the eventData
 			parameter. Then, calls EventManager::trigger or raise.
 		---------------------------------------------------------------------*/
-		virtual bool triggerEventFromSource(const string &eventType, const AnyVars &eventData) const {
-			EventPtr ePtr(new ScriptEvent(eventType, eventData));
+		virtual bool triggerEventFromScript(const string &eventType, const ScriptData &eventData) const {
+			EventPtr ePtr(EventManager::make<ScriptEvent>(ScriptEvent::Key(), eventType, eventData));
 			sEventMgr.lock()->trigger(ePtr);
 			return true;
 		}
-		virtual bool raiseEventFromSource(const string &eventType, const AnyVars &eventData) const {
-			EventPtr ePtr(new ScriptEvent(eventType, eventData));
+		virtual bool raiseEventFromScript(const string &eventType, const ScriptData &eventData) const {
+			EventPtr ePtr(EventManager::make<ScriptEvent>(ScriptEvent::Key(), eventType, eventData));
 			sEventMgr.lock()->raise(ePtr);
 			return true;
 		}
+		virtual bool triggerEventFromSource(const string &eventType, const AnyVars &eventData) const {
+			ScriptData data(mScriptSchema);
+			data.assign(eventData);
+			return triggerEventFromScript(eventType, data);
+		}
+		virtual bool raiseEventFromSource(const string &eventType, const AnyVars &eventData) const {
+			ScriptData data(mScriptSchema);
+			data.assign(eventData);
+			return raiseEventFromScript(eventType, data);
+		}
 
 		/*---------------------------------------------------------------------
 			Construct this object as a script-only event. Script-defined events
 			are never considered empty, but they can choose to pass no data.
 		---------------------------------------------------------------------*/
-		explicit ScriptDefinedEvent() :
+		explicit ScriptDefinedEvent(const ScriptDataSchemaPtr &schema = ScriptDataSchemaPtr()) :
 			RegisteredEvent(EventSource_ScriptOnly, EventDataType_NotEmpty)
-		{}
+		{
+			mScriptSchema = schema;
+		}
 		virtual ~ScriptDefinedEvent() {}
 };
 
@@ -179,61 +336,70 @@ class ScriptDefinedEvent : public RegisteredEvent {
 class RemoteCallableEvent
 	This concrete registered event type is raised by a remote client and passed
 	to local listeners through a byte stream such as TCP or UDP networking,
-	file IO, or other communication methods.
+	file IO, or other communication methods. TEventType must derive from
+	RemoteEvent and provide a static WireSchemaPtr sWireSchema, which is
+	registered with the type, and a static readWire, see RemoteEvent.
 =============================================================================*/
-template <typename TEventType, class Archive>
+template <typename TEventType>
 class RemoteCallableEvent : public RegisteredEvent {
+	private:
+		/*---------------------------------------------------------------------
+			Reads the event from eventData, which holds the targetClientId as
+			an int followed by a BitReader * positioned at the payload
+		---------------------------------------------------------------------*/
+		EventPtr readFromSource(const string &eventType, const AnyVars &eventData) const {
+			if (eventData.size() < 2) {
+				debugPrintf("RemoteCallableEvent: \"%s\" needs a target client id and a BitReader\n", eventType.c_str());
+				return EventPtr();
+			}
+			AnyVars::const_iterator i = eventData.begin();
+			try {
+				int targetClientId = any_cast<int>(i->second);
+				++i;
+				BitReader &in = *(any_cast<BitReader*>(i->second));
+				WireReader wireIn(in, *mWireSchema);
+				EventPtr ePtr(readRemote(wireIn, targetClientId));
+				if (!in.ok()) {
+					debugPrintf("RemoteCallableEvent: \"%s\" payload is truncated\n", eventType.c_str());
+					return EventPtr();
+				}
+				return ePtr;
+
+			} catch (const boost::bad_any_cast &ex) {
+				// nothing happens with a bad datatype in release build, silently ignores
+				debugPrintf("RemoteCallableEvent: bad_any_cast \"%s\"\n", ex.what());
+			}
+			return EventPtr();
+		}
+
 	public:
+		virtual EventPtr readRemote(WireReader &in, int targetClientId) const {
+			return TEventType::readWire(in, targetClientId);
+		}
 		/*---------------------------------------------------------------------
-			Creates the Event, deserializing from the byte stream. Then, calls
+			Creates the Event, reading it from the byte stream. Then, calls
 			EventManager::trigger or raise. eventData should contain two items,
-			first in targetClientId, second pointer to the Archive.
+			first the targetClientId, second a pointer to the BitReader.
 		---------------------------------------------------------------------*/
 		virtual bool triggerEventFromSource(const string &eventType, const AnyVars &eventData) const {
-			if (isEmpty()) { // handle empty events as a special case, avoid calling deserialize
-				eventMgr.trigger(eventType);
+			if (isEmpty()) { // handle empty events as a special case, there is no payload
+				sEventMgr.lock()->trigger(eventType);
 				return true;
-			} else { // for all non-empty events, call deserialize after construction
-				AnyVars::const_iterator i = eventData.begin();
-				try {
-					int targetClientId = any_cast<int>(i->second);
-					EventPtr ePtr(new TEventType(targetClientId));
-					TEventType &e = *(static_cast<TEventType*>(ePtr.get()));
-					++i;
-					//ostream &os = *(any_cast<ostream*>(i->second));
-					//Archive archive(os);
-					Archive &archive = *(any_cast<Archive*>(i->second));
-					archive << e;
-					eventMgr.trigger(ePtr);
-
-				} catch (const boost::bad_any_cast &ex) {
-					// nothing happens with a bad datatype in release build, silently ignores
-					debugPrintf("RemoteCallableEvent: bad_any_cast \"%s\"\n", ex.what());
-				}
+			} else { // for all non-empty events, read the payload into a new event
+				EventPtr ePtr(readFromSource(eventType, eventData));
+				if (!ePtr) { return false; }
+				sEventMgr.lock()->trigger(ePtr);
 				return true;
 			}
 		}
 		virtual bool raiseEventFromSource(const string &eventType, const AnyVars &eventData) const {
 			if (isEmpty()) {
-				eventMgr.raise(eventType);
+				sEventMgr.lock()->raise(eventType);
 				return true;
 			} else {
-				AnyVars::const_iterator i = eventData.begin();
-				try {
-					int targetClientId = any_cast<int>(i->second);
-					EventPtr ePtr(new TEventType(targetClientId));
-					TEventType &e = *(static_cast<TEventType*>(ePtr.get()));
-					++i;
-					//ostream &os = *(any_cast<ostream*>(i->second));
-					//Archive archive(os);
-					Archive &archive = *(any_cast<Archive*>(i->second));
-					archive << e;
-					eventMgr.raise(ePtr);
-
-				} catch (const boost::bad_any_cast &ex) {
-					// nothing happens with a bad datatype in release build, silently ignores
-					debugPrintf("RemoteCallableEvent: bad_any_cast \"%s\"\n", ex.what());
-				}
+				EventPtr ePtr(readFromSource(eventType, eventData));
+				if (!ePtr) { return false; }
+				sEventMgr.lock()->raise(ePtr);
 				return true;
 			}
 		}
@@ -242,6 +408,10 @@ class RemoteCallableEvent : public RegisteredEvent {
 		---------------------------------------------------------------------*/
 		explicit RemoteCallableEvent(const EventDataType dt) :
 			RegisteredEvent(EventSource_Remote, dt)
-		{}
+		{
+			if (dt == EventDataType_NotEmpty) {
+				mWireSchema = TEventType::sWireSchema;
+			}
+		}
 		virtual ~RemoteCallableEvent() {}
-};
\ No newline at end of file
+};
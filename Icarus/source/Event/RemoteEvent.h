@@ -1,46 +1,35 @@
 /*----==== REMOTEEVENT.H ====----
 	Author: Jeffrey Kiah
 	Orig.Date: 11/17/2010
-	Rev.Date:  11/17/2010
+	Rev.Date:  10/17/2026
 -------------------------------*/
 
 #pragma once
 
-//#include <boost/archive/text_oarchive.hpp>
-//#include <boost/archive/text_iarchive.hpp>
-#include <boost/serialization/nvp.hpp>
-#include <boost/serialization/level.hpp>
-#include <boost/serialization/tracking.hpp>
-//#include "../Utility/Serialization.h" // using Boost.Serialization instead
 #include "Event.h"
+#include "WireFormat.h"
 
 /*=============================================================================
 class RemoteEvent
 	This is the base class for any event with a registered event type of
 	RemoteCallableEvent. If you don't intend for your event to be fired
-	remotely, just inherit from Event instead. This requires a new constructor
-	signature to be implemented in the derived class (const AnyVars &). For
-	this event type, the AnyVars list can be assumed to have a single member
-	that can be interpreted as an Archive type as described in Serialization.h.
+	remotely, just inherit from Event instead.
+	The payload is packed by a WireSchema rather than an archive. The derived
+	class keeps the schema in a static WireSchemaPtr sWireSchema member with
+	an enum of its field indices, overrides writeWire to write its fields in
+	order, and provides a static EventPtr readWire(WireReader &, int) that
+	reads them back in the same order and makes the event. The target client
+	id travels in the packet header, not the payload. See RemoteEventLink.
 =============================================================================*/
-class RemoteEvent : public Event {//, public ISerializable {
-	private:
-		// Boost.Serialization stuff
-		friend class boost::serialization::access;
-	    template<class Archive>
-		void serialize(Archive & ar, const unsigned int version)
-		{
-			//ar & type();
-			ar & BOOST_SERIALIZATION_NVP(mTargetClientId);
-		}
-
+class RemoteEvent : public Event {
 	protected:
 		int mTargetClientId; // unique id of the client being targeted, value of -1 used for broadcast to all clients
 
 	public:
-		// Derived implementations can call these base class functions if targetID is desired in byte stream
-		//virtual bool serialize(Archive &ar) const { ar << mTargetId; return true; }
-		//virtual bool deserialize(Archive &ar) { ar >> mTargetId; return true; }
+		/*---------------------------------------------------------------------
+			Writes the event's payload laid out by the type's wire schema
+		---------------------------------------------------------------------*/
+		virtual void writeWire(WireWriter &out) const {}
 
 		int targetClientId() const { return mTargetClientId; }
 		bool isBroadcast() const { return (mTargetClientId == -1); }
@@ -54,11 +43,3 @@ class RemoteEvent : public Event {//, public ISerializable {
 		{}
 		virtual ~RemoteEvent() {}
 };
-
-// elminate serialization overhead at the cost of
-// never being able to increase the version
-BOOST_CLASS_IMPLEMENTATION(RemoteEvent, boost::serialization::object_serializable);
-
-// eliminate object tracking (even if serialized through a pointer)
-// at the risk of a programming error creating duplicate objects.
-BOOST_CLASS_TRACKING(RemoteEvent, boost::serialization::track_never)
\ No newline at end of file
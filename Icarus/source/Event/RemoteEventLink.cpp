@@ -0,0 +1,194 @@
+/* RemoteEventLink.cpp
+Author: Jeff Kiah
+Orig.Date: 10/17/2026
+*/
+
+#include "RemoteEventLink.h"
+#include "RegisteredEvents.h"
+#include "RemoteEvent.h"
+
+////////// class LoopbackTransport //////////
+
+uint8_t * LoopbackTransport::acquirePacket(size_t &outCapacity)
+{
+	uint32_t send = mSendIndex.load(std::memory_order_relaxed);
+	if (send - mReceiveIndex.load(std::memory_order_acquire) >= mNumPackets) {
+		return 0; // every buffer is waiting to be received
+	}
+	outCapacity = mPacketSize;
+	return &mBuffer[(send % mNumPackets) * mPacketSize];
+}
+
+void LoopbackTransport::sendPacket(size_t size)
+{
+	_ASSERTE(size <= mPacketSize);
+	uint32_t send = mSendIndex.load(std::memory_order_relaxed);
+	mSizes[send % mNumPackets] = static_cast<uint32_t>(size);
+	mSendIndex.store(send + 1, std::memory_order_release);
+}
+
+const uint8_t * LoopbackTransport::receivePacket(size_t &outSize)
+{
+	uint32_t receive = mReceiveIndex.load(std::memory_order_relaxed);
+	if (receive == mSendIndex.load(std::memory_order_acquire)) {
+		return 0;
+	}
+	outSize = mSizes[receive % mNumPackets];
+	return &mBuffer[(receive % mNumPackets) * mPacketSize];
+}
+
+void LoopbackTransport::releasePacket()
+{
+	mReceiveIndex.store(mReceiveIndex.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+LoopbackTransport::LoopbackTransport(uint32_t numPackets, size_t packetSize) :
+	mBuffer(numPackets * packetSize, 0),
+	mSizes(numPackets, 0),
+	mPacketSize(packetSize),
+	mNumPackets(numPackets),
+	mSendIndex(0),
+	mReceiveIndex(0)
+{
+	_ASSERTE(numPackets > 0 && packetSize > 0);
+}
+
+////////// class RemoteEventLink //////////
+
+bool RemoteEventLink::openPacket()
+{
+	size_t capacity = 0;
+	uint8_t *packet = mTransport.acquirePacket(capacity);
+	if (!packet) { return false; }
+	mWriter.reset(packet, capacity);
+	mPacketOpen = true;
+	mPacketEvents = 0;
+	return true;
+}
+
+/*-----------------------------------------------------------------------------
+	Writes one event record, returns false if it doesn't fit with room left
+	for the end of packet bit. The caller rewinds a failed write. e is null
+	for empty types.
+-----------------------------------------------------------------------------*/
+bool RemoteEventLink::writeEvent(EventTypeId eventTypeId, const Event *e, const RegisteredEvent &reg)
+{
+	mWriter.writeBool(true);
+	mWriter.writeBits(eventTypeId, 32);
+	if (reg.isEmpty()) {
+		// empty remote types are raised as an EmptyEvent, there is no target to carry
+		mWriter.writeBool(true);
+	} else {
+		const RemoteEvent &re = static_cast<const RemoteEvent &>(*e);
+		mWriter.writeBool(re.isBroadcast());
+		if (!re.isBroadcast()) {
+			_ASSERTE(re.targetClientId() >= 0 && re.targetClientId() <= 0xFFFF && "Target client id doesn't fit the packet header");
+			mWriter.writeBits(static_cast<uint32_t>(re.targetClientId()) & 0xFFFF, 16);
+		}
+		WireWriter wireOut(mWriter, *reg.getWireSchema());
+		re.writeWire(wireOut);
+	}
+	return (mWriter.ok() && mWriter.bitsWritten() < mWriter.capacity() * 8);
+}
+
+bool RemoteEventLink::sendRecord(EventTypeId eventTypeId, const Event *e)
+{
+	EventManagerPtr eventMgr(mEventMgr.lock());
+	RegEventPtr regPtr(eventMgr ? eventMgr->getRegEventPtr(eventTypeId) : RegEventPtr());
+	if (!regPtr || !regPtr->remoteAllowed() || (!e && !regPtr->isEmpty())) {
+		debugPrintf("RemoteEventLink: cannot send event id 0x%08x, not registered as remote\n", eventTypeId);
+		++mStats.eventsDropped;
+		return false;
+	}
+
+	for (;;) {
+		if (!mPacketOpen && !openPacket()) { break; }
+		BitWriter::Mark mark = mWriter.mark();
+		if (writeEvent(eventTypeId, e, *regPtr)) {
+			++mPacketEvents;
+			++mStats.eventsSent;
+			return true;
+		}
+		mWriter.rewind(mark);
+		if (mPacketEvents == 0) {
+			debugPrintf("RemoteEventLink: event id 0x%08x is larger than a packet\n", eventTypeId);
+			break;
+		}
+		flush(); // send what fits and try again in a fresh packet
+	}
+	++mStats.eventsDropped;
+	return false;
+}
+
+bool RemoteEventLink::send(const EventPtr &ePtr)
+{
+	return sendRecord(ePtr->typeId(), ePtr.get());
+}
+
+bool RemoteEventLink::send(EventTypeId eventTypeId)
+{
+	return sendRecord(eventTypeId, 0);
+}
+
+void RemoteEventLink::flush()
+{
+	if (!mPacketOpen || mPacketEvents == 0) { return; }
+	mWriter.writeBool(false); // end of packet, writeEvent left room for it
+	size_t size = mWriter.finish();
+	mTransport.sendPacket(size);
+	++mStats.packetsSent;
+	mStats.bytesSent += size;
+	mPacketOpen = false;
+	mPacketEvents = 0;
+}
+
+uint32_t RemoteEventLink::receive(bool trigger)
+{
+	EventManagerPtr eventMgr(mEventMgr.lock());
+	if (!eventMgr) { return 0; }
+
+	uint32_t delivered = 0;
+	size_t size = 0;
+	const uint8_t *packet = 0;
+	while ((packet = mTransport.receivePacket(size)) != 0) {
+		++mStats.packetsReceived;
+		BitReader in(packet, size);
+		bool corrupt = false;
+		while (in.readBool()) {
+			EventTypeId eventTypeId = in.readBits(32);
+			int targetClientId = (in.readBool() ? -1 : static_cast<int>(in.readBits(16)));
+			EventPtr ePtr(in.ok() ? eventMgr->readRemoteEvent(eventTypeId, in, targetClientId) : EventPtr());
+			if (!ePtr) {
+				corrupt = true;
+				break;
+			}
+			if (trigger) {
+				eventMgr->trigger(ePtr);
+			} else {
+				eventMgr->raise(ePtr);
+			}
+			++delivered;
+		}
+		if (corrupt || !in.ok()) {
+			debugPrintf("RemoteEventLink: dropped the rest of a %u byte packet\n", static_cast<uint32_t>(size));
+			++mStats.decodeErrors;
+		}
+		mTransport.releasePacket();
+	}
+	mStats.eventsReceived += delivered;
+	return delivered;
+}
+
+RemoteEventLink::RemoteEventLink(RemoteTransport &transport, const EventManagerPtr &eventMgr) :
+	mTransport(transport),
+	mEventMgr(eventMgr),
+	mPacketOpen(false),
+	mPacketEvents(0)
+{
+	memset(&mStats, 0, sizeof(mStats));
+}
+
+RemoteEventLink::~RemoteEventLink()
+{
+	flush();
+}
@@ -0,0 +1,151 @@
+/* RemoteEventLink.h
+Author: Jeff Kiah
+Orig.Date: 10/17/2026
+*/
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <atomic>
+#include <boost/noncopyable.hpp>
+#include "EventManager.h"
+#include "Utility/BitStream.h"
+
+using std::vector;
+
+///// STRUCTURES /////
+
+/*=============================================================================
+class RemoteTransport
+	Interface to whatever moves packets between peers. Packets are lent out
+	rather than passed in, so the sender packs events straight into the
+	buffer that goes out and the receiver decodes straight from the buffer
+	that came in. Delivery is unreliable, like UDP, a transport with no
+	buffer free to lend refuses the send.
+=============================================================================*/
+class RemoteTransport : private boost::noncopyable {
+	public:
+		/*---------------------------------------------------------------------
+			Lends the next outgoing packet buffer and its capacity in bytes,
+			or returns null if none is free
+		---------------------------------------------------------------------*/
+		virtual uint8_t *		acquirePacket(size_t &outCapacity) = 0;
+		/*---------------------------------------------------------------------
+			Sends the first size bytes of the acquired packet
+		---------------------------------------------------------------------*/
+		virtual void			sendPacket(size_t size) = 0;
+		/*---------------------------------------------------------------------
+			Returns the next received packet and its size, or null if there
+			is none. The packet stays valid until releasePacket.
+		---------------------------------------------------------------------*/
+		virtual const uint8_t *	receivePacket(size_t &outSize) = 0;
+		virtual void			releasePacket() = 0;
+
+		virtual ~RemoteTransport() {}
+};
+
+/*=============================================================================
+class LoopbackTransport
+	In-process transport for testing and benchmarking the remote event path
+	without a network. Packets go round a fixed ring of preallocated
+	buffers, so nothing is allocated or copied after construction. One
+	thread may send while another receives, the ring indices are the only
+	shared state.
+=============================================================================*/
+class LoopbackTransport : public RemoteTransport {
+	private:
+		///// VARIABLES /////
+		vector<uint8_t>			mBuffer;		// numPackets buffers of packetSize bytes
+		vector<uint32_t>		mSizes;			// bytes sent in each buffer
+		size_t					mPacketSize;
+		uint32_t				mNumPackets;
+		std::atomic<uint32_t>	mSendIndex;		// count of packets sent
+		std::atomic<uint32_t>	mReceiveIndex;	// count of packets released by the receiver
+
+	public:
+		virtual uint8_t *		acquirePacket(size_t &outCapacity);
+		virtual void			sendPacket(size_t size);
+		virtual const uint8_t *	receivePacket(size_t &outSize);
+		virtual void			releasePacket();
+
+		// Constructor / destructor
+		explicit LoopbackTransport(uint32_t numPackets = 64, size_t packetSize = 1200);
+		virtual ~LoopbackTransport() {}
+};
+
+/*=============================================================================
+class RemoteEventLink
+	Sends remote events through a RemoteTransport and raises the events it
+	receives into the local EventManager. Events are packed back to back
+	into the current packet as they are sent, and the packet goes out when
+	the next event doesn't fit or on flush, usually once a frame.
+	Packet layout, bit packed and little-endian (see BitStream.h):
+		for each event
+			1 bit		1, another event follows
+			32 bits		EventTypeId
+			1 bit		broadcast
+			16 bits		target client id, only if not broadcast
+			payload		fields packed by the type's WireSchema, none if empty
+		1 bit		0, end of packet
+	Only types registered with RemoteCallableEvent can be sent or received.
+	A packet that fails to decode is dropped from the first bad event, as
+	nothing after it can be located. Not thread safe, use one link per
+	thread.
+=============================================================================*/
+class RemoteEventLink : private boost::noncopyable {
+	public:
+		///// DEFINITIONS /////
+		struct Stats {
+			uint64_t	eventsSent;
+			uint64_t	eventsDropped;		// didn't fit a packet, or the transport had no packet free
+			uint64_t	packetsSent;
+			uint64_t	bytesSent;
+			uint64_t	eventsReceived;
+			uint64_t	packetsReceived;
+			uint64_t	decodeErrors;		// packets abandoned at a bad event
+		};
+
+	private:
+		///// VARIABLES /////
+		RemoteTransport &	mTransport;
+		EventManagerWeakPtr	mEventMgr;
+		BitWriter			mWriter;		// over the packet being filled, when mPacketOpen
+		bool				mPacketOpen;
+		uint32_t			mPacketEvents;
+		Stats				mStats;
+
+		///// FUNCTIONS /////
+		bool openPacket();
+		bool writeEvent(EventTypeId eventTypeId, const Event *e, const RegisteredEvent &reg);
+		bool sendRecord(EventTypeId eventTypeId, const Event *e);
+
+	public:
+		/*---------------------------------------------------------------------
+			Packs an event into the current packet, sending the packet first
+			if the event doesn't fit. Returns false and counts the event as
+			dropped if it can't be sent.
+		---------------------------------------------------------------------*/
+		bool send(const EventPtr &ePtr);
+		/*---------------------------------------------------------------------
+			Sends an event of an empty remote type, which has no payload
+		---------------------------------------------------------------------*/
+		bool send(EventTypeId eventTypeId);
+
+		/*---------------------------------------------------------------------
+			Sends the current packet if it holds any events
+		---------------------------------------------------------------------*/
+		void flush();
+
+		/*---------------------------------------------------------------------
+			Decodes every packet waiting in the transport, raising each event
+			into the EventManager, or triggering it if trigger is true.
+			Returns the number of events delivered.
+		---------------------------------------------------------------------*/
+		uint32_t receive(bool trigger = false);
+
+		const Stats &	getStats() const { return mStats; }
+
+		// Constructor / destructor
+		explicit RemoteEventLink(RemoteTransport &transport, const EventManagerPtr &eventMgr);
+		~RemoteEventLink();
+};
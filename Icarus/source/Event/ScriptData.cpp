@@ -0,0 +1,122 @@
+/* ScriptData.cpp
+Author: Jeff Kiah
+Orig.Date: 10/17/2026
+*/
+
+#include "ScriptData.h"
+
+///// VARIABLES /////
+
+static const uint32_t sFieldSize[ScriptField_MAX] = {
+	1,	// ScriptField_Bool
+	4,	// ScriptField_Int
+	4,	// ScriptField_UInt
+	4,	// ScriptField_Float
+	8,	// ScriptField_Double
+	8	// ScriptField_String, offset and length of the characters in the tail
+};
+
+////////// class ScriptDataSchema //////////
+
+ScriptFieldIndex ScriptDataSchema::addField(const string &name, ScriptFieldType type)
+{
+	_ASSERTE(type < ScriptField_MAX && mFields.size() < ScriptField_NotFound);
+	if (mFieldIndex.find(name) != mFieldIndex.end()) {
+		debugPrintf("ScriptDataSchema: field \"%s\" already added\n", name.c_str());
+		return ScriptField_NotFound;
+	}
+	// align each field to its size so the blob stays friendly to direct loads
+	uint32_t size = sFieldSize[type];
+	uint32_t align = (size < 4 ? size : 4);
+	uint32_t offset = (mFixedSize + align - 1) & ~(align - 1);
+
+	Field field = { name, offset, type };
+	ScriptFieldIndex f = static_cast<ScriptFieldIndex>(mFields.size());
+	mFields.push_back(field);
+	mFieldIndex[name] = f;
+	mFixedSize = offset + size;
+	return f;
+}
+
+////////// class ScriptData //////////
+
+const char * ScriptData::getString(ScriptFieldIndex f, size_t *length) const
+{
+	uint32_t slot[2]; // offset, length
+	_ASSERTE(mSchema && f < mSchema->numFields() && mSchema->field(f).mType == ScriptField_String && "ScriptData field type mismatch");
+	memcpy(slot, &mBytes[mSchema->field(f).mOffset], sizeof(slot));
+	if (length) { *length = slot[1]; }
+	return (slot[0] != 0 ? reinterpret_cast<const char *>(&mBytes[slot[0]]) : "");
+}
+
+void ScriptData::setString(ScriptFieldIndex f, const char *value, size_t length)
+{
+	_ASSERTE(mSchema && f < mSchema->numFields() && mSchema->field(f).mType == ScriptField_String && "ScriptData field type mismatch");
+	uint32_t slot[2] = { static_cast<uint32_t>(mBytes.size()), static_cast<uint32_t>(length) };
+	mBytes.insert(mBytes.end(), reinterpret_cast<const uint8_t *>(value), reinterpret_cast<const uint8_t *>(value) + length);
+	mBytes.push_back(0);
+	memcpy(&mBytes[mSchema->field(f).mOffset], slot, sizeof(slot));
+}
+
+double ScriptData::getNumber(ScriptFieldIndex f) const
+{
+	switch (mSchema->field(f).mType) {
+		case ScriptField_Bool:		return (getBool(f) ? 1.0 : 0.0);
+		case ScriptField_Int:		return getInt(f);
+		case ScriptField_UInt:		return getUInt(f);
+		case ScriptField_Float:		return getFloat(f);
+		case ScriptField_Double:	return getDouble(f);
+		default:
+			_ASSERTE(false && "ScriptData::getNumber called on a string field");
+			return 0.0;
+	}
+}
+
+void ScriptData::setNumber(ScriptFieldIndex f, double value)
+{
+	switch (mSchema->field(f).mType) {
+		case ScriptField_Bool:		setBool(f, value != 0.0); break;
+		case ScriptField_Int:		setInt(f, static_cast<int32_t>(value)); break;
+		case ScriptField_UInt:		setUInt(f, static_cast<uint32_t>(value)); break;
+		case ScriptField_Float:		setFloat(f, static_cast<float>(value)); break;
+		case ScriptField_Double:	setDouble(f, value); break;
+		default:
+			_ASSERTE(false && "ScriptData::setNumber called on a string field");
+	}
+}
+
+bool ScriptData::assign(const AnyVars &vars)
+{
+	if (!mSchema) { return vars.empty(); }
+	bool ok = true;
+	for (AnyVars::const_iterator i = vars.begin(); i != vars.end(); ++i) {
+		ScriptFieldIndex f = mSchema->findField(i->first);
+		if (f == ScriptField_NotFound) { continue; }
+		try {
+			switch (mSchema->field(f).mType) {
+				case ScriptField_Bool:		setBool(f, any_cast<bool>(i->second)); break;
+				case ScriptField_Int:		setInt(f, any_cast<int>(i->second)); break;
+				case ScriptField_UInt:		setUInt(f, any_cast<uint32_t>(i->second)); break;
+				case ScriptField_Float:		setFloat(f, any_cast<float>(i->second)); break;
+				case ScriptField_Double:	setDouble(f, any_cast<double>(i->second)); break;
+				case ScriptField_String:	setString(f, any_cast<string>(i->second)); break;
+				default: break;
+			}
+		} catch (const boost::bad_any_cast &ex) {
+			// nothing happens with a bad datatype in release build, silently ignores
+			debugPrintf("ScriptData: field \"%s\" bad_any_cast \"%s\"\n", i->first.c_str(), ex.what());
+			ok = false;
+		}
+	}
+	return ok;
+}
+
+void ScriptData::reset(const ScriptDataSchemaPtr &schema)
+{
+	mSchema = schema;
+	mBytes.clear();
+	if (mSchema) {
+		mBytes.reserve(mSchema->fixedSize() + mSchema->stringReserve());
+		mBytes.resize(mSchema->fixedSize(), 0);
+	}
+}
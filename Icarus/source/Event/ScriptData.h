@@ -0,0 +1,196 @@
+/* ScriptData.h
+Author: Jeff Kiah
+Orig.Date: 10/17/2026
+*/
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <list>
+#include <vector>
+#include <memory>
+#include <hash_map>
+#include <boost/noncopyable.hpp>
+#include <boost/any.hpp>
+#include "Utility/Debug.h"
+
+using std::string;	using std::vector;
+using std::list;	using std::pair;
+using std::shared_ptr;
+using std::hash_map;
+using boost::any;	using boost::any_cast;
+
+///// DEFINITIONS /////
+
+enum ScriptFieldType : uint8_t {
+	ScriptField_Bool = 0,
+	ScriptField_Int,		// int32_t
+	ScriptField_UInt,		// uint32_t
+	ScriptField_Float,
+	ScriptField_Double,
+	ScriptField_String,		// UTF-8, stored null terminated in the tail of the blob
+	ScriptField_MAX			// not a type, reference for array size
+};
+
+class ScriptDataSchema;
+typedef uint16_t							ScriptFieldIndex;	// position of a field in its schema
+typedef shared_ptr<const ScriptDataSchema>	ScriptDataSchemaPtr;
+typedef pair<string, any>	AnyVarsValue;	// key/value pair where string is key and value utilizes boost::any
+typedef list<AnyVarsValue>	AnyVars;		// list of key/value pairs. This does not provide constant time
+											// random access to elements, so lists should generally be short
+
+const ScriptFieldIndex ScriptField_NotFound = 0xFFFF;
+
+///// STRUCTURES /////
+
+/*=============================================================================
+class ScriptDataSchema
+	Describes the fields of a script-visible event type, registered once per
+	type. Each field gets a fixed offset in the ScriptData blob when it is
+	added, so reading or writing a field by index is a bounds check and a
+	memcpy. Event classes keep an enum of their field indices that matches
+	the order fields are added, so C++ code never looks fields up by name.
+	Name lookup is for script and the legacy AnyVars path, and is case
+	sensitive. Add every field before the first ScriptData uses the schema.
+=============================================================================*/
+class ScriptDataSchema : private boost::noncopyable {
+	public:
+		///// DEFINITIONS /////
+		struct Field {
+			string			mName;
+			uint32_t		mOffset;	// byte offset in the blob
+			ScriptFieldType	mType;
+		};
+
+	private:
+		typedef hash_map<string, ScriptFieldIndex>	FieldIndexMap;
+
+		///// VARIABLES /////
+		vector<Field>	mFields;
+		FieldIndexMap	mFieldIndex;
+		uint32_t		mFixedSize;		// bytes taken by the fields, strings are appended past this
+		uint32_t		mStringReserve;	// expected string bytes, reserved up front so strings don't regrow the blob
+
+	public:
+		/*---------------------------------------------------------------------
+			Adds a field and returns its index, fields are numbered from 0 in
+			the order they are added. Returns ScriptField_NotFound if the name
+			is already taken.
+		---------------------------------------------------------------------*/
+		ScriptFieldIndex addField(const string &name, ScriptFieldType type);
+
+		/*---------------------------------------------------------------------
+			Sets how many bytes of string data to reserve in each blob, for
+			types with string fields
+		---------------------------------------------------------------------*/
+		void			reserveStrings(uint32_t bytes)	{ mStringReserve = bytes; }
+
+		/*---------------------------------------------------------------------
+			Returns the index of the named field, or ScriptField_NotFound
+		---------------------------------------------------------------------*/
+		ScriptFieldIndex findField(const string &name) const
+		{
+			FieldIndexMap::const_iterator fi = mFieldIndex.find(name);
+			return (fi != mFieldIndex.end() ? fi->second : ScriptField_NotFound);
+		}
+
+		const Field &	field(ScriptFieldIndex f) const	{ return mFields[f]; }
+		size_t			numFields() const		{ return mFields.size(); }
+		uint32_t		fixedSize() const		{ return mFixedSize; }
+		uint32_t		stringReserve() const	{ return mStringReserve; }
+
+		// Constructor
+		explicit ScriptDataSchema() :
+			mFixedSize(0),
+			mStringReserve(0)
+		{}
+};
+
+/*=============================================================================
+class ScriptData
+	Typed property blob holding the script-visible data of one event. The
+	fields described by the schema are stored inline at fixed offsets in a
+	single buffer, with string characters appended after them, so building
+	the data for an event is one allocation no matter how many fields it has.
+	Accessors take the field index and assert on a type mismatch in a debug
+	build. Strings are meant to be set once, setting a string field again
+	leaves the old characters in the tail unused until reset.
+	Copying a ScriptData copies the buffer, reset keeps its capacity so a
+	scratch ScriptData can be refilled without allocating.
+=============================================================================*/
+class ScriptData {
+	private:
+		///// VARIABLES /////
+		ScriptDataSchemaPtr	mSchema;
+		vector<uint8_t>		mBytes;
+
+		///// FUNCTIONS /////
+		template <typename T>
+		T read(ScriptFieldIndex f, ScriptFieldType type) const
+		{
+			_ASSERTE(mSchema && f < mSchema->numFields() && mSchema->field(f).mType == type && "ScriptData field type mismatch");
+			T value;
+			memcpy(&value, &mBytes[mSchema->field(f).mOffset], sizeof(T));
+			return value;
+		}
+
+		template <typename T>
+		void write(ScriptFieldIndex f, ScriptFieldType type, T value)
+		{
+			_ASSERTE(mSchema && f < mSchema->numFields() && mSchema->field(f).mType == type && "ScriptData field type mismatch");
+			memcpy(&mBytes[mSchema->field(f).mOffset], &value, sizeof(T));
+		}
+
+	public:
+		/*---------------------------------------------------------------------
+			Typed field access, O(1) by index
+		---------------------------------------------------------------------*/
+		bool		getBool(ScriptFieldIndex f) const	{ return (read<uint8_t>(f, ScriptField_Bool) != 0); }
+		int32_t		getInt(ScriptFieldIndex f) const	{ return read<int32_t>(f, ScriptField_Int); }
+		uint32_t	getUInt(ScriptFieldIndex f) const	{ return read<uint32_t>(f, ScriptField_UInt); }
+		float		getFloat(ScriptFieldIndex f) const	{ return read<float>(f, ScriptField_Float); }
+		double		getDouble(ScriptFieldIndex f) const	{ return read<double>(f, ScriptField_Double); }
+		/*---------------------------------------------------------------------
+			Returns the null terminated string, and its length in bytes if
+			length is not null. An unset string field is empty.
+		---------------------------------------------------------------------*/
+		const char *getString(ScriptFieldIndex f, size_t *length = 0) const;
+
+		void setBool(ScriptFieldIndex f, bool value)		{ write<uint8_t>(f, ScriptField_Bool, (value ? 1 : 0)); }
+		void setInt(ScriptFieldIndex f, int32_t value)		{ write<int32_t>(f, ScriptField_Int, value); }
+		void setUInt(ScriptFieldIndex f, uint32_t value)	{ write<uint32_t>(f, ScriptField_UInt, value); }
+		void setFloat(ScriptFieldIndex f, float value)		{ write<float>(f, ScriptField_Float, value); }
+		void setDouble(ScriptFieldIndex f, double value)	{ write<double>(f, ScriptField_Double, value); }
+		void setString(ScriptFieldIndex f, const char *value, size_t length);
+		void setString(ScriptFieldIndex f, const string &value) { setString(f, value.c_str(), value.size()); }
+
+		/*---------------------------------------------------------------------
+			Any numeric or bool field as a double and back, for script
+			bindings where every number is a double. Asserts on strings.
+		---------------------------------------------------------------------*/
+		double	getNumber(ScriptFieldIndex f) const;
+		void	setNumber(ScriptFieldIndex f, double value);
+
+		/*---------------------------------------------------------------------
+			Sets fields from a legacy AnyVars list by name. Unknown names are
+			ignored, values of the wrong type are skipped with a debug
+			message. Returns false if any value was skipped.
+		---------------------------------------------------------------------*/
+		bool	assign(const AnyVars &vars);
+
+		/*---------------------------------------------------------------------
+			Lays out a zeroed blob for schema, keeping the buffer's capacity.
+			A null schema leaves the data empty.
+		---------------------------------------------------------------------*/
+		void	reset(const ScriptDataSchemaPtr &schema);
+
+		const ScriptDataSchemaPtr &	schema() const	{ return mSchema; }
+		bool		empty() const		{ return !mSchema; }
+		size_t		numFields() const	{ return (mSchema ? mSchema->numFields() : 0); }
+		size_t		byteSize() const	{ return mBytes.size(); }
+
+		// Constructors
+		explicit ScriptData() {}
+		explicit ScriptData(const ScriptDataSchemaPtr &schema) { reset(schema); }
+};
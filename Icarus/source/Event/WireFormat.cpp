@@ -0,0 +1,63 @@
+/* WireFormat.cpp
+Author: Jeff Kiah
+Orig.Date: 10/17/2026
+*/
+
+#include "WireFormat.h"
+
+////////// class WireSchema //////////
+
+WireFieldIndex WireSchema::addField(const Field &field, uint32_t maxBits)
+{
+	_ASSERTE(mFields.size() < 0xFFFF);
+	WireFieldIndex f = static_cast<WireFieldIndex>(mFields.size());
+	mFields.push_back(field);
+	mMaxBits += maxBits;
+	return f;
+}
+
+WireFieldIndex WireSchema::addBool(const string &name)
+{
+	Field field = { name, WireField_Bool, 1, 0, 0.0f, 0.0f, 0.0f, 0.0f, 0 };
+	return addField(field, 1);
+}
+
+WireFieldIndex WireSchema::addUInt(const string &name, uint32_t bits)
+{
+	_ASSERTE(bits > 0 && bits <= 32);
+	Field field = { name, WireField_UInt, static_cast<uint8_t>(bits), 0, 0.0f, 0.0f, 0.0f, 0.0f, 0 };
+	return addField(field, bits);
+}
+
+WireFieldIndex WireSchema::addInt(const string &name, int32_t minValue, int32_t maxValue)
+{
+	_ASSERTE(minValue <= maxValue);
+	uint32_t bits = bitsRequired(static_cast<uint32_t>(maxValue) - static_cast<uint32_t>(minValue));
+	if (bits == 0) { bits = 1; }	// a single value still takes a bit, so every field is readable
+	Field field = { name, WireField_Int, static_cast<uint8_t>(bits), minValue, 0.0f, 0.0f, 0.0f, 0.0f, 0 };
+	return addField(field, bits);
+}
+
+WireFieldIndex WireSchema::addFloat(const string &name)
+{
+	Field field = { name, WireField_Float, 32, 0, 0.0f, 0.0f, 0.0f, 0.0f, 0 };
+	return addField(field, 32);
+}
+
+WireFieldIndex WireSchema::addQuantizedFloat(const string &name, float minValue, float maxValue, uint32_t bits)
+{
+	// past 24 bits the steps are finer than a float can resolve
+	_ASSERTE(minValue < maxValue && bits > 0 && bits <= 24);
+	float steps = static_cast<float>((1u << bits) - 1);
+	Field field = { name, WireField_QuantizedFloat, static_cast<uint8_t>(bits), 0, minValue, maxValue,
+					steps / (maxValue - minValue), (maxValue - minValue) / steps, 0 };
+	return addField(field, bits);
+}
+
+WireFieldIndex WireSchema::addString(const string &name, uint32_t maxLength)
+{
+	_ASSERTE(maxLength > 0);
+	uint32_t bits = bitsRequired(maxLength);
+	Field field = { name, WireField_String, static_cast<uint8_t>(bits), 0, 0.0f, 0.0f, 0.0f, 0.0f, maxLength };
+	return addField(field, bits + 7 + maxLength * 8);	// length, alignment padding, characters
+}
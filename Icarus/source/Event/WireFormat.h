@@ -0,0 +1,250 @@
+/* WireFormat.h
+Author: Jeff Kiah
+Orig.Date: 10/17/2026
+*/
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <memory>
+#include <boost/noncopyable.hpp>
+#include "Utility/BitStream.h"
+#include "Utility/Debug.h"
+
+using std::string;
+using std::vector;
+using std::shared_ptr;
+
+///// DEFINITIONS /////
+
+enum WireFieldType : uint8_t {
+	WireField_Bool = 0,		// 1 bit
+	WireField_UInt,			// unsigned, a fixed number of bits
+	WireField_Int,			// signed, sent as the offset from the minimum in just enough bits for the range
+	WireField_Float,		// full 32-bit float
+	WireField_QuantizedFloat,	// float clamped to a range and sent as a fixed number of evenly spaced steps
+	WireField_String,		// length in just enough bits for the maximum, then the bytes, byte aligned
+	WireField_MAX			// not a type, reference for array size
+};
+
+class WireSchema;
+typedef uint16_t						WireFieldIndex;		// position of a field in its schema
+typedef shared_ptr<const WireSchema>	WireSchemaPtr;
+
+///// STRUCTURES /////
+
+/*=============================================================================
+class WireSchema
+	Describes how the payload of a remote event type is packed, registered
+	once per type like ScriptDataSchema. Each field has a fixed encoding
+	chosen when it is added, so both ends agree on the bit layout without
+	any per-packet description, and values only take the bits their range
+	needs. Remote event classes keep an enum of their field indices in the
+	order fields are added, and write and read them in that order.
+=============================================================================*/
+class WireSchema : private boost::noncopyable {
+	public:
+		///// DEFINITIONS /////
+		struct Field {
+			string			mName;		// for debugging only, never sent
+			WireFieldType	mType;
+			uint8_t			mBits;		// value bits, or length bits for strings
+			int32_t			mMinInt;
+			float			mMin;
+			float			mMax;
+			float			mStepsPerUnit;	// quantized floats, steps / (max - min)
+			float			mUnitsPerStep;
+			uint32_t		mMaxLength;		// strings, in bytes
+		};
+
+	private:
+		///// VARIABLES /////
+		vector<Field>	mFields;
+		uint32_t		mMaxBits;	// largest payload the schema can produce, padding included
+
+		///// FUNCTIONS /////
+		WireFieldIndex addField(const Field &field, uint32_t maxBits);
+
+	public:
+		/*---------------------------------------------------------------------
+			Add fields in order, each returns the index of the new field
+		---------------------------------------------------------------------*/
+		WireFieldIndex addBool(const string &name);
+		WireFieldIndex addUInt(const string &name, uint32_t bits);
+		WireFieldIndex addInt(const string &name, int32_t minValue, int32_t maxValue);
+		WireFieldIndex addFloat(const string &name);
+		/*---------------------------------------------------------------------
+			Values are clamped to [minValue, maxValue] and sent as one of
+			2^bits evenly spaced steps, so precision is the range / 2^bits
+		---------------------------------------------------------------------*/
+		WireFieldIndex addQuantizedFloat(const string &name, float minValue, float maxValue, uint32_t bits);
+		/*---------------------------------------------------------------------
+			Longer strings are truncated to maxLength bytes when written
+		---------------------------------------------------------------------*/
+		WireFieldIndex addString(const string &name, uint32_t maxLength);
+
+		const Field &	field(WireFieldIndex f) const	{ return mFields[f]; }
+		size_t			numFields() const	{ return mFields.size(); }
+		uint32_t		maxBits() const		{ return mMaxBits; }
+
+		// Constructor
+		explicit WireSchema() : mMaxBits(0) {}
+};
+
+/*=============================================================================
+class WireWriter
+	Writes the fields of one event's payload through a BitWriter using the
+	encodings of its schema. Fields must be written in schema order, which
+	is asserted in a debug build. Failure to fit is left in the BitWriter's
+	fail state for the caller to check.
+=============================================================================*/
+class WireWriter {
+	private:
+		BitWriter &			mOut;
+		const WireSchema &	mSchema;
+		WireFieldIndex		mNext;	// next field expected, for the order check
+
+		const WireSchema::Field &next(WireFieldIndex f, WireFieldType type)
+		{
+			_ASSERTE(f == mNext && f < mSchema.numFields() && "Wire fields must be written in schema order");
+			const WireSchema::Field &field = mSchema.field(f);
+			_ASSERTE((field.mType == type || (type == WireField_Float && field.mType == WireField_QuantizedFloat)) && "Wire field type mismatch");
+			++mNext;
+			return field;
+		}
+
+	public:
+		void writeBool(WireFieldIndex f, bool value)
+		{
+			next(f, WireField_Bool);
+			mOut.writeBool(value);
+		}
+
+		void writeUInt(WireFieldIndex f, uint32_t value)
+		{
+			const WireSchema::Field &field = next(f, WireField_UInt);
+			_ASSERTE((field.mBits == 32 || (value >> field.mBits) == 0) && "Wire UInt out of range");
+			mOut.writeBits(value, field.mBits);
+		}
+
+		void writeInt(WireFieldIndex f, int32_t value)
+		{
+			const WireSchema::Field &field = next(f, WireField_Int);
+			uint32_t offset = static_cast<uint32_t>(value) - static_cast<uint32_t>(field.mMinInt);
+			_ASSERTE((field.mBits == 32 || (offset >> field.mBits) == 0) && "Wire Int out of range");
+			mOut.writeBits(offset, field.mBits);
+		}
+
+		/*---------------------------------------------------------------------
+			Writes a float field, quantized if the schema says so
+		---------------------------------------------------------------------*/
+		void writeFloat(WireFieldIndex f, float value)
+		{
+			const WireSchema::Field &field = next(f, WireField_Float);
+			if (field.mType == WireField_QuantizedFloat) {
+				float clamped = (value < field.mMin ? field.mMin : (value > field.mMax ? field.mMax : value));
+				mOut.writeBits(static_cast<uint32_t>((clamped - field.mMin) * field.mStepsPerUnit + 0.5f), field.mBits);
+			} else {
+				uint32_t bits;
+				memcpy(&bits, &value, sizeof(bits));
+				mOut.writeBits(bits, 32);
+			}
+		}
+
+		void writeString(WireFieldIndex f, const char *value, size_t length)
+		{
+			const WireSchema::Field &field = next(f, WireField_String);
+			if (length > field.mMaxLength) {
+				debugPrintf("WireWriter: string field \"%s\" truncated to %u bytes\n", field.mName.c_str(), field.mMaxLength);
+				length = field.mMaxLength;
+			}
+			mOut.writeBits(static_cast<uint32_t>(length), field.mBits);
+			mOut.writeBytes(value, length);
+		}
+		void writeString(WireFieldIndex f, const string &value) { writeString(f, value.data(), value.size()); }
+
+		explicit WireWriter(BitWriter &out, const WireSchema &schema) :
+			mOut(out), mSchema(schema), mNext(0)
+		{}
+};
+
+/*=============================================================================
+class WireReader
+	Reads the fields of one event's payload in schema order, straight out of
+	the packet. Strings come back as a pointer into the packet and a length,
+	not null terminated, and only valid while the packet is. Errors are left
+	in the BitReader's fail state.
+=============================================================================*/
+class WireReader {
+	private:
+		BitReader &			mIn;
+		const WireSchema &	mSchema;
+		WireFieldIndex		mNext;
+
+		const WireSchema::Field &next(WireFieldIndex f, WireFieldType type)
+		{
+			_ASSERTE(f == mNext && f < mSchema.numFields() && "Wire fields must be read in schema order");
+			const WireSchema::Field &field = mSchema.field(f);
+			_ASSERTE((field.mType == type || (type == WireField_Float && field.mType == WireField_QuantizedFloat)) && "Wire field type mismatch");
+			++mNext;
+			return field;
+		}
+
+	public:
+		bool readBool(WireFieldIndex f)
+		{
+			next(f, WireField_Bool);
+			return mIn.readBool();
+		}
+
+		uint32_t readUInt(WireFieldIndex f)
+		{
+			return mIn.readBits(next(f, WireField_UInt).mBits);
+		}
+
+		int32_t readInt(WireFieldIndex f)
+		{
+			const WireSchema::Field &field = next(f, WireField_Int);
+			return static_cast<int32_t>(mIn.readBits(field.mBits) + static_cast<uint32_t>(field.mMinInt));
+		}
+
+		float readFloat(WireFieldIndex f)
+		{
+			const WireSchema::Field &field = next(f, WireField_Float);
+			uint32_t bits = mIn.readBits(field.mBits);
+			if (field.mType == WireField_QuantizedFloat) {
+				return field.mMin + static_cast<float>(bits) * field.mUnitsPerStep;
+			}
+			float value;
+			memcpy(&value, &bits, sizeof(value));
+			return value;
+		}
+
+		/*---------------------------------------------------------------------
+			Returns the characters in place, null if the read failed
+		---------------------------------------------------------------------*/
+		const char *readString(WireFieldIndex f, size_t &outLength)
+		{
+			const WireSchema::Field &field = next(f, WireField_String);
+			outLength = mIn.readBits(field.mBits);
+			if (outLength > field.mMaxLength) {
+				mIn.fail();	// corrupt length
+				outLength = 0;
+				return 0;
+			}
+			const char *str = reinterpret_cast<const char *>(mIn.readBytes(outLength));
+			if (!str) { outLength = 0; }
+			return str;
+		}
+		void readString(WireFieldIndex f, string &outString)
+		{
+			size_t length = 0;
+			const char *str = readString(f, length);
+			if (str) { outString.assign(str, length); } else { outString.clear(); }
+		}
+
+		explicit WireReader(BitReader &in, const WireSchema &schema) :
+			mIn(in), mSchema(schema), mNext(0)
+		{}
+};
@@ -66,10 +66,10 @@ void PhysicsProcess::onTogglePause()
 			const State *outState = actor.getInterpolatedState();
 			// create and raise the ActorMoved event
 			if (outState) {
-				EventPtr ePtr(new ActorMovedEvent(	actor.actorID(),
-													outState->position(),
-													outState->orientation(),
-													ActorMovedEvent::System_Physics));
+				EventPtr ePtr(EventManager::make<ActorMovedEvent>(	actor.actorID(),
+																	outState->position(),
+																	outState->orientation(),
+																	ActorMovedEvent::System_Physics));
 				events.raise(ePtr);
 			}
 			++li;
@@ -92,7 +92,9 @@ PhysicsProcess::PhysicsProcess(const string &name, const float fixedDT,
 	}
 	// register event type(s)
 	events.registerEventType(ActorMovedEvent::sEventType,
-							 RegEventPtr(new ScriptCallableCodeEvent<ActorMovedEvent>(EventDataType_NotEmpty)));
+							 RegEventPtr(new ReplayableScriptCallableCodeEvent<ActorMovedEvent>(EventDataType_NotEmpty)));
+	// listeners only need the latest position of each actor per frame
+	events.setEventCoalescing(ActorMovedEvent::sEventType, EventCoalescing_Latest);
 }
 */
 ////////// class PhysicsScene //////////
@@ -5,61 +5,85 @@
 -----------------------------------*/
 
 #include "PhysicsEvents.h"
+//#include "Utility/BinaryStream.h"
 
 ////////// class ActorMovedEvent //////////
 
 //const string ActorMovedEvent::sEventType("SYS_ACTOR_MOVED");
 
+/*---------------------------------------------------------------------
+	Field order must match the Field_ enum in the class
+---------------------------------------------------------------------*/
+/*static ScriptDataSchemaPtr buildActorMovedSchema()
+{
+	shared_ptr<ScriptDataSchema> schema(new ScriptDataSchema());
+	schema->addField("actorID", ScriptField_Int);
+	schema->addField("newPositionX", ScriptField_Float);
+	schema->addField("newPositionY", ScriptField_Float);
+	schema->addField("newPositionZ", ScriptField_Float);
+	schema->addField("newRotationW", ScriptField_Float);
+	schema->addField("newRotationX", ScriptField_Float);
+	schema->addField("newRotationY", ScriptField_Float);
+	schema->addField("newRotationZ", ScriptField_Float);
+	schema->addField("systemGen", ScriptField_Int);
+	return schema;
+}
+
+const ScriptDataSchemaPtr ActorMovedEvent::sScriptSchema(buildActorMovedSchema());*/
+
 /*---------------------------------------------------------------------
 	This is called to construct script data out of a code-defined event
 ---------------------------------------------------------------------*/
 /*void ActorMovedEvent::buildScriptData()
 {
-	mScriptData.clear();
-	mScriptData.push_back(AnyVarsValue("actorID", actorID));
-	mScriptData.push_back(AnyVarsValue("newPositionX", newPosition.x));
-	mScriptData.push_back(AnyVarsValue("newPositionY", newPosition.y));
-	mScriptData.push_back(AnyVarsValue("newPositionZ", newPosition.z));
-	mScriptData.push_back(AnyVarsValue("newRotationW", newRotation.w));
-	mScriptData.push_back(AnyVarsValue("newRotationX", newRotation.x));
-	mScriptData.push_back(AnyVarsValue("newRotationY", newRotation.y));
-	mScriptData.push_back(AnyVarsValue("newRotationZ", newRotation.z));
-	mScriptData.push_back(AnyVarsValue("systemGen", systemGen));
+	mScriptData.reset(sScriptSchema);
+	mScriptData.setInt(Field_ActorId, actorID);
+	mScriptData.setFloat(Field_PositionX, newPosition.x);
+	mScriptData.setFloat(Field_PositionY, newPosition.y);
+	mScriptData.setFloat(Field_PositionZ, newPosition.z);
+	mScriptData.setFloat(Field_RotationW, newRotation.w);
+	mScriptData.setFloat(Field_RotationX, newRotation.x);
+	mScriptData.setFloat(Field_RotationY, newRotation.y);
+	mScriptData.setFloat(Field_RotationZ, newRotation.z);
+	mScriptData.setInt(Field_SystemGen, systemGen);
 	mScriptDataBuilt = true;
 }*/
 
 /*---------------------------------------------------------------------
-	The script-called constructor first sets all data equal to their
-	current values in Engine::mSettings, so if they aren't all supplied
-	by script, the setting will go unchanged.
+	The script-called constructor reads each field by index, fields not
+	supplied by script are zero.
 ---------------------------------------------------------------------*/
-/*ActorMovedEvent::ActorMovedEvent(const AnyVars &eventData) :
+/*ActorMovedEvent::ActorMovedEvent(const ScriptData &eventData) :
 	ScriptableEvent(eventData),
-	actorID(0), systemGen(System_Scripting)
+	actorID(eventData.getInt(Field_ActorId)),
+	newPosition(eventData.getFloat(Field_PositionX), eventData.getFloat(Field_PositionY), eventData.getFloat(Field_PositionZ)),
+	newRotation(eventData.getFloat(Field_RotationX), eventData.getFloat(Field_RotationY),
+				eventData.getFloat(Field_RotationZ), eventData.getFloat(Field_RotationW)),
+	systemGen(System_Scripting) // ignore systemGen property since we already know it's coming from Script
+{}*/
+
+/*---------------------------------------------------------------------
+	Payload is actorID, position xyz, rotation wxyz, systemGen
+---------------------------------------------------------------------*/
+/*void ActorMovedEvent::serialize(BinaryWriter &out) const
 {
-	for (AnyVars::const_iterator i = eventData.begin(); i != eventData.end(); ++i) {
-		try {
-			if (_stricmp(i->first.c_str(), "actorID") == 0) {
-				actorID = any_cast<int>(i->second);
-			} else if (_stricmp(i->first.c_str(), "newPositionX") == 0) {
-				newPosition.x = any_cast<float>(i->second);
-			} else if (_stricmp(i->first.c_str(), "newPositionY") == 0) {
-				newPosition.y = any_cast<float>(i->second);
-			} else if (_stricmp(i->first.c_str(), "newPositionZ") == 0) {
-				newPosition.z = any_cast<float>(i->second);
-			} else if (_stricmp(i->first.c_str(), "newRotationW") == 0) {
-				newRotation.w = any_cast<float>(i->second);
-			} else if (_stricmp(i->first.c_str(), "newRotationX") == 0) {
-				newRotation.x = any_cast<float>(i->second);
-			} else if (_stricmp(i->first.c_str(), "newRotationY") == 0) {
-				newRotation.y = any_cast<float>(i->second);
-			} else if (_stricmp(i->first.c_str(), "newRotationZ") == 0) {
-				newRotation.z = any_cast<float>(i->second);
-			}
-			// ignore systemGen property since we already know it's coming from Script
-		} catch (const boost::bad_any_cast &ex) {
-			// nothing happens with a bad datatype in release build, silently ignores
-			debugPrintf("DeviceChangeEvent: bad_any_cast \"%s\"\n", ex.what());
-		}
-	}
-}*/
\ No newline at end of file
+	out.write(static_cast<int32_t>(actorID));
+	out.write(newPosition.x); out.write(newPosition.y); out.write(newPosition.z);
+	out.write(newRotation.w); out.write(newRotation.x); out.write(newRotation.y); out.write(newRotation.z);
+	out.write(static_cast<uint8_t>(systemGen));
+}
+
+EventPtr ActorMovedEvent::deserialize(BinaryReader &in)
+{
+	int32_t id = 0;
+	float p[3], r[4];
+	uint8_t gen = 0;
+	in.read(id);
+	for (int c = 0; c < 3; ++c) { in.read(p[c]); }
+	for (int c = 0; c < 4; ++c) { in.read(r[c]); }
+	in.read(gen);
+	if (!in.ok()) { return EventPtr(); }
+	return EventManager::make<ActorMovedEvent>(id, Vector3f(p[0], p[1], p[2]),
+											   Quaternion(r[1], r[2], r[3], r[0]),
+											   static_cast<SystemGen>(gen));
+}*/
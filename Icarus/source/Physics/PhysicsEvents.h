@@ -22,7 +22,9 @@ class ActorMovedEvent
 	is capable of moving an actor should also listen for this event and respond
 	to other subsystems moving the same actor by transforming it internally.
 	The listener can check the systemGen parameter in the event to ignore
-	events raised by itself.
+	events raised by itself. The subject is the actor ID, so a listener that
+	follows a few actors subscribes to each with subscribeSubject rather
+	than filtering the moves of every actor.
 =============================================================================*/
 /*class ActorMovedEvent : public ScriptableEvent {
 	public:
@@ -31,10 +33,18 @@ class ActorMovedEvent
 			System_Scripting = 0,
 			System_Physics
 		};
+		// script data field indices, in the order they are added to sScriptSchema
+		enum : ScriptFieldIndex {
+			Field_ActorId = 0,
+			Field_PositionX, Field_PositionY, Field_PositionZ,
+			Field_RotationW, Field_RotationX, Field_RotationY, Field_RotationZ,
+			Field_SystemGen
+		};
 
 		///// VARIABLES /////
 		// Static
 		static const string sEventType;
+		static const ScriptDataSchemaPtr sScriptSchema;
 
 		// Member
 		int			actorID;
@@ -44,8 +54,14 @@ class ActorMovedEvent
 
 		///// FUNCTIONS /////
 		virtual const string & type() const { return sEventType; }
-		virtual void serialize(ostream &out) const {}
-		virtual void deserialize(istream &in) {}
+		virtual uint32_t subject() const { return static_cast<uint32_t>(actorID); } // coalesced per actor
+*/
+		/*---------------------------------------------------------------------
+			Records the actor, transform and systemGen for the EventRecorder,
+			deserialize reads them back for replay
+		---------------------------------------------------------------------*/
+/*		virtual void serialize(BinaryWriter &out) const;
+		static EventPtr deserialize(BinaryReader &in);
 */
 		/*---------------------------------------------------------------------
 			This is called to construct script data out of a code-defined event
@@ -64,7 +80,7 @@ class ActorMovedEvent
 			current values in Engine::mSettings, so if they aren't all supplied
 			by script, the setting will go unchanged.
 		---------------------------------------------------------------------*/
-/*		explicit ActorMovedEvent(const AnyVars &eventData);
+/*		explicit ActorMovedEvent(const ScriptData &eventData);
 
 		// Destructor
 		virtual ~ActorMovedEvent() {}
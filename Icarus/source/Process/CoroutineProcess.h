@@ -0,0 +1,148 @@
+/* CoroutineProcess.h
+Author: Jeff Kiah
+Orig.Date: 10/17/2026
+*/
+#pragma once
+
+#include "Process.h"
+#include "Event/EventListener.h"
+#include <memory>
+
+using std::unique_ptr;
+
+///// DEFINITIONS /////
+
+/*=============================================================================
+	Coroutine body macros, used only inside CoroutineProcess::run. Each wait
+	returns from run and the next call jumps back to the line after it.
+=============================================================================*/
+#define PROC_BEGIN()	switch (mResumeLine) { case 0:
+#define PROC_END()		default: break; } finish()
+
+// resume next frame
+#define PROC_YIELD()	do { mResumeLine = __LINE__; return; case __LINE__:; } while (0)
+
+// resume once condition is true, polled each frame
+#define PROC_AWAIT(condition) \
+	do { while (!(condition)) { PROC_YIELD(); } } while (0)
+
+// resume after millis of update time, checked without entering run
+#define PROC_AWAIT_MILLIS(millis) \
+	do { awaitMillis(millis); PROC_YIELD(); } while (0)
+
+// resume once the process is finished or destroyed, which wakes the coroutine
+#define PROC_AWAIT_PROCESS(procPtr) \
+	do { awaitProcess(procPtr); PROC_YIELD(); } while (0)
+
+// resume once an event of the type is raised or triggered, awaitedEvent() holds it
+#define PROC_AWAIT_EVENT(eventType) \
+	do { awaitEvent(eventType); PROC_YIELD(); } while (0)
+
+// resume once an asynchronous load through the ResHandle succeeds or fails, outResult holds which.
+// Sleeps until the resource's AsyncInitDoneEvent, retrying every 100ms in case it was missed.
+#define PROC_AWAIT_LOAD(TResource, handle, resPath, outResult) \
+	do { while (((outResult) = (handle).tryLoad<TResource>(resPath)) == ResLoadResult_Waiting) { \
+		sleepUntilLoaded(resPath, 100.0); PROC_YIELD(); } } while (0)
+
+///// STRUCTURES /////
+
+/*=============================================================================
+class CoroutineProcess
+	A process written as straight line code that waits, in place of a state
+	machine polled each frame. The body goes in run between PROC_BEGIN and
+	PROC_END, and the PROC_AWAIT macros above suspend it until a timer runs
+	out, another process finishes, an event arrives or a resource loads.
+	Timer, process and event waits are checked by onUpdate without entering
+	run. Attached directly to the ProcessManager, every wait but
+	PROC_AWAIT also puts the process to sleep, so it costs nothing until
+	woken. A process wait sleeps until the awaited process finishes or is
+	destroyed and wakes it, see Process::addFinishWaiter. Unattached or
+	parallel safe, the coroutine checks its wait each update instead.
+	Like a protothread the coroutine is a switch on the line it stopped at,
+	so locals do not survive a wait and should be members instead, and the
+	macros can't be used inside a switch of the body's own. __LINE__ must be
+	a constant, build with /Zi rather than /ZI (edit and continue).
+	Reaching PROC_END finishes the process.
+=============================================================================*/
+class CoroutineProcess : public Process {
+	public:
+		///// DEFINITIONS /////
+		enum AwaitKind : uint8_t {
+			Await_None = 0,
+			Await_Millis,
+			Await_Process,
+			Await_Event
+		};
+
+	private:
+		///// STRUCTURES /////
+		/*---------------------------------------------------------------------
+			Receives the awaited event type for the coroutine, registered
+			only while an event wait is pending
+		---------------------------------------------------------------------*/
+		class AwaitListener : public EventListener {
+			private:
+				CoroutineProcess *	mProcess;
+				IEventHandlerPtr	mHandler;
+				string				mEventType;	// registered type, empty when none
+				bool	handleEvent(const EventPtr &ePtr);
+			public:
+				void	listen(const string &eventType);
+				void	stop();
+				explicit AwaitListener(CoroutineProcess *process);
+				~AwaitListener() { stop(); }
+		};
+
+		///// VARIABLES /////
+		AwaitKind					mAwait;
+		double						mAwaitMillis;	// time left to wait
+		weak_ptr<Process>			mAwaitProcess;
+		EventPtr					mAwaitedEvent;	// event that ended the last event wait, null while waiting
+		unique_ptr<AwaitListener>	mListener;		// created with the first event wait
+
+	protected:
+		///// VARIABLES /////
+		int		mResumeLine;	// line of the wait to resume from, 0 to start
+
+		///// FUNCTIONS /////
+		/*---------------------------------------------------------------------
+			Stops waiting on mAwaitProcess, removing this from its waiters
+		---------------------------------------------------------------------*/
+		void	dropAwaitProcess();
+
+		/*---------------------------------------------------------------------
+			The coroutine body, see the PROC_ macros
+		---------------------------------------------------------------------*/
+		virtual void run(double deltaMillis) = 0;
+
+		/*---------------------------------------------------------------------
+			Resumes run once the pending wait is satisfied
+		---------------------------------------------------------------------*/
+		virtual void onUpdate(double deltaMillis);
+		virtual bool onInitialize() { return true; }
+
+		/*---------------------------------------------------------------------
+			Drops a pending process or event wait. A derived class that
+			overrides this must call the base class version.
+		---------------------------------------------------------------------*/
+		virtual void onFinish();
+		virtual void onTogglePause() {}
+
+		/*---------------------------------------------------------------------
+			Set the wait checked before the next resume, used by the macros
+		---------------------------------------------------------------------*/
+		void	awaitMillis(double millis);
+		void	awaitProcess(const ProcessPtr &procPtr);
+		void	awaitEvent(const string &eventType);
+
+		const EventPtr &	awaitedEvent() const { return mAwaitedEvent; }
+
+	public:
+		AwaitKind	awaiting() const { return mAwait; }
+
+		// Constructor / destructor
+		explicit CoroutineProcess(const string &name,
+								  ProcessRunMode runMode = Process_Run_Frame,
+								  ProcessQueueMode queueMode = Process_Queue_Multiple);
+		virtual ~CoroutineProcess();
+};
@@ -0,0 +1,138 @@
+/* CoroutineProcess.cpp
+Author: Jeff Kiah
+Orig.Date: 10/17/2026
+*/
+#include "Process/CoroutineProcess.h"
+#include "Utility/Debug.h"
+
+////////// class CoroutineProcess::AwaitListener //////////
+
+/*---------------------------------------------------------------------
+	Keeps the first event to arrive, the coroutine picks it up on its
+	next update. Never consumes.
+---------------------------------------------------------------------*/
+bool CoroutineProcess::AwaitListener::handleEvent(const EventPtr &ePtr)
+{
+	if (!mProcess->mAwaitedEvent) { mProcess->mAwaitedEvent = ePtr; }
+	return false;
+}
+
+void CoroutineProcess::AwaitListener::listen(const string &eventType)
+{
+	if (eventType == mEventType) { return; }
+	stop();
+	if (registerEventHandler(eventType, mHandler)) {
+		mEventType = eventType;
+	} else {
+		debugPrintf("CoroutineProcess: \"%s\" could not listen for event type \"%s\"\n", mProcess->name().c_str(), eventType.c_str());
+	}
+}
+
+void CoroutineProcess::AwaitListener::stop()
+{
+	if (mEventType.empty()) { return; }
+	unregisterEventHandler(mEventType);
+	mEventType.clear();
+}
+
+CoroutineProcess::AwaitListener::AwaitListener(CoroutineProcess *process) :
+	EventListener(process->name()),
+	mProcess(process),
+	mHandler(new EventHandler<AwaitListener>(this, &AwaitListener::handleEvent))
+{}
+
+////////// class CoroutineProcess //////////
+
+void CoroutineProcess::onUpdate(double deltaMillis)
+{
+	switch (mAwait) {
+		case Await_Millis:
+			mAwaitMillis -= deltaMillis;
+			if (mAwaitMillis > 0.0) {
+				sleepFor(mAwaitMillis);
+				return;
+			}
+			break;
+
+		case Await_Process: {
+			// woken by something else, or not parked at all, go back to sleep
+			ProcessPtr procPtr(mAwaitProcess.lock());
+			if (procPtr && !procPtr->isFinished()) {
+				if (!isParallelSafe()) { sleepUntilWoken(); }
+				return;
+			}
+			mAwaitProcess.reset();
+			break;
+		}
+		case Await_Event:
+			// a listener ahead of ours may have consumed it, the wakeup still carries it
+			if (!mAwaitedEvent) { mAwaitedEvent = wakeEvent(); }
+			if (!mAwaitedEvent) { return; }
+			// stay registered, a coroutine awaiting the same type again is likely
+			break;
+
+		default:
+			break;
+	}
+	mAwait = Await_None;
+	run(deltaMillis);
+}
+
+void CoroutineProcess::onFinish()
+{
+	mAwait = Await_None;
+	dropAwaitProcess();
+	mListener.reset();
+}
+
+void CoroutineProcess::dropAwaitProcess()
+{
+	ProcessPtr procPtr(mAwaitProcess.lock());
+	if (procPtr) { procPtr->removeFinishWaiter(this); }
+	mAwaitProcess.reset();
+}
+
+void CoroutineProcess::awaitMillis(double millis)
+{
+	mAwait = Await_Millis;
+	mAwaitMillis = millis;
+	sleepFor(millis);
+}
+
+/*---------------------------------------------------------------------
+	A parallel safe coroutine may run in a job, where it can't touch
+	another process's waiters, so it checks each update instead
+---------------------------------------------------------------------*/
+void CoroutineProcess::awaitProcess(const ProcessPtr &procPtr)
+{
+	mAwait = Await_Process;
+	mAwaitProcess = procPtr;
+	if (procPtr && !procPtr->isFinished() && !isParallelSafe()) {
+		procPtr->addFinishWaiter(this);
+		sleepUntilWoken();
+	}
+}
+
+void CoroutineProcess::awaitEvent(const string &eventType)
+{
+	if (!mListener) { mListener.reset(new AwaitListener(this)); }
+	mAwait = Await_Event;
+	mAwaitedEvent.reset();
+	mListener->listen(eventType);
+	sleepUntilEvent(eventType);
+}
+
+// Constructor / destructor
+CoroutineProcess::CoroutineProcess(const string &name,
+								   ProcessRunMode runMode,
+								   ProcessQueueMode queueMode) :
+	Process(name, runMode, queueMode),
+	mAwait(Await_None),
+	mAwaitMillis(0.0),
+	mResumeLine(0)
+{}
+
+CoroutineProcess::~CoroutineProcess()
+{
+	dropAwaitProcess();
+}
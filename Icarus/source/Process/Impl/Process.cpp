@@ -3,8 +3,19 @@ Author: Jeff Kiah
 Orig.Date: 06/17/2012
 */
 #include "Process/ProcessManager.h"
+#include <algorithm>
+#include "Process/ProcessProfiler.h"
+#include "Resource/ResourceProcess.h"
+#include "Utility/JobSystem.h"
 #include "Utility/Debug.h"
 
+///// VARIABLES /////
+
+weak_ptr<JobSystem> Process::sJobSystem;
+#if defined(ICARUS_PROFILE_PROCESSES)
+ProcessProfiler * Process::sProfiler = 0;
+#endif
+
 // class Process
 /*---------------------------------------------------------------------
 	This function is called to perform the main task of the process. If
@@ -14,6 +25,10 @@ Orig.Date: 06/17/2012
 void Process::update(double deltaMillis)
 {
 	if (!isActive() || isPaused()) { return; }
+	mProcessFlags[bitSleepRequested] = false;
+	#if defined(ICARUS_PROFILE_PROCESSES)
+	ProcessProfiler::Scope profileScope(sProfiler, mName);
+	#endif
 
 	if (!isInitialized()) {
 		if (!onInitialize()) {
@@ -25,6 +40,84 @@ void Process::update(double deltaMillis)
 	onUpdate(deltaMillis);
 }
 
+void Process::finish()
+{
+	if (!isFinished()) {
+		mProcessFlags[bitFinished] = true;
+		onFinish();
+		wake();
+		if (!mFinishWaiters.empty()) {
+			// waking touches the ProcessManager, leave it to detach when finished in a job
+			shared_ptr<JobSystem> jobSystem(sJobSystem.lock());
+			if (!jobSystem || !jobSystem->onWorkerThread()) { wakeFinishWaiters(); }
+		}
+	}
+}
+
+void Process::wake()
+{
+	if (isParked()) { mManager->wake(this); }
+}
+
+void Process::wakeFinishWaiters()
+{
+	vector<Process*> waiters;
+	waiters.swap(mFinishWaiters);
+	for (size_t w = 0; w < waiters.size(); ++w) {
+		waiters[w]->wake();
+	}
+}
+
+void Process::addFinishWaiter(Process *waiter)
+{
+	if (std::find(mFinishWaiters.begin(), mFinishWaiters.end(), waiter) == mFinishWaiters.end()) {
+		mFinishWaiters.push_back(waiter);
+	}
+}
+
+void Process::removeFinishWaiter(Process *waiter)
+{
+	vector<Process*>::iterator w = std::find(mFinishWaiters.begin(), mFinishWaiters.end(), waiter);
+	if (w != mFinishWaiters.end()) { mFinishWaiters.erase(w); }
+}
+
+void Process::sleepFor(double millis)
+{
+	_ASSERTE(millis > 0.0);
+	mProcessFlags[bitSleepRequested] = true;
+	mProcessFlags[bitWakeOnEvent] = false;
+	mSleepMillis = millis;
+}
+
+void Process::sleepUntilWoken()
+{
+	mProcessFlags[bitSleepRequested] = true;
+	mProcessFlags[bitWakeOnEvent] = false;
+	mSleepMillis = 0.0;
+}
+
+void Process::sleepUntilEvent(const string &eventType, uint32_t subject, double timeoutMillis)
+{
+	mProcessFlags[bitSleepRequested] = true;
+	mProcessFlags[bitWakeOnEvent] = true;
+	mWakeEventType = eventType;
+	mWakeSubject = subject;
+	mSleepMillis = timeoutMillis;
+}
+
+void Process::sleepUntilLoaded(const wstring &resPath, double timeoutMillis)
+{
+	sleepUntilEvent(AsyncInitDoneEvent::sEventType, resPathSubject(resPath), timeoutMillis);
+}
+
+/*---------------------------------------------------------------------
+	A process destroyed without finishing still ends its waiters' waits
+---------------------------------------------------------------------*/
+Process::~Process()
+{
+	wakeFinishWaiters();
+}
+
 // class ProcessChain
 /*---------------------------------------------------------------------
 	A derived class must explicitly call this base class method, or
@@ -56,17 +149,37 @@ void ProcessChain::onUpdate(double deltaMillis)
 ---------------------------------------------------------------------*/
 void ProcessGroup::onUpdate(double deltaMillis)
 {
+	shared_ptr<JobSystem> jobSystem(sJobSystem.lock());
+	JobSystem::JobCounter counter;
+	m_parallel.clear();
+
 	bool allFinished = true;
-	for (auto i = m_process.begin(); i != m_process.end(); ++i) {
-		Process *p = i->get();
+	for (uint32_t c = 0; c < m_process.size(); ++c) {
+		const ProcessPtr &child = m_process[c];
+		Process *p = child.get();
 		if (!p->isFinished()) {
-			beforeOneUpdate(*i);
+			beforeOneUpdate(child);
+			if (jobSystem && p->isParallelSafe()) {
+				jobSystem->submit([p, deltaMillis]() { p->update(deltaMillis); }, &counter);
+				m_parallel.push_back(c);
+				continue; // its results are checked after the join
+			}
 			p->update(deltaMillis);
-			afterOneUpdate(*i);
-			if (p->isFinished()) { afterOneFinish(*i); }
+			afterOneUpdate(child);
+			if (p->isFinished()) { afterOneFinish(child); }
 		}
 		allFinished = allFinished && p->isFinished();
 	}
+
+	if (!m_parallel.empty()) {
+		jobSystem->waitFor(counter);
+		for (size_t j = 0; j < m_parallel.size(); ++j) {
+			const ProcessPtr &child = m_process[m_parallel[j]];
+			afterOneUpdate(child);
+			if (child->isFinished()) { afterOneFinish(child); }
+			allFinished = allFinished && child->isFinished();
+		}
+	}
 	// if all processes are finished, finish this group
 	if (allFinished) { finish(); }
 }
\ No newline at end of file
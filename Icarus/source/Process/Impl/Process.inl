@@ -12,11 +12,8 @@ inline bool Process::isFinished() const	{
 	return mProcessFlags[bitFinished];
 }
 
-void Process::finish() {
-	if (!isFinished()) {
-		mProcessFlags[bitFinished] = true;
-		onFinish();
-	}
+inline bool Process::isParked() const {
+	return mProcessFlags[bitParked];
 }
 
 inline bool Process::isActive() const {
@@ -50,6 +47,26 @@ inline bool Process::isInitialized() const {
 inline void Process::setInitialized() {
 	mProcessFlags[bitInitialized] = true;
 }
+
+inline bool Process::isParallelSafe() const {
+	return mProcessFlags[bitParallelSafe];
+}
+
+inline void Process::setParallelSafe(bool b) {
+	mProcessFlags[bitParallelSafe] = b;
+}
+		
+inline ProcessRunMode Process::runMode() const {
+	return mRunMode;
+}
+
+inline ProcessQueueMode Process::queueMode() const {
+	return mQueueMode;
+}
+
+inline uint32_t Process::deferrals() const {
+	return mDeferrals;
+}
 		
 inline const string & Process::name() const {
 	return mName;
@@ -59,7 +76,11 @@ inline Process::Process(const string &name,
 						ProcessRunMode runMode,
 						ProcessQueueMode queueMode) :
 	mName(name), mRunMode(runMode), mQueueMode(queueMode),
-	mProcessFlags(0)
+	mProcessFlags(0),
+	mLastUpdateMillis(0.0), mDeferrals(0), mAsyncTurn(0),
+	mManager(0), mSleepMillis(0.0), mWakeSubject(0),
+	mWakeGroup(0), mWakeSlot(0), mSleepId(0),
+	mListSlot(0), mNameGroup(0), mNameSlot(0)
 {
 	mProcessFlags[bitActive] = true;
 }
@@ -0,0 +1,250 @@
+/* ProcessGraph.cpp
+Author: Jeff Kiah
+Orig.Date: 10/17/2026
+*/
+#include "Process/ProcessGraph.h"
+#include <algorithm>
+#include <hash_map>
+#include <boost/thread/thread.hpp>
+#include "Application/Timer.h"
+#include "Utility/Debug.h"
+
+using stdext::hash_map;
+
+///// STRUCTURES /////
+
+/*---------------------------------------------------------------------
+	Who last touched one named piece of data, while the graph is built
+---------------------------------------------------------------------*/
+struct GraphDataState {
+	int32_t				lastWriter;		// -1 for none yet
+	vector<uint32_t>	readersSince;	// readers since lastWriter
+	GraphDataState() : lastWriter(-1) {}
+};
+
+///// FUNCTIONS /////
+
+/*---------------------------------------------------------------------
+	Splits a list of names separated by spaces or commas
+---------------------------------------------------------------------*/
+static void splitNames(const string &names, vector<string> &outNames)
+{
+	outNames.clear();
+	size_t start = names.find_first_not_of(" ,\t");
+	while (start != string::npos) {
+		size_t stop = names.find_first_of(" ,\t", start);
+		outNames.push_back(names.substr(start, stop - start));
+		start = names.find_first_not_of(" ,\t", stop);
+	}
+}
+
+/*---------------------------------------------------------------------
+	Derives the edges from the declared reads and writes, in adding
+	order so every edge points back
+---------------------------------------------------------------------*/
+void ProcessGraph::build()
+{
+	hash_map<string, GraphDataState> data;
+	vector<string> names;
+
+	for (uint32_t n = 0; n < mNodes.size(); ++n) {
+		Node &node = mNodes[n];
+		node.mPredecessors.clear();
+		node.mSuccessors.clear();
+
+		// read after write
+		splitNames(node.mReads, names);
+		for (size_t r = 0; r < names.size(); ++r) {
+			GraphDataState &state = data[names[r]];
+			if (state.lastWriter >= 0) { node.mPredecessors.push_back(state.lastWriter); }
+			state.readersSince.push_back(n);
+		}
+		// write after write and write after read
+		splitNames(node.mWrites, names);
+		for (size_t w = 0; w < names.size(); ++w) {
+			GraphDataState &state = data[names[w]];
+			if (state.lastWriter >= 0) { node.mPredecessors.push_back(state.lastWriter); }
+			for (size_t r = 0; r < state.readersSince.size(); ++r) {
+				if (state.readersSince[r] != n) { node.mPredecessors.push_back(state.readersSince[r]); }
+			}
+			state.lastWriter = n;
+			state.readersSince.clear();
+		}
+
+		std::sort(node.mPredecessors.begin(), node.mPredecessors.end());
+		node.mPredecessors.erase(std::unique(node.mPredecessors.begin(), node.mPredecessors.end()),
+								 node.mPredecessors.end());
+		for (size_t p = 0; p < node.mPredecessors.size(); ++p) {
+			mNodes[node.mPredecessors[p]].mSuccessors.push_back(n);
+		}
+	}
+
+	mPending.reset(new std::atomic<uint32_t>[mNodes.size()]);
+	mSerialReady.reset(new MPSCQueue<uint32_t>(mNodes.size()));
+	mBuilt = true;
+}
+
+void ProcessGraph::ready(uint32_t n)
+{
+	if (mNodes[n].mProcess->isParallelSafe()) {
+		mJobSystem->submit([this, n]() {
+			runNode(n);
+			complete(n);
+		}, &mJobs);
+	} else {
+		mSerialReady->push(n);
+	}
+}
+
+void ProcessGraph::runNode(uint32_t n)
+{
+	Node &node = mNodes[n];
+	node.mMillis = 0.0;
+	if (node.mProcess->isFinished()) { return; }
+
+	int64_t startCounts = Timer::queryCounts();
+	node.mProcess->update(mDeltaMillis);
+	node.mMillis = Timer::secondsSince(startCounts) * 1000.0;
+}
+
+/*---------------------------------------------------------------------
+	Releases the node's successors, the last dependency to finish
+	starts each one. Thread safe.
+---------------------------------------------------------------------*/
+void ProcessGraph::complete(uint32_t n)
+{
+	const vector<uint32_t> &successors = mNodes[n].mSuccessors;
+	for (size_t s = 0; s < successors.size(); ++s) {
+		if (mPending[successors[s]].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+			ready(successors[s]);
+		}
+	}
+	mRemaining.fetch_sub(1, std::memory_order_release);
+}
+
+void ProcessGraph::measureCriticalPath()
+{
+	mFrameStats.criticalPathMillis = 0.0;
+	mFrameStats.workMillis = 0.0;
+	uint32_t last = 0;
+
+	for (uint32_t n = 0; n < mNodes.size(); ++n) {
+		Node &node = mNodes[n];
+		double longest = 0.0;
+		node.mCriticalPrev = n;
+		for (size_t p = 0; p < node.mPredecessors.size(); ++p) {
+			const Node &pred = mNodes[node.mPredecessors[p]];
+			if (pred.mPathMillis > longest) {
+				longest = pred.mPathMillis;
+				node.mCriticalPrev = node.mPredecessors[p];
+			}
+		}
+		node.mPathMillis = longest + node.mMillis;
+		mFrameStats.workMillis += node.mMillis;
+		if (node.mPathMillis > mFrameStats.criticalPathMillis) {
+			mFrameStats.criticalPathMillis = node.mPathMillis;
+			last = n;
+		}
+	}
+
+	mCriticalPath.clear();
+	if (mNodes.empty()) { return; }
+	for (uint32_t n = last; ; n = mNodes[n].mCriticalPrev) {
+		mCriticalPath.push_back(n);
+		if (mNodes[n].mCriticalPrev == n) { break; }
+	}
+	std::reverse(mCriticalPath.begin(), mCriticalPath.end());
+}
+
+void ProcessGraph::logCriticalPath() const
+{
+	debugPrintf("ProcessGraph: \"%s\" critical path %.3fms of %.3fms work, %.3fms wall, %u updated\n",
+				name().c_str(), mFrameStats.criticalPathMillis, mFrameStats.workMillis,
+				mFrameStats.wallMillis, mFrameStats.updated);
+	for (size_t c = 0; c < mCriticalPath.size(); ++c) {
+		const Node &node = mNodes[mCriticalPath[c]];
+		debugPrintf("  \"%s\" %.3fms\n", node.mProcess->name().c_str(), node.mMillis);
+	}
+}
+
+/*---------------------------------------------------------------------
+	A derived class must explicitly call this base class method, or
+	implement the same functionality on its own.
+---------------------------------------------------------------------*/
+void ProcessGraph::onUpdate(double deltaMillis)
+{
+	if (!mBuilt) { build(); }
+	const int64_t startCounts = Timer::queryCounts();
+	const uint32_t numNodes = static_cast<uint32_t>(mNodes.size());
+	mDeltaMillis = deltaMillis;
+	mFrameStats.updated = 0;
+	for (uint32_t n = 0; n < numNodes; ++n) {
+		if (!mNodes[n].mProcess->isFinished()) { ++mFrameStats.updated; }
+	}
+
+	mJobSystem = sJobSystem.lock();
+	if (!mJobSystem) {
+		for (uint32_t n = 0; n < numNodes; ++n) { runNode(n); }
+	} else {
+		// every count is set before the first node can complete and read one
+		mRemaining.store(numNodes, std::memory_order_relaxed);
+		for (uint32_t n = 0; n < numNodes; ++n) {
+			mPending[n].store(static_cast<uint32_t>(mNodes[n].mPredecessors.size()), std::memory_order_relaxed);
+		}
+		for (uint32_t n = 0; n < numNodes; ++n) {
+			if (mNodes[n].mPredecessors.empty()) { ready(n); }
+		}
+
+		while (mRemaining.load(std::memory_order_acquire) > 0) {
+			uint32_t n = 0;
+			if (mSerialReady->tryPop(n)) {
+				runNode(n);
+				complete(n);
+			} else if (!mJobSystem->runOne()) {
+				boost::this_thread::yield();
+			}
+		}
+		// the last jobs may still be on their way out of complete
+		mJobSystem->waitFor(mJobs);
+	}
+	mJobSystem.reset();
+
+	mFrameStats.wallMillis = Timer::secondsSince(startCounts) * 1000.0;
+	measureCriticalPath();
+
+	bool allFinished = true;
+	for (uint32_t n = 0; n < numNodes && allFinished; ++n) {
+		allFinished = mNodes[n].mProcess->isFinished();
+	}
+	if (allFinished) { finish(); }
+}
+
+size_t ProcessGraph::addProcess(const ProcessPtr &p, const string &reads, const string &writes)
+{
+	if (isFinished()) { return 0; }
+	mNodes.push_back(Node());
+	Node &node = mNodes.back();
+	node.mProcess = p;
+	node.mReads = reads;
+	node.mWrites = writes;
+	node.mMillis = 0.0;
+	node.mPathMillis = 0.0;
+	node.mCriticalPrev = static_cast<uint32_t>(mNodes.size() - 1);
+	mBuilt = false;
+	return mNodes.size();
+}
+
+// Constructor / destructor
+ProcessGraph::ProcessGraph(const string &name,
+						   ProcessRunMode runMode,
+						   ProcessQueueMode queueMode) :
+	Process(name, runMode, queueMode),
+	mRemaining(0),
+	mDeltaMillis(0.0),
+	mBuilt(false)
+{
+	memset(&mFrameStats, 0, sizeof(mFrameStats));
+}
+
+ProcessGraph::~ProcessGraph()
+{}
@@ -5,44 +5,373 @@ Orig.Date: 06/09/2012
 
 #include "Process/ProcessManager.h"
 #include "Process.h"
+#include <algorithm>
+#include <hash_set>
+#include "Event/EventListener.h"
+#include "Utility/JobSystem.h"
+#include "Application/Timer.h"
+
+///// STRUCTURES /////
+
+/*=============================================================================
+class ProcessManager::WakeListener
+	Listens for the event types that parked processes wait on. It listens
+	as a wildcard listener, which the EventManager notifies of every event
+	before any listener of the event's own type and whose return value it
+	ignores, so a wake can't be lost to a listener consuming the event,
+	whatever its priority. Events of types no process has waited on are
+	dropped with one lookup. Waking only moves the process back to the
+	list, it updates later in the frame.
+=============================================================================*/
+class ProcessManager::WakeListener : public EventListener {
+	private:
+		ProcessManager &		mManager;
+		hash_set<EventTypeId>	mTypes;		// types waited on so far, kept
+
+		bool handleEvent(const EventPtr &ePtr)
+		{
+			if (mTypes.find(ePtr->typeId()) != mTypes.end()) {
+				mManager.wakeOnEvent(ePtr);
+			}
+			return false;
+		}
+
+	public:
+		void listen(const string &eventType)
+		{
+			mTypes.insert(eventTypeIdOf(eventType));
+		}
+
+		explicit WakeListener(ProcessManager &manager) :
+			EventListener("ProcessManager"),
+			mManager(manager)
+		{
+			if (!registerEventHandler(EventListener::sWildcardType,
+									  IEventHandlerPtr(new EventHandler<WakeListener>(this, &WakeListener::handleEvent))))
+			{
+				debugPrintf("ProcessManager: could not listen for wake events\n");
+			}
+		}
+};
+
+///// FUNCTIONS /////
 
 
 bool ProcessManager::isProcessActive(const string &procName)
 {
-	auto end = mProcessList.end();
-	for (auto i = mProcessList.begin(); i != end; ++i) {
-		if (_stricmp((*i)->name().c_str(), procName.c_str()) == 0) return true;
-	}
-	return false;
+	return (mNameIndex.find(procName) != mNameIndex.end());
 }
 
-void ProcessManager::attach(const ProcessPtr &procPtr)
+bool ProcessManager::attach(const ProcessPtr &procPtr)
 {
-	mProcessList.push_back(procPtr);
+	_ASSERTE(!procPtr->isAttached() && "Process is already attached");
+	NameIndex::iterator n = mNameIndex.find(procPtr->name());
+	if (n != mNameIndex.end()) {
+		vector<Process*> &group = n->second;
+		if (procPtr->queueMode() == Process_Queue_Single) {
+			for (size_t g = 0; g < group.size(); ++g) {
+				if (!group[g]->isFinished()) {
+					debugPrintf("ProcessManager: \"%s\" process not attached, one is already running\n", procPtr->name().c_str());
+					return false;
+				}
+			}
+		} else if (procPtr->queueMode() == Process_Queue_Single_Replace) {
+			// the replaced processes leave the index now, their slots are detached by the next update,
+			// the last one out erases the group
+			for (size_t g = group.size(); g > 0; --g) {
+				Process *p = group[g-1];
+				unindex(p);
+				p->finish();
+			}
+		}
+	}
+	vector<Process*> &group = mNameIndex[procPtr->name()];
+
+	procPtr->mListSlot = static_cast<uint32_t>(mProcessList.mSlots.size());
+	mProcessList.mSlots.push_back(procPtr);
+	procPtr->mManager = this;
+	procPtr->mLastUpdateMillis = mAttachClockMillis;
+	procPtr->mAsyncTurn = 0;
+	procPtr->mNameGroup = &group;
+	procPtr->mNameSlot = static_cast<uint32_t>(group.size());
+	group.push_back(procPtr.get());
 	procPtr->setAttached();
+	return true;
+}
+
+/*---------------------------------------------------------------------
+	Removes the process from its name group by moving the last one of
+	the group into its slot, and erases the group once it is empty. The
+	hash_map is node based, so the other groups' addresses held by their
+	processes stay valid.
+---------------------------------------------------------------------*/
+void ProcessManager::unindex(Process *p)
+{
+	vector<Process*> &group = *p->mNameGroup;
+	Process *last = group.back();
+	group[p->mNameSlot] = last;
+	last->mNameSlot = p->mNameSlot;
+	group.pop_back();
+	p->mNameGroup = 0;
+	if (group.empty()) {
+		mNameIndex.erase(p->name());
+	}
+}
+
+void ProcessManager::unindexWake(Process *p)
+{
+	vector<Process*> &group = *p->mWakeGroup;
+	Process *last = group.back();
+	group[p->mWakeSlot] = last;
+	last->mWakeSlot = p->mWakeSlot;
+	group.pop_back();
+	p->mWakeGroup = 0;
+}
+
+void ProcessManager::moveSlot(Process *p, ProcessSlots &from, ProcessSlots &to)
+{
+	ProcessPtr &slot = from.mSlots[p->mListSlot];
+	_ASSERTE(slot.get() == p);
+	p->mListSlot = static_cast<uint32_t>(to.mSlots.size());
+	to.mSlots.push_back(ProcessPtr());
+	to.mSlots.back().swap(slot);
+	++from.mHoles;
 }
 
+void ProcessManager::compact(ProcessSlots &list)
+{
+	if (list.mHoles == 0) { return; }
+	vector<ProcessPtr> &slots = list.mSlots;
+	uint32_t kept = 0;
+	for (uint32_t s = 0; s < slots.size(); ++s) {
+		if (!slots[s]) { continue; }
+		if (s != kept) {
+			slots[kept].swap(slots[s]);
+			slots[kept]->mListSlot = kept;
+		}
+		++kept;
+	}
+	// the slots past kept are all null, so this destroys nothing and keeps the capacity
+	slots.resize(kept);
+	list.mHoles = 0;
+}
+
+/*---------------------------------------------------------------------
+	procPtr may be the slot's own reference to the process, so nulling
+	the slot comes last
+---------------------------------------------------------------------*/
 void ProcessManager::detach(const ProcessPtr &procPtr)
 {
+	_ASSERTE(!procPtr->isParked());
+	// waiters left by a finish in a job, woken before the slot's reference goes
+	if (!procPtr->mFinishWaiters.empty()) { procPtr->wakeFinishWaiters(); }
+	if (procPtr->mNameGroup) { unindex(procPtr.get()); }
+	procPtr->mManager = 0;
 	procPtr->setAttached(false);
-	debugPrintf("ProcessManager: \"%s\" process detached: %i running\n", procPtr->name().c_str(), mProcessList.size()-1);
-	mProcessList.remove(procPtr);
+	debugPrintf("ProcessManager: \"%s\" process detached: %u running\n", procPtr->name().c_str(), mProcessList.count()-1);
+	++mProcessList.mHoles;
+	mProcessList.mSlots[procPtr->mListSlot].reset();
+}
+
+double ProcessManager::elapsedSinceUpdate(Process *p)
+{
+	double elapsedMillis = mClockMillis - p->mLastUpdateMillis;
+	p->mLastUpdateMillis = mClockMillis;
+	++mFrameStats.updated;
+	return elapsedMillis;
+}
+
+void ProcessManager::updateOne(Process *p)
+{
+	p->update(elapsedSinceUpdate(p));
+	if (p->mProcessFlags[Process::bitSleepRequested]) { park(p); }
+}
+
+/*---------------------------------------------------------------------
+	Moves the process to the parked list and files it under its wake
+	conditions
+---------------------------------------------------------------------*/
+void ProcessManager::park(Process *p)
+{
+	p->mProcessFlags[Process::bitSleepRequested] = false;
+	if (p->isFinished()) { return; } // detached instead
+
+	p->mProcessFlags[Process::bitParked] = true;
+	p->mWakeEvent.reset();
+	++p->mSleepId;
+	moveSlot(p, mProcessList, mParkedList);
+
+	if (p->mProcessFlags[Process::bitWakeOnEvent]) {
+		if (!mWakeListener) { mWakeListener.reset(new WakeListener(*this)); }
+		mWakeListener->listen(p->mWakeEventType);
+		vector<Process*> &group = mWakeIndex[eventSubjectKey(eventTypeIdOf(p->mWakeEventType), p->mWakeSubject)];
+		p->mWakeGroup = &group;
+		p->mWakeSlot = static_cast<uint32_t>(group.size());
+		group.push_back(p);
+	}
+	if (p->mSleepMillis > 0.0) {
+		TimedWake timedWake = { mClockMillis + p->mSleepMillis, p->mSleepId, mParkedList.mSlots[p->mListSlot] };
+		mTimedWakes.push(timedWake);
+	}
 }
 
-void ProcessManager::updateProcesses(double deltaMillis)
+void ProcessManager::wake(Process *p)
 {
-	auto i = mProcessList.begin(), end = mProcessList.end();
+	_ASSERTE(p->isParked() && p->mManager == this);
+	p->mProcessFlags[Process::bitParked] = false;
+	if (p->mWakeGroup) { unindexWake(p); }
+	moveSlot(p, mParkedList, mProcessList);
+	++mWokenCount;
+}
+
+void ProcessManager::wakeTimedOut()
+{
+	while (!mTimedWakes.empty() && mTimedWakes.top().mWakeMillis <= mClockMillis) {
+		ProcessPtr procPtr(mTimedWakes.top().mProcess.lock());
+		uint32_t sleepId = mTimedWakes.top().mSleepId;
+		mTimedWakes.pop();
+		// skip timeouts of sleeps that already ended
+		if (procPtr && procPtr->isParked() && procPtr->mSleepId == sleepId) {
+			wake(procPtr.get());
+		}
+	}
+}
+
+void ProcessManager::wakeGroup(uint64_t wakeKey, const EventPtr &ePtr)
+{
+	WakeIndex::iterator w = mWakeIndex.find(wakeKey);
+	if (w == mWakeIndex.end()) { return; }
+	vector<Process*> &group = w->second;
+	while (!group.empty()) {
+		Process *p = group.back();
+		p->mWakeEvent = ePtr;
+		wake(p);
+	}
+}
+
+void ProcessManager::wakeOnEvent(const EventPtr &ePtr)
+{
+	EventTypeId eventTypeId = ePtr->typeId();
+	wakeGroup(eventSubjectKey(eventTypeId, 0), ePtr);
+	if (ePtr->subject() != 0) {
+		wakeGroup(eventSubjectKey(eventTypeId, ePtr->subject()), ePtr);
+	}
+}
+
+void ProcessManager::runParallelBatch()
+{
+	if (mParallelBatch.empty()) { return; }
+	if (!mJobSystem || mParallelBatch.size() == 1) {
+		for (size_t b = 0; b < mParallelBatch.size(); ++b) {
+			updateOne(mParallelBatch[b]);
+		}
+	} else {
+		JobSystem::JobCounter counter;
+		for (size_t b = 1; b < mParallelBatch.size(); ++b) {
+			Process *p = mParallelBatch[b];
+			double elapsedMillis = elapsedSinceUpdate(p);
+			mJobSystem->submit([p, elapsedMillis]() { p->update(elapsedMillis); }, &counter);
+		}
+		// the main thread takes the first process rather than idle until the workers pick up
+		mParallelBatch[0]->update(elapsedSinceUpdate(mParallelBatch[0]));
+		mJobSystem->waitFor(counter);
+
+		for (size_t b = 0; b < mParallelBatch.size(); ++b) {
+			if (mParallelBatch[b]->mProcessFlags[Process::bitSleepRequested]) { park(mParallelBatch[b]); }
+		}
+	}
+	mParallelBatch.clear();
+}
+
+void ProcessManager::runAsyncProcesses(int64_t startCounts, double budgetMillis)
+{
+	const size_t count = mAsyncList.size();
+	const int64_t budgetCounts = static_cast<int64_t>(budgetMillis * Timer::timerFreq() / 1000.0);
+	// The list is gathered in slot order, which attach, detach, parking and compaction change from
+	// frame to frame, so fairness is kept per process instead: each async update is numbered, and
+	// the process whose last turn is oldest goes first, new ones before all. Processes deferred
+	// this frame are then ahead of every one that ran, and nobody waits more than one full round.
+	std::stable_sort(mAsyncList.begin(), mAsyncList.end(),
+					 [](const Process *a, const Process *b) { return a->mAsyncTurn < b->mAsyncTurn; });
+
+	size_t ran = 0;
+	for (; ran < count; ++ran) {
+		if (ran > 0 && Timer::queryCounts() - startCounts >= budgetCounts) { break; }
+		mAsyncList[ran]->mAsyncTurn = ++mAsyncTurns;
+		updateOne(mAsyncList[ran]);
+	}
+	for (size_t d = ran; d < count; ++d) {
+		++mAsyncList[d]->mDeferrals;
+	}
+	if (ran < count) { ++mFramesOverBudget; }
+
+	mAsyncList.clear();
+}
+
+void ProcessManager::updateProcesses(double deltaMillis, double budgetMillis)
+{
+	const int64_t startCounts = Timer::queryCounts();
+	mClockMillis += deltaMillis;
+	mFrameStats.updated = 0;
+	wakeTimedOut();
+
+	// by index, processes attached or woken during the walk are appended and reached this frame
+	for (size_t i = 0; i < mProcessList.mSlots.size(); ++i) {
+		Process *p = mProcessList.mSlots[i].get();
+		if (!p) { continue; }
 
-	while (i != end) {
-		ProcessPtr &p = (*i);
-		++i;
-		
 		if (p->isFinished()) {
-			detach(p);
+			detach(mProcessList.mSlots[i]);
+		} else if (budgetMillis > 0.0 && p->runMode() == Process_Run_Async) {
+			mAsyncList.push_back(p);
+		} else if (p->isParallelSafe()) {
+			mParallelBatch.push_back(p);
 		} else {
-			p->update(deltaMillis);
+			// a serial process may depend on anything before it, join first
+			runParallelBatch();
+			updateOne(p);
+		}
+	}
+	runParallelBatch();
+
+	if (!mAsyncList.empty()) {
+		runAsyncProcesses(startCounts, budgetMillis);
+	}
+
+	compact(mProcessList);
+	if (mParkedList.mHoles > mParkedList.count()) { compact(mParkedList); }
+
+	#if defined(ICARUS_PROFILE_PROCESSES)
+	mProfiler->endFrame();
+	#endif
+
+	mFrameStats.parked = mParkedList.count();
+	mFrameStats.woken = mWokenCount;
+	mWokenCount = 0;
+	mAttachClockMillis = mClockMillis;
+}
+
+void ProcessManager::logStats() const
+{
+	debugPrintf("ProcessManager: last frame %u updated, %u parked, %u woken, %llu frames over budget\n",
+				mFrameStats.updated, mFrameStats.parked, mFrameStats.woken, mFramesOverBudget);
+	const ProcessSlots *lists[2] = { &mProcessList, &mParkedList };
+	for (int l = 0; l < 2; ++l) {
+		const vector<ProcessPtr> &slots = lists[l]->mSlots;
+		for (size_t s = 0; s < slots.size(); ++s) {
+			if (slots[s] && slots[s]->deferrals() > 0) {
+				debugPrintf("  \"%s\" deferred %u frames\n", slots[s]->name().c_str(), slots[s]->deferrals());
+			}
 		}
 	}
+	SlabPool::Stats allocStats = getAllocStats();
+	debugPrintf("ProcessManager: %u of %u process slots used, %llu pooled processes made, %lld bytes in use\n",
+				mProcessList.count() + mParkedList.count(),
+				static_cast<uint32_t>(mProcessList.mSlots.capacity() + mParkedList.mSlots.capacity()),
+				allocStats.allocations, allocStats.bytesInUse);
+	#if defined(ICARUS_PROFILE_PROCESSES)
+	mProfiler->log();
+	#endif
 }
 
 /*---------------------------------------------------------------------
@@ -50,5 +379,46 @@ void ProcessManager::updateProcesses(double deltaMillis)
 ---------------------------------------------------------------------*/
 void ProcessManager::clear()
 {
-	mProcessList.clear();
+	ProcessSlots *lists[2] = { &mProcessList, &mParkedList };
+	for (int l = 0; l < 2; ++l) {
+		vector<ProcessPtr> &slots = lists[l]->mSlots;
+		for (size_t s = 0; s < slots.size(); ++s) {
+			if (!slots[s]) { continue; }
+			Process &p = *slots[s];
+			p.mNameGroup = 0;
+			p.mWakeGroup = 0;
+			p.mManager = 0;
+			p.mProcessFlags[Process::bitParked] = false;
+			p.setAttached(false);
+		}
+	}
+	mNameIndex.clear();
+	mWakeIndex.clear();
+	mTimedWakes = TimedWakeQueue();
+	mParkedList = ProcessSlots();
+	mProcessList = ProcessSlots();
+}
+
+ProcessManager::ProcessManager(const shared_ptr<JobSystem> &jobSystem) :
+	mJobSystem(jobSystem),
+	mClockMillis(0.0),
+	mAttachClockMillis(0.0),
+	mWokenCount(0),
+	mAsyncTurns(0),
+	mFramesOverBudget(0)
+{
+	Process::sJobSystem = jobSystem;
+	memset(&mFrameStats, 0, sizeof(mFrameStats));
+	#if defined(ICARUS_PROFILE_PROCESSES)
+	mProfiler.reset(new ProcessProfiler());
+	Process::sProfiler = mProfiler.get();
+	#endif
+}
+
+ProcessManager::~ProcessManager()
+{
+	clear();
+	#if defined(ICARUS_PROFILE_PROCESSES)
+	if (Process::sProfiler == mProfiler.get()) { Process::sProfiler = 0; }
+	#endif
 }
@@ -0,0 +1,153 @@
+/* ProcessProfiler.cpp
+Author: Jeff Kiah
+Orig.Date: 10/17/2026
+*/
+#include "Process/ProcessProfiler.h"
+
+#if defined(ICARUS_PROFILE_PROCESSES)
+
+#include <algorithm>
+#include "Utility/Debug.h"
+
+///// FUNCTIONS /////
+
+static double countsToMillis(uint64_t counts)
+{
+	return counts * Timer::secondsPerCount() * 1000.0;
+}
+
+static bool costlierTimings(const ProcessProfiler::ProcessTimings &a, const ProcessProfiler::ProcessTimings &b)
+{
+	return (a.avgMillis > b.avgMillis);
+}
+
+ProcessProfiler::ThreadBuffer & ProcessProfiler::localBuffer()
+{
+	ThreadBuffer *buffer = mLocalBuffer.get();
+	if (!buffer) {
+		buffer = new ThreadBuffer();
+		boost::mutex::scoped_lock lock(mBuffersMutex);
+		mBuffers.push_back(unique_ptr<ThreadBuffer>(buffer));
+		mLocalBuffer.reset(buffer);
+	}
+	return *buffer;
+}
+
+void ProcessProfiler::record(const string &name, int64_t counts)
+{
+	ThreadBuffer &buffer = localBuffer();
+	boost::mutex::scoped_lock lock(buffer.mMutex);
+	ThreadTimes::iterator t = buffer.mTimes.find(name);
+	if (t == buffer.mTimes.end()) {
+		ThreadTime zero = { 0, 0 };
+		t = buffer.mTimes.insert(ThreadTimes::value_type(name, zero)).first;
+	}
+	t->second.counts += (counts > 0 ? counts : 0);
+	++t->second.updates;
+}
+
+void ProcessProfiler::endFrame()
+{
+	// zero last frame's times, then gather this frame's
+	NameStatsMap::iterator s;
+	for (s = mStats.begin(); s != mStats.end(); ++s) {
+		s->second.mLastFrameCounts = -1;
+	}
+	{
+		boost::mutex::scoped_lock buffersLock(mBuffersMutex);
+		for (size_t b = 0; b < mBuffers.size(); ++b) {
+			ThreadBuffer &buffer = *mBuffers[b];
+			boost::mutex::scoped_lock lock(buffer.mMutex);
+			ThreadTimes::iterator t, tEnd = buffer.mTimes.end();
+			for (t = buffer.mTimes.begin(); t != tEnd; ++t) {
+				if (t->second.updates == 0) { continue; }
+				NameStats &stats = mStats[t->first];
+				if (stats.mLastFrameCounts < 0) { stats.mLastFrameCounts = 0; }
+				stats.mLastFrameCounts += t->second.counts;
+				t->second.counts = 0;
+				t->second.updates = 0;
+			}
+		}
+	}
+
+	const int64_t thresholdCounts = static_cast<int64_t>(mThresholdMillis * Timer::timerFreq() / 1000.0);
+	for (s = mStats.begin(); s != mStats.end(); ++s) {
+		NameStats &stats = s->second;
+		if (stats.mLastFrameCounts < 0) {
+			stats.mLastFrameCounts = 0;
+			continue;
+		}
+		stats.mWindow.record(stats.mLastFrameCounts);
+		if (stats.mLastFrameCounts > thresholdCounts) {
+			++stats.mOverThreshold;
+			if (!stats.mFlagged) {
+				stats.mFlagged = true;
+				debugPrintf("ProcessProfiler: \"%s\" took %.3fms, over the %.3fms threshold\n",
+							s->first.c_str(), countsToMillis(stats.mLastFrameCounts), mThresholdMillis);
+			}
+		}
+	}
+
+	++mFrames;
+	if (mFrames % mWindowFrames == 0) {
+		for (s = mStats.begin(); s != mStats.end(); ++s) {
+			s->second.mLastWindow = s->second.mWindow;
+			s->second.mWindow.reset();
+			s->second.mFlagged = false;
+		}
+		if (mPeriodicLog) { log(); }
+	}
+}
+
+void ProcessProfiler::getTimings(vector<ProcessTimings> &outTimings) const
+{
+	outTimings.clear();
+	NameStatsMap::const_iterator s, end = mStats.end();
+	for (s = mStats.begin(); s != end; ++s) {
+		const NameStats &stats = s->second;
+		const LatencyHistogram &h = (stats.mLastWindow.count() > 0 ? stats.mLastWindow : stats.mWindow);
+		if (h.count() == 0) { continue; }
+
+		ProcessTimings timings;
+		timings.name = s->first;
+		timings.frames = h.count();
+		timings.minMillis = countsToMillis(h.minValue());
+		timings.avgMillis = h.mean() * Timer::secondsPerCount() * 1000.0;
+		timings.p99Millis = countsToMillis(h.percentile(99.0));
+		timings.maxMillis = countsToMillis(h.maxValue());
+		timings.lastFrameMillis = countsToMillis(stats.mLastFrameCounts);
+		timings.framesOverThreshold = stats.mOverThreshold;
+		outTimings.push_back(timings);
+	}
+	std::sort(outTimings.begin(), outTimings.end(), costlierTimings);
+}
+
+void ProcessProfiler::log(size_t maxEntries) const
+{
+	vector<ProcessTimings> timings;
+	getTimings(timings);
+	debugPrintf("ProcessProfiler: %u frame window, %llu frames, costliest processes:\n", mWindowFrames, mFrames);
+	for (size_t t = 0; t < timings.size() && t < maxEntries; ++t) {
+		const ProcessTimings &pt = timings[t];
+		debugPrintf("  \"%s\" min %.3fms avg %.3fms p99 %.3fms max %.3fms, %llu frames over threshold\n",
+					pt.name.c_str(), pt.minMillis, pt.avgMillis, pt.p99Millis, pt.maxMillis,
+					pt.framesOverThreshold);
+	}
+}
+
+void ProcessProfiler::reset()
+{
+	mStats.clear();
+	mFrames = 0;
+}
+
+// Constructor
+ProcessProfiler::ProcessProfiler(double thresholdMillis, uint32_t windowFrames) :
+	mLocalBuffer(&ProcessProfiler::noCleanup),
+	mThresholdMillis(thresholdMillis),
+	mWindowFrames(windowFrames > 0 ? windowFrames : 1),
+	mFrames(0),
+	mPeriodicLog(true)
+{}
+
+#endif
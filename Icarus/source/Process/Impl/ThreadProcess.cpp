@@ -4,11 +4,16 @@ Orig.Date: 06/09/2012
 */
 #include "Process/ThreadProcess.h"
 
+///// VARIABLES /////
+
+weak_ptr<ThreadPool> ThreadProcess::sThreadPool;
+
 ////////// class ThreadProcess //////////
 
 /*---------------------------------------------------------------------
-	This begins thread execution by contructing a new thread in the
-	member variable, passing (this) as data.
+	This begins thread execution by starting threadProc as a pool
+	task, or by contructing a new thread in the member variable,
+	passing (this) as data.
 	**NOTE**
 	A derived class can override this function if necessary, but MUST
 	explicitly call this base class version of the function within it,
@@ -16,17 +21,29 @@ Orig.Date: 06/09/2012
 ---------------------------------------------------------------------*/
 bool ThreadProcess::onInitialize() // return false if initialization fails, finishes process
 {
+	mPool = sThreadPool.lock();
+	if (mPool) {
+		mTask = mPool->start([this]() { threadProc(); }, name(), mThreadClass);
+		debugPrintf("ThreadProcess: \"%s\" started on the thread pool\n", name().c_str());
+		return true;
+	}
 	mThread = thread(&ThreadProcess::threadProc, this);
 	mThreadID = mThread.get_id();
 	debugPrintf("ThreadProcess: \"%s\" started\n", name().c_str());
 	return true;
 }
 
+thread::id ThreadProcess::threadID() const
+{
+	return (mTask ? mPool->threadId(mTask) : mThreadID);
+}
+
 // Constructor
-ThreadProcess::ThreadProcess(const string &name) :
+ThreadProcess::ThreadProcess(const string &name, ThreadClass threadClass) :
 	Process(name, Process_Run_Frame, Process_Queue_Single), // although async in nature, use run_frame because onUpdate must run every frame
 	mThread(), // construct a Not-a-Thread object, onInitialize() will swap in the running thread
 	mThreadID(mThread.get_id()),
+	mThreadClass(threadClass),
 	mKillThread(false)
 {}
 
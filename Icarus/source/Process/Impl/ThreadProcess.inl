@@ -16,6 +16,11 @@ Orig.Date: 05/30/2012
 ---------------------------------------------------------------------*/
 inline void	ThreadProcess::onFinish()
 {
+	if (mTask) {
+		mPool->join(mTask);
+		mTask.reset();
+		mPool.reset();
+	}
 	if (mThread.joinable()) mThread.join();
 	debugPrintf("ThreadProcess: \"%s\" onFinish called\n", name().c_str());
 }
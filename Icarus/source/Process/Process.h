@@ -13,14 +13,17 @@ Orig.Date: 05/30/2012
 #include <boost/noncopyable.hpp>
 
 using std::string;
+using std::wstring;
 using std::vector;
 using std::list;
 using std::shared_ptr;
 using std::weak_ptr;
 using std::bitset;
 
-// ** NOTE **
-// The settings controlled by these enums are not implemented yet
+// update times are profiled in debug and tools builds only, shipping builds define neither
+#if defined(_DEBUG) || defined(ICARUS_DEV_TOOLS)
+#define ICARUS_PROFILE_PROCESSES
+#endif
 
 enum ProcessQueueMode : uint8_t {
 	Process_Queue_Multiple = 0,		// will allow multiple processes of same type in the list
@@ -35,33 +38,87 @@ enum ProcessRunMode : uint8_t {
 
 class Process;
 class ProcessManager;
+class JobSystem;
+class ProcessProfiler;
+class Event;
 typedef shared_ptr<Process>		ProcessPtr;
 typedef vector<ProcessPtr>		ProcessList;
-typedef list<ProcessPtr>		ProcessLinkedList;
 typedef shared_ptr<ProcessManager>	SchedulerPtr;
 typedef weak_ptr<ProcessManager>	SchedulerWeakPtr;
 
 /*=============================================================================
 class Process
+	A process that declares itself parallel safe may be updated on a
+	JobSystem worker, concurrently with other parallel safe processes and
+	with the serial processes of its ProcessGroup. Its onUpdate, and
+	onInitialize and onFinish which can run from it, must then touch only
+	the process's own data or data it synchronizes itself, must not attach or
+	detach processes, and must send events with raiseThreadSafe. The
+	ProcessManager joins a run of parallel safe processes before the next
+	serial one updates, so serial processes later in the list see their
+	results.
+	A process with nothing to do until something happens can sleep instead
+	of checking each frame. It asks for a wake condition during its update,
+	and the ProcessManager parks it afterward and stops updating it until an
+	event arrives, a resource load finishes, a timeout passes, or it is woken
+	or finished by other code. The update after waking is passed all the
+	time that went by while it slept.
 =============================================================================*/
 class Process : private boost::noncopyable {
+	friend class ProcessManager;
 	protected:
 		///// VARIABLES /////
-		bitset<5>			mProcessFlags;
+		static weak_ptr<JobSystem>	sJobSystem;	// set by the ProcessManager, null runs everything serially
+		#if defined(ICARUS_PROFILE_PROCESSES)
+		static ProcessProfiler *	sProfiler;	// set by the ProcessManager, times every update
+		#endif
+
+		bitset<9>			mProcessFlags;
 		ProcessRunMode		mRunMode;
 		ProcessQueueMode	mQueueMode;
 		const string		mName;
 
+		// update timing, kept by the ProcessManager
+		double				mLastUpdateMillis;	// manager clock at the last update, or at attach
+		uint32_t			mDeferrals;			// frames this process was deferred for lack of budget
+		uint64_t			mAsyncTurn;			// ProcessManager's async update count at its last async update, 0 before
+
+		// sleeping, requested by the process and carried out by the ProcessManager
+		ProcessManager *	mManager;			// the manager attached to, null when detached
+		double				mSleepMillis;		// timeout of the requested sleep, 0 for none
+		string				mWakeEventType;		// event type of the requested sleep, when bitWakeOnEvent
+		uint32_t			mWakeSubject;		// subject of the event, 0 for any
+		vector<Process*> *	mWakeGroup;			// processes parked on the same event, null when not waiting on one
+		uint32_t			mWakeSlot;			// position in mWakeGroup
+		uint32_t			mSleepId;			// bumped each time the process parks, marks stale timeouts
+		shared_ptr<Event>	mWakeEvent;			// event that woke the process, null if woken otherwise
+		vector<Process*>	mFinishWaiters;		// processes to wake when this one finishes or is destroyed
+
+		// positions in the ProcessManager's arrays and name index, so attach and detach are constant time
+		uint32_t					mListSlot;	// position in the run or parked array, valid while attached
+		vector<Process*> *			mNameGroup;	// attached processes of the same name, null when not indexed
+		uint32_t					mNameSlot;	// position in mNameGroup
+
 		///// DEFINITIONS /////
 		enum CProcessFlagBits : uint8_t {
 			bitFinished = 0,
 			bitActive,
 			bitPaused,
 			bitInitialized,
-			bitAttached
+			bitAttached,
+			bitParallelSafe,
+			bitSleepRequested,	// park after this update
+			bitWakeOnEvent,		// the requested sleep waits for mWakeEventType
+			bitParked
 		};
 
 		///// FUNCTIONS /////
+		/*---------------------------------------------------------------------
+			Wakes and forgets the finish waiters, deferred by finish to the
+			ProcessManager's detach when called from a JobSystem worker
+		---------------------------------------------------------------------*/
+		void wakeFinishWaiters();
+
 		/*---------------------------------------------------------------------
 			As part of a cooperative multitasking system, these functions are
 			responsible for returning control to the main loop without hogging
@@ -73,6 +130,32 @@ class Process : private boost::noncopyable {
 		virtual void onFinish() = 0;
 		virtual void onTogglePause() = 0;
 
+		/*---------------------------------------------------------------------
+			Derived classes that meet the constraints above call this from
+			their constructor to be updated as a job
+		---------------------------------------------------------------------*/
+		inline void setParallelSafe(bool b = true);
+
+		/*---------------------------------------------------------------------
+			Call during an update to sleep once it returns, until the wake
+			condition is met. timeoutMillis wakes the process anyway after
+			that long, 0 for no timeout. The event waits may be given a
+			subject to wake only for that subject's events. sleepUntilLoaded
+			takes the same path passed to ResHandle::tryLoad and wakes when
+			the load finishes, successful or not, so call tryLoad again.
+			Processes that aren't attached to a ProcessManager, such as the
+			children of a group or chain, are never put to sleep.
+		---------------------------------------------------------------------*/
+		void sleepFor(double millis);
+		void sleepUntilWoken();
+		void sleepUntilEvent(const string &eventType, uint32_t subject = 0, double timeoutMillis = 0.0);
+		void sleepUntilLoaded(const wstring &resPath, double timeoutMillis = 0.0);
+
+		/*---------------------------------------------------------------------
+			The event that ended the last sleep, null if it ended another way
+		---------------------------------------------------------------------*/
+		const shared_ptr<Event> &	wakeEvent() const { return mWakeEvent; }
+
 	public:
 		/*---------------------------------------------------------------------
 			This function is called to perform the main task of the process. If
@@ -83,7 +166,25 @@ class Process : private boost::noncopyable {
 
 		// Getters and setters
 		inline bool isFinished() const;
-		inline void finish();
+		void finish();
+
+		/*---------------------------------------------------------------------
+			Wakes a sleeping process so it updates again from the next visit,
+			call from the main thread. Finishing a process also wakes it so
+			the ProcessManager can detach it.
+		---------------------------------------------------------------------*/
+		void wake();
+		inline bool isParked() const;
+
+		/*---------------------------------------------------------------------
+			Has waiter woken when this process finishes or is destroyed, so it
+			can sleep until then. A process finished by a JobSystem job wakes
+			its waiters once the ProcessManager detaches it, or once destroyed
+			if it isn't attached. Main thread only, a waiter destroyed first
+			must remove itself.
+		---------------------------------------------------------------------*/
+		void addFinishWaiter(Process *waiter);
+		void removeFinishWaiter(Process *waiter);
 
 		inline bool isActive() const;
 		inline void setActive(bool b = true);
@@ -96,6 +197,12 @@ class Process : private boost::noncopyable {
 		
 		inline bool isInitialized() const;
 		inline void setInitialized();
+
+		inline bool isParallelSafe() const;
+
+		inline ProcessRunMode runMode() const;
+		inline ProcessQueueMode queueMode() const;
+		inline uint32_t deferrals() const;
 		
 		inline const string & name() const;
 
@@ -103,7 +210,7 @@ class Process : private boost::noncopyable {
 		inline explicit Process(const string &name,
 								ProcessRunMode runMode = Process_Run_Async,
 								ProcessQueueMode queueMode = Process_Queue_Multiple);
-		virtual ~Process() {}
+		virtual ~Process();
 };
 
 
@@ -148,10 +255,16 @@ class ProcessChain : public Process {
 class ProcessGroup
 	A process that contains a list of subprocesses (incl. chains and groups)
 	where all must be finished before this process will be finished.
+	Parallel safe children are submitted as jobs while the other children
+	update on the group's thread, and the group joins them before it
+	finishes its update. Hooks always run on the group's thread, but those
+	of a parallel child are deferred: beforeOneUpdate runs when the job is
+	submitted, afterOneUpdate and afterOneFinish after the join.
 =============================================================================*/
 class ProcessGroup : public Process {
 	protected:
-		ProcessList	m_process;
+		ProcessList			m_process;
+		vector<uint32_t>	m_parallel;	// children submitted as jobs this update, kept to reuse its memory
 
 		/*---------------------------------------------------------------------
 			A derived class must explicitly call this base class method, or
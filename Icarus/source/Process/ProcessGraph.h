@@ -0,0 +1,122 @@
+/* ProcessGraph.h
+Author: Jeff Kiah
+Orig.Date: 10/17/2026
+*/
+#pragma once
+
+#include <atomic>
+#include "Process.h"
+#include "Utility/JobSystem.h"
+#include "Utility/LockFreeQueue.h"
+
+using std::unique_ptr;
+
+///// STRUCTURES /////
+
+/*=============================================================================
+class ProcessGraph
+	A process that updates its subprocesses once a frame as a task graph.
+	Each subprocess is added with the names of the data it reads and writes,
+	and the graph orders it after the last writer of anything it reads, and
+	after the last writer and every reader since of anything it writes, so
+	a frame like
+		addProcess(input,     "",                "input");
+		addProcess(physics,   "input",           "bodies");
+		addProcess(animation, "input",           "poses");
+		addProcess(transform, "bodies poses",    "transforms");
+		addProcess(culling,   "transforms",      "visible");
+		addProcess(submit,    "visible",         "");
+	runs physics and animation side by side and the rest in sequence.
+	Dependencies only point back to earlier processes, so the graph can't
+	have a cycle and adding order is a valid serial order.
+	A subprocess starts as soon as its last dependency finishes its update:
+	parallel safe ones as JobSystem jobs, others on the graph's own thread,
+	which helps run jobs while it has nothing of its own ready. Without a
+	JobSystem everything updates in adding order.
+	Each update is timed, and the critical path, the longest chain of
+	dependent updates, is the least the frame could take however many cores
+	there are. Compare it with the summed work to see how much parallelism
+	the declared dependencies leave. Finished subprocesses stay in the graph
+	and keep ordering the others, the graph finishes when all have.
+=============================================================================*/
+class ProcessGraph : public Process {
+	public:
+		///// DEFINITIONS /////
+		/*---------------------------------------------------------------------
+			Timing of the last update
+		---------------------------------------------------------------------*/
+		struct FrameStats {
+			double		criticalPathMillis;	// longest chain of dependent updates
+			double		workMillis;			// sum of all updates
+			double		wallMillis;			// time the whole graph took
+			uint32_t	updated;			// subprocesses updated
+		};
+
+	private:
+		///// STRUCTURES /////
+		struct Node {
+			ProcessPtr			mProcess;
+			string				mReads;
+			string				mWrites;
+			vector<uint32_t>	mPredecessors;
+			vector<uint32_t>	mSuccessors;
+			double				mMillis;		// last update's time, written by the thread that ran it
+			double				mPathMillis;	// longest chain of updates ending with this one
+			uint32_t			mCriticalPrev;	// predecessor on the critical path, or the node itself
+		};
+
+		///// VARIABLES /////
+		vector<Node>							mNodes;		// in adding order, which is topological
+		unique_ptr<std::atomic<uint32_t>[]>		mPending;	// dependencies left this frame per node
+		unique_ptr<MPSCQueue<uint32_t>>			mSerialReady;	// ready nodes the graph's thread must run
+		std::atomic<uint32_t>					mRemaining;	// nodes not yet done this frame
+		JobSystem::JobCounter					mJobs;
+		shared_ptr<JobSystem>					mJobSystem;	// held for the update
+		double									mDeltaMillis;
+		bool									mBuilt;		// edges match mNodes
+		vector<uint32_t>						mCriticalPath;	// nodes of the last critical path, first to last
+		FrameStats								mFrameStats;
+
+		///// FUNCTIONS /////
+		void	build();
+		void	ready(uint32_t n);
+		void	runNode(uint32_t n);
+		void	complete(uint32_t n);
+		void	measureCriticalPath();
+
+	protected:
+		/*---------------------------------------------------------------------
+			A derived class must explicitly call this base class method, or
+			implement the same functionality on its own.
+		---------------------------------------------------------------------*/
+		virtual void onUpdate(double deltaMillis);
+		virtual bool onInitialize() { return true; }
+		virtual void onFinish() {}
+		virtual void onTogglePause() {}
+
+	public:
+		// Accessors
+		size_t				size() const		{ return mNodes.size(); }
+		const FrameStats &	frameStats() const	{ return mFrameStats; }
+
+		/*---------------------------------------------------------------------
+			Debug report of the last critical path, each subprocess on it and
+			its time
+		---------------------------------------------------------------------*/
+		void	logCriticalPath() const;
+
+		// Mutators
+		/*---------------------------------------------------------------------
+			Adds a subprocess after the ones added before it. reads and writes
+			are names separated by spaces or commas, of the data it uses and
+			changes. Returns the new size, or 0 if the graph is finished. Not
+			to be called from a subprocess while the graph updates.
+		---------------------------------------------------------------------*/
+		size_t	addProcess(const ProcessPtr &p, const string &reads, const string &writes);
+
+		// Constructor / destructor
+		explicit ProcessGraph(	const string &name,
+								ProcessRunMode runMode = Process_Run_Frame,
+								ProcessQueueMode queueMode = Process_Queue_Multiple);
+		virtual ~ProcessGraph();
+};
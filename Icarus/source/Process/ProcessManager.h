@@ -4,37 +4,247 @@ Orig.Date: 05/30/2012
 */
 #pragma once
 
+#include <hash_map>
+#include <queue>
+#include <cctype>
+#include <cstring>
 #include "Process.h"
+#include "ProcessProfiler.h"
+#include "Utility/PoolAllocator.h"
 #include "Utility/Debug.h"
 
+using stdext::hash_map;
+using std::unique_ptr;
+
 ///// STRUCTURES /////
 
 /*=============================================================================
 class ProcessManager
+	Updates processes in list order on the main thread. When given a
+	JobSystem, each run of consecutive parallel safe processes is batched and
+	updated as jobs, the main thread taking one of them and helping with the
+	rest, and the batch is joined before the next serial process updates or
+	the frame ends. Finished processes are always detached on the main
+	thread.
+	With a frame budget, Process_Run_Frame processes still update every
+	frame in list order, then Process_Run_Async processes share what is left
+	of the budget round robin, inline on the main thread since that is where
+	the time is measured. Those that don't get a turn are deferred: they
+	start the next frame's round and their next update is passed the time
+	that went by while they waited. At least one async process updates each
+	frame so none can be starved by the frame processes.
+	Attached processes are indexed by name, case insensitive, so lookup and
+	the queue modes are constant time, and each process keeps its own slot
+	so detach is too. Process_Queue_Single refuses to attach while
+	an unfinished process of the same name is attached, and
+	Process_Queue_Single_Replace finishes any of the same name in favor of
+	the new one.
+	A process that asks to sleep is moved to a parked list after its update
+	and left out of the frame until it is woken, by an event through the
+	manager's listener, by its timeout on the manager's clock, or by
+	wake() or finish(). A woken process rejoins at the end of the list, so
+	a process that relies on its position among the others shouldn't sleep.
+	The run and parked lists are arrays of ProcessPtr, walked by index each
+	frame. Detach, park and wake null out the process's slot instead of
+	moving the others, and the arrays are compacted in order at the end of
+	the frame, so once they have grown to the largest process count seen,
+	attach and detach don't allocate. Processes made with make<T> come
+	from the SlabPool_Process pool along with their control block, so
+	short lived processes don't reach the heap either.
 =============================================================================*/
 class ProcessManager {
 	private:
-		///// VARIABLES /////
-		ProcessLinkedList		mProcessList;
+		///// DEFINITIONS /////
+		/*---------------------------------------------------------------------
+			hash_map traits hashing and ordering process names ignoring
+			ASCII case, so lookups don't build a lower case copy
+		---------------------------------------------------------------------*/
+		struct NameTraits : public stdext::hash_compare<string> {
+			size_t operator()(const string &name) const {
+				uint32_t hash = 2166136261u;
+				for (size_t c = 0; c < name.size(); ++c) {
+					hash = (hash ^ static_cast<uint8_t>(tolower(static_cast<uint8_t>(name[c])))) * 16777619u;
+				}
+				return hash;
+			}
+			bool operator()(const string &a, const string &b) const {
+				return (_stricmp(a.c_str(), b.c_str()) < 0);
+			}
+		};
+		typedef hash_map<string, vector<Process*>, NameTraits>	NameIndex;	// name to attached processes, case insensitive, erased when empty
+		typedef hash_map<uint64_t, vector<Process*>>	WakeIndex;	// eventSubjectKey to parked processes, entries kept once created
 
-		// also need a multimap for random searches for processes and detaching
+		/*---------------------------------------------------------------------
+			Processes in list order, with null slots where processes left
+			since the last compact
+		---------------------------------------------------------------------*/
+		struct ProcessSlots {
+			vector<ProcessPtr>	mSlots;
+			uint32_t			mHoles;
+			uint32_t	count() const { return static_cast<uint32_t>(mSlots.size()) - mHoles; }
+			ProcessSlots() : mHoles(0) {}
+		};
+
+		class WakeListener;
+
+		/*---------------------------------------------------------------------
+			A sleep timeout, stale once the process has woken since
+		---------------------------------------------------------------------*/
+		struct TimedWake {
+			double				mWakeMillis;	// on the manager's clock
+			uint32_t			mSleepId;
+			weak_ptr<Process>	mProcess;
+		};
+		struct TimedWakeLater {
+			bool operator()(const TimedWake &a, const TimedWake &b) const { return (a.mWakeMillis > b.mWakeMillis); }
+		};
+		typedef std::priority_queue<TimedWake, vector<TimedWake>, TimedWakeLater>	TimedWakeQueue;
+
+	public:
+		/*---------------------------------------------------------------------
+			Process counts of the last updateProcesses
+		---------------------------------------------------------------------*/
+		struct FrameStats {
+			uint32_t	updated;	// processes updated
+			uint32_t	parked;		// processes left sleeping at the end of the frame
+			uint32_t	woken;		// parked processes woken since the frame before
+		};
+
+	private:
+
+		///// VARIABLES /////
+		ProcessSlots			mProcessList;	// processes updated each frame
+		ProcessSlots			mParkedList;	// sleeping processes, not visited until woken
+		NameIndex				mNameIndex;
+		WakeIndex				mWakeIndex;
+		TimedWakeQueue			mTimedWakes;
+		unique_ptr<WakeListener>	mWakeListener;	// created with the first event sleep
+		double					mClockMillis;	// sum of deltaMillis passed to updateProcesses
+		double					mAttachClockMillis;	// clock a new process counts its first update from, the last frame's
+		FrameStats				mFrameStats;
+		uint32_t				mWokenCount;
+		shared_ptr<JobSystem>	mJobSystem;
+		vector<Process*>		mParallelBatch;	// parallel safe processes waiting for the next join
+		vector<Process*>		mAsyncList;		// async processes gathered this frame, least recently updated first once sorted
+		uint64_t				mAsyncTurns;	// async updates so far, numbers each process's turn
+		uint64_t				mFramesOverBudget;
+		#if defined(ICARUS_PROFILE_PROCESSES)
+		unique_ptr<ProcessProfiler>	mProfiler;
+		#endif
 
 		///// FUNCTIONS /////
 		void	detach(const ProcessPtr &procPtr);
+		void	unindex(Process *p);
+		void	unindexWake(Process *p);
+
+		/*---------------------------------------------------------------------
+			Moves the process into a new slot at the end of the list, leaving
+			its old slot null
+		---------------------------------------------------------------------*/
+		void	moveSlot(Process *p, ProcessSlots &from, ProcessSlots &to);
+
+		/*---------------------------------------------------------------------
+			Closes the null slots, keeping list order. Not while the list is
+			being walked.
+		---------------------------------------------------------------------*/
+		void	compact(ProcessSlots &list);
+
+		/*---------------------------------------------------------------------
+			Updates a process with the time since its last update, and parks
+			it afterward if it asked to sleep
+		---------------------------------------------------------------------*/
+		double	elapsedSinceUpdate(Process *p);
+		void	updateOne(Process *p);
+		void	park(Process *p);
+		void	wakeTimedOut();
+
+		/*---------------------------------------------------------------------
+			Wakes the processes parked on the event's type, and on its type
+			and subject
+		---------------------------------------------------------------------*/
+		void	wakeOnEvent(const shared_ptr<Event> &ePtr);
+		void	wakeGroup(uint64_t wakeKey, const shared_ptr<Event> &ePtr);
+
+		/*---------------------------------------------------------------------
+			Updates the batched parallel safe processes and waits for them
+		---------------------------------------------------------------------*/
+		void	runParallelBatch();
+
+		/*---------------------------------------------------------------------
+			Updates the gathered async processes, the one that has waited
+			longest for its turn first, until the frame budget measured from startCounts runs
+			out, deferring the rest
+		---------------------------------------------------------------------*/
+		void	runAsyncProcesses(int64_t startCounts, double budgetMillis);
 
 	public:
 		bool	isProcessActive(const string &procName);
-		bool	hasProcesses() const	{ return !mProcessList.empty(); }
+		bool	hasProcesses() const	{ return (mProcessList.count() > 0 || mParkedList.count() > 0); }
 
-		void	attach(const ProcessPtr &procPtr);
+		/*---------------------------------------------------------------------
+			Creates a process of type TProcess, forwarding args to its
+			constructor. The process and its control block are allocated
+			together from the calling thread's process pool, and may be
+			released on any thread. Prefer this to new for processes that
+			are attached and finished often.
+		---------------------------------------------------------------------*/
+		template <typename TProcess, typename... Args>
+		static shared_ptr<TProcess> make(Args&&... args)
+		{
+			return std::allocate_shared<TProcess>(PoolAllocator<TProcess, SlabPool_Process>(), std::forward<Args>(args)...);
+		}
 
-		void	updateProcesses(double deltaMillis);
+		/*---------------------------------------------------------------------
+			Returns the process pool's allocation counters, summed over all
+			threads
+		---------------------------------------------------------------------*/
+		static SlabPool::Stats getAllocStats() { return SlabPool::stats(SlabPool_Process); }
+
+		/*---------------------------------------------------------------------
+			Adds the process to the end of the list, returns false if its
+			queue mode refused it
+		---------------------------------------------------------------------*/
+		bool	attach(const ProcessPtr &procPtr);
+
+		/*---------------------------------------------------------------------
+			Updates the processes for one frame. budgetMillis limits the time
+			taken, see above, 0 runs every process every frame.
+		---------------------------------------------------------------------*/
+		void	updateProcesses(double deltaMillis, double budgetMillis = 0.0);
+
+		/*---------------------------------------------------------------------
+			Moves a parked process back to the end of the list, see
+			Process::wake
+		---------------------------------------------------------------------*/
+		void	wake(Process *p);
+
+		/*---------------------------------------------------------------------
+			Process counts of the last frame, the number of frames where
+			async processes were deferred, and a debug report of those counts,
+			each attached process's deferrals and the profiler's timings
+		---------------------------------------------------------------------*/
+		const FrameStats &	frameStats() const			{ return mFrameStats; }
+		uint64_t			framesOverBudget() const	{ return mFramesOverBudget; }
+		void				logStats() const;
+
+		const shared_ptr<JobSystem> & getJobSystem() const { return mJobSystem; }
+
+		#if defined(ICARUS_PROFILE_PROCESSES)
+		/*---------------------------------------------------------------------
+			Per process update times, see ProcessProfiler. Not built into
+			shipping builds.
+		---------------------------------------------------------------------*/
+		ProcessProfiler &	getProfiler() const { return *mProfiler; }
+		#endif
 
 		/*---------------------------------------------------------------------
 			destroys all processes in the list
 		---------------------------------------------------------------------*/
 		void	clear();
 
-		explicit ProcessManager() {}
-		~ProcessManager() {}
+		/*---------------------------------------------------------------------
+			Without a JobSystem parallel safe processes update serially
+		---------------------------------------------------------------------*/
+		explicit ProcessManager(const shared_ptr<JobSystem> &jobSystem = shared_ptr<JobSystem>());
+		~ProcessManager();
 };
\ No newline at end of file
@@ -0,0 +1,142 @@
+/* ProcessProfiler.h
+Author: Jeff Kiah
+Orig.Date: 10/17/2026
+*/
+#pragma once
+
+#include "Process.h"
+
+#if defined(ICARUS_PROFILE_PROCESSES)
+
+#include <cstdint>
+#include <hash_map>
+#include <boost/noncopyable.hpp>
+#include <boost/thread/tss.hpp>
+#include <boost/thread/mutex.hpp>
+#include "Application/Timer.h"
+#include "Utility/LatencyHistogram.h"
+
+using std::unique_ptr;
+using stdext::hash_map;
+
+///// STRUCTURES /////
+
+/*=============================================================================
+class ProcessProfiler
+	Times every Process::update, including the children of chains, groups
+	and graphs, and keeps the time each process name took per frame. A
+	parent's time includes its children's. Times are kept in a
+	LatencyHistogram per name over a rolling window of frames, and the
+	statistics come from the last full window, or the current one until the
+	first window fills. A frame over the threshold is counted and logged the
+	first time each window it happens to the name. With periodic logging on,
+	the costliest names are logged as each window fills.
+	Updates on worker threads record into a buffer of their own, and the
+	ProcessManager gathers the buffers on the main thread at the end of each
+	frame, once every job has joined.
+	Only built when ICARUS_PROFILE_PROCESSES is defined, see Process.h.
+=============================================================================*/
+class ProcessProfiler : private boost::noncopyable {
+	public:
+		///// DEFINITIONS /////
+		struct ProcessTimings {
+			string		name;
+			uint64_t	frames;				// frames in the window the name updated
+			double		minMillis;
+			double		avgMillis;
+			double		p99Millis;
+			double		maxMillis;
+			double		lastFrameMillis;	// 0 if it didn't update last frame
+			uint64_t	framesOverThreshold;	// since the profiler was created or reset
+		};
+
+		/*---------------------------------------------------------------------
+			Times its own lifetime as an update of the named process. Does
+			nothing with a null profiler.
+		---------------------------------------------------------------------*/
+		class Scope : private boost::noncopyable {
+			private:
+				ProcessProfiler *	mProfiler;
+				const string &		mName;
+				int64_t				mStartCounts;
+			public:
+				explicit Scope(ProcessProfiler *profiler, const string &name) :
+					mProfiler(profiler), mName(name),
+					mStartCounts(profiler ? Timer::queryCounts() : 0)
+				{}
+				~Scope() {
+					if (mProfiler) { mProfiler->record(mName, Timer::queryCounts() - mStartCounts); }
+				}
+		};
+
+	private:
+		///// STRUCTURES /////
+		struct ThreadTime {
+			int64_t		counts;
+			uint32_t	updates;
+		};
+		typedef hash_map<string, ThreadTime>	ThreadTimes;	// entries kept once created, zeroed when gathered
+
+		struct ThreadBuffer {
+			boost::mutex	mMutex;		// only contended while the buffer is gathered
+			ThreadTimes		mTimes;
+		};
+
+		struct NameStats {
+			LatencyHistogram	mWindow;		// frame times in Timer counts, this window
+			LatencyHistogram	mLastWindow;
+			int64_t				mLastFrameCounts;
+			uint64_t			mOverThreshold;
+			bool				mFlagged;		// logged over the threshold this window
+			NameStats() : mLastFrameCounts(0), mOverThreshold(0), mFlagged(false) {}
+		};
+		typedef hash_map<string, NameStats>		NameStatsMap;
+
+		///// VARIABLES /////
+		boost::thread_specific_ptr<ThreadBuffer>	mLocalBuffer;
+		vector<unique_ptr<ThreadBuffer>>			mBuffers;		// every thread's buffer, owned here
+		boost::mutex								mBuffersMutex;
+		NameStatsMap								mStats;
+		double										mThresholdMillis;
+		uint32_t									mWindowFrames;
+		uint64_t									mFrames;
+		bool										mPeriodicLog;
+
+		///// FUNCTIONS /////
+		static void noCleanup(ThreadBuffer *) {}
+		ThreadBuffer & localBuffer();
+
+	public:
+		/*---------------------------------------------------------------------
+			Adds an update's time to the name's frame total. Thread safe.
+		---------------------------------------------------------------------*/
+		void	record(const string &name, int64_t counts);
+
+		/*---------------------------------------------------------------------
+			Gathers the frame's times from every thread, called by the
+			ProcessManager after the frame's updates have all finished
+		---------------------------------------------------------------------*/
+		void	endFrame();
+
+		/*---------------------------------------------------------------------
+			Fills outTimings with every name that has samples, the highest
+			average first
+		---------------------------------------------------------------------*/
+		void	getTimings(vector<ProcessTimings> &outTimings) const;
+
+		/*---------------------------------------------------------------------
+			Debug report of the maxEntries costliest names
+		---------------------------------------------------------------------*/
+		void	log(size_t maxEntries = 10) const;
+		void	reset();
+
+		void	setThresholdMillis(double millis)	{ mThresholdMillis = millis; }
+		void	setWindowFrames(uint32_t frames)	{ mWindowFrames = (frames > 0 ? frames : 1); }
+		void	setPeriodicLog(bool b)				{ mPeriodicLog = b; }
+		double	thresholdMillis() const				{ return mThresholdMillis; }
+
+		// Constructor
+		explicit ProcessProfiler(double thresholdMillis = 2.0, uint32_t windowFrames = 600);
+};
+
+#endif
@@ -7,6 +7,7 @@ Orig.Date: 05/30/2012
 #include "Process.h"
 #include <string>
 #include <boost/thread/thread.hpp>
+#include "Utility/ThreadPool.h"
 
 using std::string;
 using boost::thread;
@@ -15,12 +16,23 @@ using boost::thread;
 
 /*=============================================================================
 class ThreadProcess
+	A process whose threadProc runs on a thread of its own while onUpdate
+	runs with the other processes. When a ThreadPool has been set, the
+	threadProc runs as a task of the pool, with the OS priority and core
+	affinity of the process's ThreadClass, and waits for a thread if the
+	pool is at its cap. Without one it gets a dedicated thread at default
+	priority.
 =============================================================================*/
 class ThreadProcess : public Process {
 	private:
-		thread			mThread;
-		thread::id		mThreadID;
-		volatile bool	mKillThread;	// set true to request the thread to shutdown
+		static weak_ptr<ThreadPool>	sThreadPool;
+
+		thread				mThread;		// dedicated thread when there is no pool
+		thread::id			mThreadID;
+		ThreadClass			mThreadClass;
+		shared_ptr<ThreadPool>	mPool;		// held until the task is joined
+		ThreadPool::TaskPtr	mTask;
+		volatile bool		mKillThread;	// set true to request the thread to shutdown
 
 	protected:
 
@@ -36,8 +48,9 @@ class ThreadProcess : public Process {
 		virtual void onUpdate(double deltaMillis) = 0;
 
 		/*---------------------------------------------------------------------
-			This begins thread execution by contructing a new thread in the
-			member variable, passing (this) as data.
+			This begins thread execution by starting threadProc as a pool
+			task, or by contructing a new thread in the member variable,
+			passing (this) as data.
 			**NOTE**
 			A derived class can override this function if necessary, but MUST
 			explicitly call this base class version of the function within it,
@@ -87,10 +100,20 @@ class ThreadProcess : public Process {
 		virtual void threadProc() = 0;
 
 	public:
-		thread::id threadID() const { return mThreadID; }
+		/*---------------------------------------------------------------------
+			The thread running threadProc, not-a-thread until it starts
+		---------------------------------------------------------------------*/
+		thread::id	threadID() const;
+		ThreadClass	threadClass() const { return mThreadClass; }
+
+		/*---------------------------------------------------------------------
+			Sets the pool that ThreadProcesses initialized from now on run
+			on, null for dedicated threads
+		---------------------------------------------------------------------*/
+		static void setThreadPool(const shared_ptr<ThreadPool> &pool) { sThreadPool = pool; }
 
 		// Constructor / destructor
-		explicit ThreadProcess(const string &name);
+		explicit ThreadProcess(const string &name, ThreadClass threadClass = ThreadClass_Normal);
 		virtual ~ThreadProcess();
 };
 
@@ -73,7 +73,7 @@ bool Material::addTexture(const wstring &filename, uint32_t samplerIndex,
 			// Submits a job that will run until the resource is available and loaded, or errors.
 			// The job performs the same actions as above when the resource is loaded.
 			ProcessPtr procPtr(
-				new Material::CheckResourceLoadedProcess(
+				ProcessManager::make<Material::CheckResourceLoadedProcess>(
 								this,
 								filename,
 								samplerIndex,
@@ -121,51 +121,43 @@ Material::~Material()
 
 // class Material::CheckResourceLoadedProcess
 
-void Material::CheckResourceLoadedProcess::onUpdate(double deltaMillis)
+void Material::CheckResourceLoadedProcess::run(double deltaMillis)
 {
-	ResHandle h;
-	switch (m_resourceType) {
-		// handle texture loading
-		case MatResType_Texture: {
-			ResLoadResult retVal = h.tryLoad<Texture2DImpl>(m_resourcePath);
-			if (retVal == ResLoadResult_Success) {
-				//m_pMaterial->mTextureFlags[mpMaterial->mTextures.size()] = true;
-				// store a reference to the texture
-				m_pMaterial->m_textures.push_back(
-					std::make_pair<Texture_NVP::first_type, Texture_NVP::second_type>(
-						m_samplerIndex, h.getResPtr()
-					)
-				);
-				finish();
-
-			} else if (retVal == ResLoadResult_Error) {
-				debugWPrintf(L"Material: Error: failed to load child resource \"%s\" in material\n", m_resourcePath.c_str());
-				finish();
-			}
-			break;
-		}
-		// handle effect loading
-		case MatResType_Effect: {
-			/*ResLoadResult retVal = h.tryLoad<EffectImpl>(mResourcePath);
-			if (retVal == ResLoadResult_Success) {
-				m_pMaterial->mEffect = h.getResPtr(); // store a reference to the texture
-				finish();
-
-			} else if (retVal == ResLoadResult_Error) {
-				debugWPrintf(L"Material: Error: failed to load effect \"%s\" in material\n", m_resourcePath.c_str());
-				finish();
-			}*/
-			break;
+	PROC_BEGIN();
+	// handle texture loading
+	if (m_resourceType == MatResType_Texture) {
+		PROC_AWAIT_LOAD(Texture2DImpl, m_handle, m_resourcePath, m_loadResult);
+		if (m_loadResult == ResLoadResult_Success) {
+			//m_pMaterial->mTextureFlags[mpMaterial->mTextures.size()] = true;
+			// store a reference to the texture
+			m_pMaterial->m_textures.push_back(
+				std::make_pair<Texture_NVP::first_type, Texture_NVP::second_type>(
+					m_samplerIndex, m_handle.getResPtr()
+				)
+			);
+		} else {
+			debugWPrintf(L"Material: Error: failed to load child resource \"%s\" in material\n", m_resourcePath.c_str());
 		}
 	}
+	// handle effect loading
+	/*else if (m_resourceType == MatResType_Effect) {
+		PROC_AWAIT_LOAD(EffectImpl, m_handle, m_resourcePath, m_loadResult);
+		if (m_loadResult == ResLoadResult_Success) {
+			m_pMaterial->mEffect = m_handle.getResPtr(); // store a reference to the texture
+		} else {
+			debugWPrintf(L"Material: Error: failed to load effect \"%s\" in material\n", m_resourcePath.c_str());
+		}
+	}*/
+	PROC_END();
 }
 
 Material::CheckResourceLoadedProcess::CheckResourceLoadedProcess(
 				Material *pMaterial, const wstring &resourcePath,
 				uint32_t samplerIndex, MaterialResourceType resourceType) :
-	Process("CheckResourceLoadedProcess", Process_Run_Frame, Process_Queue_Multiple),
+	CoroutineProcess("CheckResourceLoadedProcess", Process_Run_Frame, Process_Queue_Multiple),
 	m_resourcePath(resourcePath),
 	m_resourceType(resourceType),
 	m_samplerIndex(samplerIndex),
-	m_pMaterial(pMaterial)
+	m_pMaterial(pMaterial),
+	m_loadResult(ResLoadResult_Waiting)
 {}
\ No newline at end of file
@@ -7,6 +7,7 @@ Orig.Date: 06/01/2012
 #include "Render/Texture2D.h"
 #include "Render/RenderBuffer.h"
 #include "Render/Effect.h"
+#include "Render/RenderFrame.h"
 #include "Process/ThreadProcess.h"
 
 #include "Math/Vector3f.h" // TEMP?
@@ -26,7 +27,7 @@ bool Renderer_D3D11::initRenderer()
 			initDeviceContext();
 }
 
-void Renderer_D3D11::render()
+void Renderer_D3D11::render(const RenderFrame &frame)
 {
 	// Clear the render target to black
 	float clearColor[4] = { 0, 0, 0, 1.0f }; // rgba
@@ -34,6 +35,7 @@ void Renderer_D3D11::render()
 
 	// Render a triangle
 	//mpContext->Draw(3, 0);
+	// frame.entries get drawn here once a Mesh can draw itself to a context
 
 	if (!mTextWriter) {
 		mTextWriter = new TextWriter_FW1();
@@ -41,7 +43,10 @@ void Renderer_D3D11::render()
 	}
 
 	mTextWriter->drawText(L"Hello World!", 16, 0, 0, 0xFFFFFFFF, mpContext);
+}
 
+void Renderer_D3D11::present()
+{
 	// Show the rendered frame on the screen
 	mpSwapChain->Present(1, 0);
 }
@@ -253,6 +258,7 @@ void Renderer_D3D11::RenderProcess::onUpdate(float deltaMillis)
 	// this part definitely should NOT be called here, but is just for illustration for now
 	// above builds the command list and this below executes it
 	if (pd3dCommandList) {
+		mRenderer.waitForContext();
 		mRenderer.getImmediateContext()->ExecuteCommandList(pd3dCommandList, TRUE);
 	}
 }
@@ -275,7 +281,7 @@ bool Renderer_D3D11::RenderProcess::onInitialize()
 }
 
 Renderer_D3D11::RenderProcess::RenderProcess(Renderer_D3D11 &renderer, const string &name) :
-	ThreadProcess(name),
+	ThreadProcess(name, ThreadClass_Latency),
 	mRenderer(renderer)
 {}
 
@@ -36,7 +36,8 @@ class Renderer_D3D11 : public Renderer_Base<Renderer_D3D11>
 		// Interface Functions
 		bool initRenderer();
 		void cleanup();
-		void render();
+		void render(const RenderFrame &frame);
+		void present();
 
 		// Implementation Functions
 		bool checkFeatureSupport();
@@ -50,6 +51,7 @@ class Renderer_D3D11 : public Renderer_Base<Renderer_D3D11>
 	public:
 		// Accessors
 		const ID3D11DevicePtr & getDevice() const { return mpDevice; }
+		// outside of render, call waitForContext first
 		const ID3D11DeviceContextPtr & getImmediateContext() const { return mpContext; }
 
 		// Constructor / destructor
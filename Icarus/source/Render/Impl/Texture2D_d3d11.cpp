@@ -371,7 +371,8 @@ ID3D11DeviceContextPtr Texture2D_D3D11::getD3D11DeviceContextPtr()
 		return ID3D11DevicePtr();
 	}
 
-	// get the D3D11DeviceContext
+	// get the D3D11DeviceContext once the render thread is done with it
+	pRend->waitForContext();
 	if (!pRend->getImmediateContext()) {
 		_ASSERTE(false && "Attempted to get null D3D11DeviceContext pointer");
 		return ID3D11DeviceContextPtr();
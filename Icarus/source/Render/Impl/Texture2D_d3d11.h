@@ -35,7 +35,9 @@ class Texture2D_D3D11 : public Texture2D_Base<Texture2D_D3D11> {
 
 		// Accessors
 		/*---------------------------------------------------------------------
-			returns the device and device context from renderer
+			returns the device and device context from renderer, the context
+			after waiting for the render thread to be done with it so main
+			thread only
 		---------------------------------------------------------------------*/
 		static ID3D11DevicePtr getD3D11DevicePtr();
 		static ID3D11DeviceContextPtr getD3D11DeviceContextPtr();
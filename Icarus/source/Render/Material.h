@@ -5,6 +5,7 @@ Orig.Date: 06/03/2012
 #pragma once
 
 #include "Resource/ResHandle.h"
+#include "Process/CoroutineProcess.h"
 #include "Render/RenderBuffer.h"
 #include "Math/Vector3f.h"
 #include "Math/Matrix4x4f.h"
@@ -25,17 +26,14 @@ class Material {
 			material is destroyed first, it will call finish() on all processes
 			in the list that aren't already finished.
 		---------------------------------------------------------------------*/
-		class CheckResourceLoadedProcess : public Process {
+		class CheckResourceLoadedProcess : public CoroutineProcess {
 			public:
 				enum MaterialResourceType : int {
 					MatResType_Texture = 0,
 					MatResType_Effect
 				};
 				
-				virtual void onUpdate(double deltaMillis);
-				virtual bool onInitialize() { return true; }
-				virtual void onFinish() {}
-				virtual void onTogglePause() {}
+				virtual void run(double deltaMillis);
 
 				explicit CheckResourceLoadedProcess(Material *pMaterial, const wstring &resourcePath,
 													uint32_t samplerIndex, MaterialResourceType resourceType);
@@ -46,6 +44,8 @@ class Material {
 				MaterialResourceType	m_resourceType;	// Texture or Effect
 				uint32_t				m_samplerIndex; // 0-15
 				Material *				m_pMaterial;
+				ResHandle				m_handle;
+				ResLoadResult			m_loadResult;
 		};
 
 		///// VARIABLES /////
@@ -0,0 +1,59 @@
+/* RenderFrame.h
+Author: Jeff Kiah
+Orig.Date: 10/17/2026
+*/
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "RenderEntry.h"
+#include "Scene/Camera.h"
+
+using std::vector;
+
+///// STRUCTURES /////
+
+/*=============================================================================
+struct RenderFrame
+	Everything the renderer needs to draw one frame, copied out of the
+	simulation by the main thread during update. The renderer reads only
+	this, never the scene, so it can draw the frame on the render thread
+	while the next frame updates. See RenderPipeline.
+	For now only frameIndex and deltaMillis are filled. There is no active
+	camera or scene graph to copy from yet, so nothing calls setCamera or
+	adds entries, and the renderer doesn't read them.
+=============================================================================*/
+struct RenderFrame {
+	// camera
+	Matrix4x4f			view;
+	Matrix4x4f			proj;
+	Vector3f			cameraPos;
+	float				zNear, zFar;
+
+	vector<RenderEntry>	entries;		// world transforms with what to draw at them
+	uint64_t			frameIndex;		// set by RenderPipeline::submit
+	double				deltaMillis;	// update time of the frame
+
+	void setCamera(const Camera &cam) {
+		view = cam.getViewMatrix();
+		proj = cam.getProjMatrix();
+		cameraPos = cam.getPos();
+		zNear = cam.getZNear();
+		zFar = cam.getZFar();
+	}
+
+	/*---------------------------------------------------------------------
+		Empties the frame for reuse, keeping the entry capacity so a
+		steady scene doesn't allocate
+	---------------------------------------------------------------------*/
+	void clear() {
+		entries.clear();
+		deltaMillis = 0.0;
+	}
+
+	explicit RenderFrame() :
+		view(Matrix4x4f::identity), proj(Matrix4x4f::identity),
+		zNear(0.0f), zFar(0.0f),
+		frameIndex(0), deltaMillis(0.0)
+	{}
+};
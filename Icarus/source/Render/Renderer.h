@@ -12,13 +12,21 @@ Description: Renderer is a base class to be implemented using static
 */
 #pragma once
 
+#include <functional>
+
 class Platform;
+struct RenderFrame;
 
 template <class Implementation>
 class Renderer_Base {
+	public:
+		///// DEFINITIONS /////
+		typedef std::function<void()>	ContextWaitFunc;
+
 	protected:
 		///// VARIABLES /////
 		const Platform *m_pPlatform;
+		ContextWaitFunc	mContextWait;
 
 		///// FUNCTIONS /////
 
@@ -36,10 +44,30 @@ class Renderer_Base {
 			static_cast<Implementation*>(this)->cleanup();
 		}
 
-		void render() {
-			static_cast<Implementation*>(this)->render();
+		/*---------------------------------------------------------------------
+			Draws the frame from the snapshot alone, may be called on the
+			render thread, see RenderPipeline
+		---------------------------------------------------------------------*/
+		void render(const RenderFrame &frame) {
+			static_cast<Implementation*>(this)->render(frame);
 		}
 
+		/*---------------------------------------------------------------------
+			Shows the frame drawn by render. Main thread only, presenting can
+			need the window's message thread.
+		---------------------------------------------------------------------*/
+		void present() {
+			static_cast<Implementation*>(this)->present();
+		}
+
+		/*---------------------------------------------------------------------
+			Main thread code outside of render calls waitForContext before
+			using the immediate context, which the render thread may be
+			drawing with. The RenderPipeline installs its waitForRender.
+		---------------------------------------------------------------------*/
+		void setContextWait(const ContextWaitFunc &wait) { mContextWait = wait; }
+		void waitForContext() const { if (mContextWait) { mContextWait(); } }
+
 		virtual ~Renderer_Base() { cleanup(); }
 };
 
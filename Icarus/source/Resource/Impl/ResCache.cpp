@@ -27,6 +27,7 @@ class ResCacheManager::AsyncLoadListener : public EventListener {
 
 // class static vars
 const string ResCacheManager::sAsyncLoadShutdownEvent("SYS_RES_ASYNCLOAD_SHUTDOWN");
+const EventTypeId ResCacheManager::sAsyncLoadShutdownEventId(eventTypeIdOf(ResCacheManager::sAsyncLoadShutdownEvent));
 
 ///// FUNCTIONS /////
 
@@ -348,7 +349,10 @@ bool ResCacheManager::AsyncLoadListener::handleInitDone(const EventPtr &ePtr)
 	// area where it will be picked up and put into cache the next time tryLoad
 	// is run requesting the resource
 	AsyncInitDoneEvent &e = *(static_cast<AsyncInitDoneEvent*>(ePtr.get()));
-	mResMgr.addToStagingList(e.mResName, e.mSourceName, ePtr);
+	// an event replayed from a trace has no resource, it only wakes the processes waiting on it
+	if (e.mResource) {
+		mResMgr.addToStagingList(e.mResName, e.mSourceName, ePtr);
+	}
 	return false; // allow event to propagate
 }
 
@@ -137,7 +137,7 @@ ResLoadResult ResCacheManager::tryLoad(ResHandle &h)
 					ResPtr resPtr(new TResource(h.name(), 0, cache)); // size is initially set to 0, must set it during load
 
 					// queues an event for loading thread to pick up
-					EventPtr ePtr(new AsyncLoadEvent(h.name(), h.source(), mi->second, resPtr));
+					EventPtr ePtr(EventManager::make<AsyncLoadEvent>(h.name(), h.source(), mi->second, resPtr));
 					m_eventMgr->raise(ePtr);
 
 				} else {
@@ -6,6 +6,7 @@ Orig.Date: 06/01/2012
 #include "Resource/ResourceProcess.h"
 #include "Event/RegisteredEvents.h"
 #include "Resource/ZipFile.h"
+#include "Utility/BinaryStream.h"
 
 ///// VARIABLES /////
 
@@ -13,38 +14,97 @@ Orig.Date: 06/01/2012
 const string AsyncLoadEvent::sEventType("SYS_RES_ASYNCLOAD");
 const string AsyncLoadDoneEvent::sEventType("SYS_RES_ASYNCLOAD_DONE");
 const string AsyncInitDoneEvent::sEventType("SYS_RES_ASYNCINIT_DONE");
+const EventTypeId AsyncLoadEvent::sEventTypeId(eventTypeIdOf(AsyncLoadEvent::sEventType));
+const EventTypeId AsyncLoadDoneEvent::sEventTypeId(eventTypeIdOf(AsyncLoadDoneEvent::sEventType));
+const EventTypeId AsyncInitDoneEvent::sEventTypeId(eventTypeIdOf(AsyncInitDoneEvent::sEventType));
 
 ///// FUNCTIONS /////
 
 // class AsyncLoadEvent
 
 /*
+// script data fields are Field_ResName = 0, Field_SourceName = 1, names are narrowed to ASCII for script
 void AsyncLoadEvent::buildScriptData()
 {
-	mScriptData.clear();
-	mScriptData.push_back(AnyVarsValue("mResName", mResName));
-	mScriptData.push_back(AnyVarsValue("mSourceName", mSourceName));
+	mScriptData.reset(sScriptSchema);
+	mScriptData.setString(Field_ResName, string(mResName.begin(), mResName.end()));
+	mScriptData.setString(Field_SourceName, string(mSourceName.begin(), mSourceName.end()));
 	mScriptDataBuilt = true;
 }
 
-AsyncLoadEvent::AsyncLoadEvent(const AnyVars &eventData) :
+AsyncLoadEvent::AsyncLoadEvent(const ScriptData &eventData) :
 	ScriptableEvent(eventData)
 {
-	for (AnyVars::const_iterator i = eventData.begin(); i != eventData.end(); ++i) {
-		try {
-			if (_stricmp(i->first.c_str(), "mResName") == 0) {
-				mResName = any_cast<string>(i->second);
-			} else if (_stricmp(i->first.c_str(), "mSourceName") == 0) {
-				mSourceName = any_cast<string>(i->second);
-			}
-		} catch (const boost::bad_any_cast &ex) {
-			// nothing happens with a bad datatype in release build, silently ignores
-			debugPrintf("AsyncLoadEvent: bad_any_cast \"%s\"\n", ex.what());
-		}
-	}
+	string resName(eventData.getString(Field_ResName));
+	string sourceName(eventData.getString(Field_SourceName));
+	mResName.assign(resName.begin(), resName.end());
+	mSourceName.assign(sourceName.begin(), sourceName.end());
 }
 */
 
+void AsyncLoadEvent::serialize(BinaryWriter &out) const
+{
+	out.writeWString(mResName);
+	out.writeWString(mSourceName);
+}
+
+EventPtr AsyncLoadEvent::deserialize(BinaryReader &in)
+{
+	wstring resName, sourceName;
+	in.readWString(resName);
+	in.readWString(sourceName);
+	if (!in.ok()) { return EventPtr(); }
+	return EventManager::make<AsyncLoadEvent>(resName, sourceName, ResSourcePtr(), ResPtr());
+}
+
+// class AsyncLoadDoneEvent
+
+void AsyncLoadDoneEvent::serialize(BinaryWriter &out) const
+{
+	out.write(static_cast<uint8_t>(mSuccess));
+	out.write(static_cast<uint64_t>(mSize));
+	out.writeWString(mResName);
+	out.writeWString(mSourceName);
+}
+
+EventPtr AsyncLoadDoneEvent::deserialize(BinaryReader &in)
+{
+	uint8_t success = 0;
+	uint64_t size = 0;
+	wstring resName, sourceName;
+	in.read(success);
+	in.read(size);
+	in.readWString(resName);
+	in.readWString(sourceName);
+	if (!in.ok()) { return EventPtr(); }
+	return EventManager::make<AsyncLoadDoneEvent>(resName, sourceName, BufferPtr(),
+												  static_cast<size_t>(size), ResPtr(), (success != 0));
+}
+
+// class AsyncInitDoneEvent
+
+void AsyncInitDoneEvent::serialize(BinaryWriter &out) const
+{
+	out.write(static_cast<uint8_t>(mSuccess));
+	out.write(static_cast<uint64_t>(mSize));
+	out.writeWString(mResName);
+	out.writeWString(mSourceName);
+}
+
+EventPtr AsyncInitDoneEvent::deserialize(BinaryReader &in)
+{
+	uint8_t success = 0;
+	uint64_t size = 0;
+	wstring resName, sourceName;
+	in.read(success);
+	in.read(size);
+	in.readWString(resName);
+	in.readWString(sourceName);
+	if (!in.ok()) { return EventPtr(); }
+	return EventManager::make<AsyncInitDoneEvent>(resName, sourceName, BufferPtr(),
+												  static_cast<size_t>(size), ResPtr(), (success != 0));
+}
+
 // class AsyncLoadProcess
 
 void AsyncLoadProcess::threadProc()
@@ -56,10 +116,12 @@ void AsyncLoadProcess::threadProc()
 		// condition variable causes the process to sit idle until an event is in the queue,
 		// so a shutdown event could wake the thread and then exit. If load events
 		// are still queued, threadKilled() returning true could also cause an exit
-		if (ePtr->type() == ResCacheManager::sAsyncLoadShutdownEvent) break;
+		if (ePtr->typeId() == ResCacheManager::sAsyncLoadShutdownEventId) break;
 
 		// if it's not a shutdown event, we know it's a decompression / load event
 		AsyncLoadEvent &e = *(static_cast<AsyncLoadEvent*>(ePtr.get()));
+		// a load replayed from an event trace has nothing to load into
+		if (!e.mSourcePtr || !e.mResource) continue;
 
 		size_t threadIndex = -1;
 		// find the threadIndex in our source map, or call getNewThreadIndex if it doesn't exist yet
@@ -89,29 +151,29 @@ void AsyncLoadProcess::threadProc()
 		// if the loading succeeded AND this resource uses thread initializer
 		if (success && e.mResource->useThreadInit()) {
 			// send AsyncLoadDone event to notify initialization thread to run
-			EventPtr doneEventPtr(new AsyncLoadDoneEvent(e.mResName, e.mSourceName, dataPtr,
-														 size, e.mResource, success));
+			EventPtr doneEventPtr(EventManager::make<AsyncLoadDoneEvent>(e.mResName, e.mSourceName, dataPtr,
+																		 size, e.mResource, success));
 			m_eventMgr->raiseThreadSafe(doneEventPtr);
 
 		} else {
 			// skip the init thread and just fire a AsyncInitDone event so the main thread puts it right into the staging queue
-			EventPtr initEventPtr(new AsyncInitDoneEvent(e.mResName, e.mSourceName, dataPtr,
-														 size, e.mResource, success));
+			EventPtr initEventPtr(EventManager::make<AsyncInitDoneEvent>(e.mResName, e.mSourceName, dataPtr,
+																		 size, e.mResource, success));
 			m_eventMgr->raiseThreadSafe(initEventPtr);
 		}
 	}
 }
 
 AsyncLoadProcess::AsyncLoadProcess(const string &name, const EventManagerPtr &eventMgr) :
-	ThreadProcess(name), m_eventMgr(eventMgr)
+	ThreadProcess(name, ThreadClass_Background), m_eventMgr(eventMgr)
 {
 	// register the load event
 	eventMgr->registerEventType(AsyncLoadEvent::sEventType,
 							 //RegEventPtr(new ScriptCallableCodeEvent<AsyncLoadEvent>(EventDataType_NotEmpty)));
-							 RegEventPtr(new CodeOnlyEvent(EventDataType_NotEmpty)));
+							 RegEventPtr(new ReplayableCodeOnlyEvent<AsyncLoadEvent>(EventDataType_NotEmpty)));
 	// register the load done event
 	eventMgr->registerEventType(AsyncLoadDoneEvent::sEventType,
-							 RegEventPtr(new CodeOnlyEvent(EventDataType_NotEmpty)));
+							 RegEventPtr(new ReplayableCodeOnlyEvent<AsyncLoadDoneEvent>(EventDataType_NotEmpty)));
 }
 
 AsyncLoadProcess::~AsyncLoadProcess()
@@ -144,18 +206,20 @@ void AsyncInitProcess::threadProc()
 		// condition variable causes the process to sit idle until an event is in the queue,
 		// so a shutdown event could wake the thread and then exit. If load events
 		// are still queued, threadKilled() returning true could also cause an exit
-		if (ePtr->type() == ResCacheManager::sAsyncLoadShutdownEvent) break;
+		if (ePtr->typeId() == ResCacheManager::sAsyncLoadShutdownEventId) break;
 
 		// if it's not a shutdown event, we know it's a Load Done event
 		AsyncLoadDoneEvent &e = *(static_cast<AsyncLoadDoneEvent*>(ePtr.get()));
+		// a replayed event has no resource to initialize
+		if (!e.mResource) continue;
 
 		// run the thread initialization routine
 		bool success = e.mResource->onThreadInit(e.mDataPtr);
 		debugPrintf("%s: async init \"%S\": success=%i\n", name().c_str(), e.mResName.c_str(), success);
 
 		// fire the init done event which the ResCacheManager's listener will put in the staging queue
-		EventPtr initEventPtr(new AsyncInitDoneEvent(e.mResName, e.mSourceName, e.mDataPtr,
-													 e.mSize, e.mResource, success));
+		EventPtr initEventPtr(EventManager::make<AsyncInitDoneEvent>(e.mResName, e.mSourceName, e.mDataPtr,
+																	 e.mSize, e.mResource, success));
 		m_eventMgr->raiseThreadSafe(initEventPtr);
 	}
 }
@@ -165,7 +229,7 @@ AsyncInitProcess::AsyncInitProcess(const string &name, const EventManagerPtr &ev
 {
 	// register the init done event
 	eventMgr->registerEventType(AsyncInitDoneEvent::sEventType,
-								RegEventPtr(new CodeOnlyEvent(EventDataType_NotEmpty)));
+								RegEventPtr(new ReplayableCodeOnlyEvent<AsyncInitDoneEvent>(EventDataType_NotEmpty)));
 }
 
 AsyncInitProcess::~AsyncInitProcess()
@@ -216,7 +216,8 @@ class ResCacheManager :
 		/*---------------------------------------------------------------------
 			This string defines the event that shuts down the child threads
 		---------------------------------------------------------------------*/
-		static const string sAsyncLoadShutdownEvent;
+		static const string			sAsyncLoadShutdownEvent;
+		static const EventTypeId	sAsyncLoadShutdownEventId;
 
 		/*---------------------------------------------------------------------
 			creates the cache of a certain type passing in the budget, only one
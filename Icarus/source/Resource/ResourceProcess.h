@@ -20,6 +20,29 @@ class Resource;
 typedef shared_ptr<Resource>	ResPtr;
 typedef shared_ptr<char>		BufferPtr; // use checked_array_deleter<char> to ensure delete[] called
 
+///// FUNCTIONS /////
+
+/*---------------------------------------------------------------------
+	Event subject of a resource's load events, 32-bit FNV-1a of its
+	"source/name" path as passed to ResHandle::tryLoad, so a process can
+	sleep until one particular resource is loaded
+---------------------------------------------------------------------*/
+inline uint32_t resPathSubject(const wstring &sourceName, const wstring &resName)
+{
+	uint32_t hash = 2166136261u;
+	for (size_t c = 0; c < sourceName.size(); ++c) { hash = (hash ^ static_cast<uint32_t>(sourceName[c])) * 16777619u; }
+	hash = (hash ^ static_cast<uint32_t>(L'/')) * 16777619u;
+	for (size_t c = 0; c < resName.size(); ++c) { hash = (hash ^ static_cast<uint32_t>(resName[c])) * 16777619u; }
+	return hash;
+}
+
+inline uint32_t resPathSubject(const wstring &resPath)
+{
+	size_t i = resPath.find_first_of(L"/\\");
+	if (i == wstring::npos) { return 0; }
+	return resPathSubject(resPath.substr(0, i), resPath.substr(i + 1));
+}
+
 ///// STRUCTURES /////
 
 /*=====================================================================
@@ -33,7 +56,8 @@ class AsyncLoadEvent : public Event /*ScriptableEvent*/ {
 		typedef shared_ptr<IResourceSource>		ResSourcePtr;
 
 		///// VARIABLES /////
-		static const string sEventType;
+		static const string		sEventType;
+		static const EventTypeId	sEventTypeId;
 
 		wstring			mResName;		// the file to load from the source object
 		wstring			mSourceName;	// the name of the ResourceSource
@@ -41,11 +65,17 @@ class AsyncLoadEvent : public Event /*ScriptableEvent*/ {
 		ResPtr			mResource;		// shared_ptr to the Resource object being constructed
 
 		///// FUNCTIONS /////
-		const string &	type() const { return sEventType; }
-		//void	serialize(ostream &out) const {}
-		//void	deserialize(istream &in) {}
+		const string &	type() const	{ return sEventType; }
+		EventTypeId		typeId() const	{ return sEventTypeId; }
 		//void	buildScriptData();
 
+		/*---------------------------------------------------------------------
+			Records the resource path. A replayed event has no source or
+			resource object and is ignored by AsyncLoadProcess.
+		---------------------------------------------------------------------*/
+		void			serialize(BinaryWriter &out) const;
+		static EventPtr	deserialize(BinaryReader &in);
+
 		// Constructor / destructor
 		explicit AsyncLoadEvent(const wstring &resName, const wstring &sourceName,
 								const ResSourcePtr &sourcePtr, const ResPtr &resPtr) :
@@ -54,7 +84,7 @@ class AsyncLoadEvent : public Event /*ScriptableEvent*/ {
 			mResName(resName), mSourceName(sourceName),
 			mSourcePtr(sourcePtr), mResource(resPtr)
 		{}
-		//explicit AsyncLoadEvent(const AnyVars &eventData);
+		//explicit AsyncLoadEvent(const ScriptData &eventData);
 		virtual ~AsyncLoadEvent() {}
 };
 
@@ -67,7 +97,8 @@ class AsyncLoadDoneEvent
 class AsyncLoadDoneEvent : public Event {
 	public:
 		///// VARIABLES /////
-		static const string sEventType;
+		static const string		sEventType;
+		static const EventTypeId	sEventTypeId;
 
 		bool		mSuccess;		// true if decompression successful
 		size_t		mSize;			// size of the buffer array
@@ -77,9 +108,16 @@ class AsyncLoadDoneEvent : public Event {
 		ResPtr		mResource;		// shared_ptr to the Resource object being constructed
 
 		///// FUNCTIONS /////
-		const string &	type() const { return sEventType; }
-		//void	serialize(ostream &out) const {}
-		//void	deserialize(istream &in) {}
+		const string &	type() const	{ return sEventType; }
+		EventTypeId		typeId() const	{ return sEventTypeId; }
+
+		/*---------------------------------------------------------------------
+			Records the result and resource path, not the data. A replayed
+			event has no buffer or resource object and is ignored by
+			AsyncInitProcess.
+		---------------------------------------------------------------------*/
+		void			serialize(BinaryWriter &out) const;
+		static EventPtr	deserialize(BinaryReader &in);
 
 		// Constructor / destructor
 		explicit AsyncLoadDoneEvent(const wstring &resName, const wstring &sourceName,
@@ -94,11 +132,15 @@ class AsyncLoadDoneEvent : public Event {
 
 /*=====================================================================
 class AsyncInitDoneEvent
+	The resource is loaded and initialized and waiting in the staging
+	list, the next tryLoad for it will succeed or report the error. Its
+	subject is the resPathSubject of the resource.
 =====================================================================*/
 class AsyncInitDoneEvent : public Event {
 	public:
 		///// VARIABLES /////
-		static const string sEventType;
+		static const string		sEventType;
+		static const EventTypeId	sEventTypeId;
 
 		bool		mSuccess;		// true if initialization successful
 		size_t		mSize;			// size of the buffer array
@@ -106,9 +148,20 @@ class AsyncInitDoneEvent : public Event {
 		wstring		mSourceName;	// the name of the ResourceSource
 		BufferPtr	mDataPtr;		// the buffer containing data
 		ResPtr		mResource;		// shared_ptr to the Resource object being constructed
+		uint32_t	mSubject;		// resPathSubject of the resource
 
 		///// FUNCTIONS /////
-		const string &	type() const { return sEventType; }
+		const string &	type() const	{ return sEventType; }
+		EventTypeId		typeId() const	{ return sEventTypeId; }
+		uint32_t		subject() const	{ return mSubject; }
+
+		/*---------------------------------------------------------------------
+			Records the result and resource path, not the data. A replayed
+			event still wakes processes sleeping on the resource, but has no
+			resource object and is not staged by the ResCacheManager.
+		---------------------------------------------------------------------*/
+		void			serialize(BinaryWriter &out) const;
+		static EventPtr	deserialize(BinaryReader &in);
 
 		// Constructor / destructor
 		explicit AsyncInitDoneEvent(const wstring &resName, const wstring &sourceName,
@@ -116,7 +169,8 @@ class AsyncInitDoneEvent : public Event {
 									bool success = true) :
 			Event(),
 			mResName(resName), mSourceName(sourceName), mDataPtr(bPtr),
-			mSize(size), mResource(resPtr), mSuccess(success)
+			mSize(size), mResource(resPtr), mSuccess(success),
+			mSubject(resPathSubject(sourceName, resName))
 		{}
 		virtual ~AsyncInitDoneEvent() {}
 };
@@ -19,6 +19,8 @@ class Camera : public SceneNode {
 		inline float getZNear() const;
 		inline float getZFar() const;
 		inline float getZoom() const;
+		inline const Matrix4x4f & getViewMatrix() const;
+		inline const Matrix4x4f & getProjMatrix() const;
 
 		// Mutators
 		void setViewTranslationPitchYawRoll(const Vector3f &pos, const Vector3f &viewAngles);
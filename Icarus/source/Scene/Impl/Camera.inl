@@ -39,3 +39,11 @@ inline float Camera::getZFar() const {
 inline float Camera::getZoom() const {
 	return m_zoom;
 }
+
+inline const Matrix4x4f & Camera::getViewMatrix() const {
+	return m_viewMat;
+}
+
+inline const Matrix4x4f & Camera::getProjMatrix() const {
+	return m_projMat;
+}
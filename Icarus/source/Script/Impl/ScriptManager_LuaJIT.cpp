@@ -3,7 +3,9 @@ Author: Jeff Kiah
 Orig.Date: 06/08/2012
 */
 #include "Script/ScriptManager_LuaJIT.h"
+#include "Event/RegisteredEvents.h"
 #include "Utility/Debug.h"
+#include <new>
 
 #if defined(_DEBUG)
 #pragma comment ( lib, "lua51_d.lib" )
@@ -11,21 +13,233 @@ Orig.Date: 06/08/2012
 #pragma comment ( lib, "lua51.lib" )
 #endif
 
+///// VARIABLES /////
+
+static const char sEmptyEventKey = 0;	// registry key of the metatable for events without script data
+
+///// FUNCTIONS /////
+
 __declspec(dllexport) void debug_printf(const char *str) {
 	debugPrintf(str);
 }
 
+////////// class ScriptManager //////////
+
+/*---------------------------------------------------------------------
+	engine.raise(eventType, data) and engine.trigger(eventType, data),
+	the ScriptManager is the closure's upvalue
+---------------------------------------------------------------------*/
+int ScriptManager::luaRaise(lua_State *L)
+{
+	ScriptManager *scriptMgr = static_cast<ScriptManager *>(lua_touserdata(L, lua_upvalueindex(1)));
+	return scriptMgr->fireEvent(L, false);
+}
+
+int ScriptManager::luaTrigger(lua_State *L)
+{
+	ScriptManager *scriptMgr = static_cast<ScriptManager *>(lua_touserdata(L, lua_upvalueindex(1)));
+	return scriptMgr->fireEvent(L, true);
+}
+
+/*---------------------------------------------------------------------
+	__index of event userdata. Upvalue 1 maps field names to indices,
+	upvalue 2 is the schema. Fields can also be read by 1-based number,
+	and e.type is the event type name unless a field shadows it.
+---------------------------------------------------------------------*/
+int ScriptManager::luaEventIndex(lua_State *L)
+{
+	const EventPtr &ePtr = *static_cast<EventPtr *>(lua_touserdata(L, 1));
+	const ScriptDataSchema *schema = static_cast<const ScriptDataSchema *>(lua_touserdata(L, lua_upvalueindex(2)));
+	size_t f = ScriptField_NotFound;
+
+	if (lua_type(L, 2) == LUA_TSTRING) {
+		lua_pushvalue(L, 2);
+		lua_rawget(L, lua_upvalueindex(1));
+		if (lua_isnil(L, -1)) {
+			if (strcmp(lua_tostring(L, 2), "type") == 0) {
+				lua_pushlstring(L, ePtr->type().c_str(), ePtr->type().size());
+			}
+			return 1;
+		}
+		f = static_cast<size_t>(lua_tointeger(L, -1));
+		lua_pop(L, 1);
+	} else if (lua_type(L, 2) == LUA_TNUMBER) {
+		f = static_cast<size_t>(lua_tointeger(L, 2) - 1);
+	}
+	if (!schema || f >= schema->numFields()) {
+		lua_pushnil(L);
+		return 1;
+	}
+
+	const ScriptData &data = static_cast<const ScriptableEvent &>(*ePtr).getScriptData();
+	ScriptFieldIndex fi = static_cast<ScriptFieldIndex>(f);
+	switch (schema->field(fi).mType) {
+		case ScriptField_Bool:
+			lua_pushboolean(L, data.getBool(fi));
+			break;
+		case ScriptField_Int:
+			lua_pushinteger(L, data.getInt(fi));
+			break;
+		case ScriptField_String: {
+			size_t length = 0;
+			const char *str = data.getString(fi, &length);
+			lua_pushlstring(L, str, length);
+			break;
+		}
+		default:
+			lua_pushnumber(L, data.getNumber(fi));
+	}
+	return 1;
+}
+
+int ScriptManager::luaEventNewIndex(lua_State *L)
+{
+	// event data is immutable once built, see ScriptableEvent
+	return luaL_error(L, "event fields are read only");
+}
+
+int ScriptManager::luaEventGc(lua_State *L)
+{
+	EventPtr *ePtr = static_cast<EventPtr *>(lua_touserdata(L, 1));
+	ePtr->~EventPtr();
+	return 0;
+}
+
+int ScriptManager::fireEvent(lua_State *L, bool trigger)
+{
+	const char *eventType = luaL_checkstring(L, 1);
+	const char *error = 0;
+	bool success = false;
+	// scoped so nothing with a destructor is live if luaL_error unwinds the C stack
+	{
+		EventManagerPtr eventMgr(m_eventMgr.lock());
+		RegEventPtr regPtr(eventMgr ? eventMgr->getRegEventPtr(eventTypeIdOf(eventType)) : RegEventPtr());
+		if (!regPtr || !regPtr->scriptAllowed()) {
+			error = "event type \"%s\" is not registered as script callable";
+		} else if (!readScriptData(L, 2, (regPtr->isEmpty() ? ScriptDataSchemaPtr() : regPtr->getScriptSchema()), m_scratchData)) {
+			error = "event type \"%s\" given data of the wrong type";
+		} else {
+			// the event copies the scratch data before it is dispatched, so a handler
+			// firing another event from script can safely reuse it
+			string eventTypeStr(eventType);
+			success = (trigger ? regPtr->triggerEventFromScript(eventTypeStr, m_scratchData)
+							   : regPtr->raiseEventFromScript(eventTypeStr, m_scratchData));
+		}
+	}
+	if (error) {
+		return luaL_error(L, error, eventType);
+	}
+	lua_pushboolean(L, success);
+	return 1;
+}
+
+bool ScriptManager::readScriptData(lua_State *L, int tableIndex, const ScriptDataSchemaPtr &schema, ScriptData &data)
+{
+	data.reset(schema);
+	if (lua_isnoneornil(L, tableIndex)) { return true; }
+	if (!schema) { return false; }
+	if (!lua_istable(L, tableIndex)) { return false; }
+	if (tableIndex < 0 && tableIndex > LUA_REGISTRYINDEX) {
+		tableIndex = lua_gettop(L) + tableIndex + 1;
+	}
+
+	bool ok = true;
+	for (size_t f = 0; f < schema->numFields(); ++f) {
+		const ScriptDataSchema::Field &field = schema->field(static_cast<ScriptFieldIndex>(f));
+		ScriptFieldIndex fi = static_cast<ScriptFieldIndex>(f);
+		lua_getfield(L, tableIndex, field.mName.c_str());
+		int luaType = lua_type(L, -1);
+		if (luaType != LUA_TNIL) {
+			if (field.mType == ScriptField_Bool && luaType == LUA_TBOOLEAN) {
+				data.setBool(fi, lua_toboolean(L, -1) != 0);
+			} else if (field.mType == ScriptField_String && luaType == LUA_TSTRING) {
+				size_t length = 0;
+				const char *str = lua_tolstring(L, -1, &length);
+				data.setString(fi, str, length);
+			} else if (field.mType != ScriptField_Bool && field.mType != ScriptField_String && luaType == LUA_TNUMBER) {
+				data.setNumber(fi, lua_tonumber(L, -1));
+			} else {
+				debugPrintf("ScriptManager: field \"%s\" has the wrong type\n", field.mName.c_str());
+				ok = false;
+			}
+		}
+		lua_pop(L, 1);
+	}
+	return ok;
+}
+
+/*---------------------------------------------------------------------
+	Pushes the metatable shared by every event with this schema, built
+	and stored in the registry the first time the schema is seen.
+	Schemas are registered once and live for the whole run, so the
+	schema address is a stable key.
+---------------------------------------------------------------------*/
+void ScriptManager::pushEventMetatable(const ScriptDataSchema *schema)
+{
+	void *key = (schema ? const_cast<ScriptDataSchema *>(schema) : const_cast<char *>(&sEmptyEventKey));
+	lua_pushlightuserdata(m_state, key);
+	lua_rawget(m_state, LUA_REGISTRYINDEX);
+	if (!lua_isnil(m_state, -1)) { return; }
+	lua_pop(m_state, 1);
+
+	lua_newtable(m_state);
+	// field name to index table and the schema are upvalues of __index
+	size_t numFields = (schema ? schema->numFields() : 0);
+	lua_createtable(m_state, 0, static_cast<int>(numFields));
+	for (size_t f = 0; f < numFields; ++f) {
+		lua_pushinteger(m_state, static_cast<lua_Integer>(f));
+		lua_setfield(m_state, -2, schema->field(static_cast<ScriptFieldIndex>(f)).mName.c_str());
+	}
+	lua_pushlightuserdata(m_state, const_cast<ScriptDataSchema *>(schema));
+	lua_pushcclosure(m_state, &ScriptManager::luaEventIndex, 2);
+	lua_setfield(m_state, -2, "__index");
+	lua_pushcfunction(m_state, &ScriptManager::luaEventNewIndex);
+	lua_setfield(m_state, -2, "__newindex");
+	lua_pushcfunction(m_state, &ScriptManager::luaEventGc);
+	lua_setfield(m_state, -2, "__gc");
+
+	lua_pushlightuserdata(m_state, key);
+	lua_pushvalue(m_state, -2);
+	lua_rawset(m_state, LUA_REGISTRYINDEX);
+}
+
+void ScriptManager::pushEvent(const EventPtr &ePtr)
+{
+	EventManagerPtr eventMgr(m_eventMgr.lock());
+	RegEventPtr regPtr(eventMgr ? eventMgr->getRegEventPtr(ePtr->typeId()) : RegEventPtr());
+	_ASSERTE(regPtr && regPtr->scriptAllowed() && "Pushed an event that isn't script visible");
+
+	// only non-empty script callable types are ScriptableEvents
+	const ScriptDataSchema *schema = 0;
+	if (regPtr && regPtr->scriptAllowed() && !regPtr->isEmpty()) {
+		ScriptableEvent &e = static_cast<ScriptableEvent &>(*ePtr);
+		if (!e.isScriptDataBuilt()) { e.buildScriptData(); }
+		schema = e.getScriptData().schema().get();
+	}
+
+	new (lua_newuserdata(m_state, sizeof(EventPtr))) EventPtr(ePtr);
+	pushEventMetatable(schema);
+	lua_setmetatable(m_state, -2);
+}
+
 void ScriptManager::update()
 {
 }
 
-bool ScriptManager::init(const string &filename)
+bool ScriptManager::init(const string &filename, const EventManagerPtr &eventMgr)
 {
+	m_eventMgr = eventMgr;
 	m_state = luaL_newstate();
 
 	luaL_openlibs(m_state); /* Load Lua libraries */
 
 	lua_newtable(m_state);
+	lua_pushlightuserdata(m_state, this);
+	lua_pushcclosure(m_state, &ScriptManager::luaRaise, 1);
+	lua_setfield(m_state, -2, "raise");
+	lua_pushlightuserdata(m_state, this);
+	lua_pushcclosure(m_state, &ScriptManager::luaTrigger, 1);
+	lua_setfield(m_state, -2, "trigger");
 	lua_setglobal(m_state, "engine");
 
 	/* Load the file containing the script we are going to run */
@@ -39,4 +253,5 @@ bool ScriptManager::init(const string &filename)
 void ScriptManager::deinit()
 {
 	lua_close(m_state);
-}
\ No newline at end of file
+	m_state = 0;
+}
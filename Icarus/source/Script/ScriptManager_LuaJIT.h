@@ -7,13 +7,40 @@ Orig.Date: 06/08/2012
 #include "lua.hpp"
 #include <memory>
 #include <string>
+#include "Event/ScriptData.h"
 
 using std::shared_ptr;
+using std::weak_ptr;
 using std::string;
 
+class Event;
+class EventManager;
+typedef shared_ptr<Event>			EventPtr;
+typedef shared_ptr<EventManager>	EventManagerPtr;
+
+/*=============================================================================
+class ScriptManager
+	Owns the Lua state. Scriptable events cross into Lua as userdata holding
+	the EventPtr, indexed through a metatable built once per schema that maps
+	field names to indices in a Lua table, so e.fieldName costs a table
+	lookup and a memcpy with no allocation. Script fires events with
+	engine.raise(eventType, data) and engine.trigger(eventType, data), where
+	data is a table read field by field into the type's schema.
+=============================================================================*/
 class ScriptManager {
 	private:
-		lua_State	*m_state;
+		lua_State					*m_state;
+		weak_ptr<EventManager>		m_eventMgr;
+		ScriptData					m_scratchData;	// reused for each event fired from script
+
+		static int luaRaise(lua_State *L);
+		static int luaTrigger(lua_State *L);
+		static int luaEventIndex(lua_State *L);
+		static int luaEventNewIndex(lua_State *L);
+		static int luaEventGc(lua_State *L);
+
+		int		fireEvent(lua_State *L, bool trigger);
+		void	pushEventMetatable(const ScriptDataSchema *schema);
 
 	public:
 		// Methods
@@ -25,15 +52,29 @@ class ScriptManager {
 			Loads and executes Lua code from a file
 		---------------------------------------------------------------------*/
 		inline bool doFile(const string &filename);
-		
+
+		/*---------------------------------------------------------------------
+			Pushes a ScriptableEvent onto the Lua stack for a script handler,
+			building its script data first if needed. The userdata keeps the
+			event alive until Lua collects it. Fields are read only.
+		---------------------------------------------------------------------*/
+		void pushEvent(const EventPtr &ePtr);
+
+		/*---------------------------------------------------------------------
+			Resets data to schema and reads its fields from the Lua table at
+			tableIndex, missing fields stay zero and nil is read as no data.
+			Returns false if a field has the wrong Lua type.
+		---------------------------------------------------------------------*/
+		static bool readScriptData(lua_State *L, int tableIndex, const ScriptDataSchemaPtr &schema, ScriptData &data);
+
 		void update();
-		
-		bool init(const string &filename);
-		
+
+		bool init(const string &filename, const EventManagerPtr &eventMgr);
+
 		void deinit();
 
-		explicit ScriptManager() {}
+		explicit ScriptManager() : m_state(0) {}
 		~ScriptManager() {}
 };
 
-#include "Impl/ScriptManager_LuaJIT.inl"
\ No newline at end of file
+#include "Impl/ScriptManager_LuaJIT.inl"
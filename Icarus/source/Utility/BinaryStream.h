@@ -0,0 +1,147 @@
+/* BinaryStream.h
+Author: Jeff Kiah
+Orig.Date: 10/17/2026
+*/
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <type_traits>
+
+using std::string;
+using std::wstring;
+using std::vector;
+
+///// STRUCTURES /////
+
+/*=============================================================================
+class BinaryWriter
+	Appends raw little-endian values to a byte vector. Used for event trace
+	payloads, where data is written and read back on the same platform, so
+	values are copied as-is with no packing. Only trivially copyable types
+	can be written with write(), use writeString or writeWString for strings.
+=============================================================================*/
+class BinaryWriter {
+	private:
+		vector<uint8_t> &	mBuffer;
+
+	public:
+		template <typename T>
+		void write(const T &value)
+		{
+			static_assert(std::is_trivially_copyable<T>::value, "BinaryWriter::write requires a trivially copyable type");
+			writeBytes(&value, sizeof(T));
+		}
+
+		void writeBytes(const void *data, size_t size)
+		{
+			size_t offset = mBuffer.size();
+			mBuffer.resize(offset + size);
+			if (size > 0) { memcpy(&mBuffer[offset], data, size); }
+		}
+
+		/*---------------------------------------------------------------------
+			Writes a 32-bit length followed by the characters
+		---------------------------------------------------------------------*/
+		void writeString(const string &s)
+		{
+			write(static_cast<uint32_t>(s.size()));
+			writeBytes(s.data(), s.size());
+		}
+
+		/*---------------------------------------------------------------------
+			Writes a 32-bit length followed by the wide characters, which are
+			sizeof(wchar_t) bytes each on the writing platform
+		---------------------------------------------------------------------*/
+		void writeWString(const wstring &s)
+		{
+			write(static_cast<uint32_t>(s.size()));
+			writeBytes(s.data(), s.size() * sizeof(wchar_t));
+		}
+
+		size_t size() const { return mBuffer.size(); }
+
+		explicit BinaryWriter(vector<uint8_t> &buffer) : mBuffer(buffer) {}
+};
+
+/*=============================================================================
+class BinaryReader
+	Reads values written by BinaryWriter from a block of memory. Reading past
+	the end fails rather than overrunning, the failed read leaves the output
+	zeroed and sets the stream's fail state, so a sequence of reads can be
+	checked once at the end with ok().
+=============================================================================*/
+class BinaryReader {
+	private:
+		const uint8_t *	mData;
+		size_t			mSize;
+		size_t			mPos;
+		bool			mFailed;
+
+	public:
+		template <typename T>
+		bool read(T &outValue)
+		{
+			static_assert(std::is_trivially_copyable<T>::value, "BinaryReader::read requires a trivially copyable type");
+			return readBytes(&outValue, sizeof(T));
+		}
+
+		bool readBytes(void *outData, size_t size)
+		{
+			if (mFailed || size > mSize - mPos) {
+				mFailed = true;
+				memset(outData, 0, size);
+				return false;
+			}
+			if (size > 0) { memcpy(outData, mData + mPos, size); }
+			mPos += size;
+			return true;
+		}
+
+		bool readString(string &outString)
+		{
+			uint32_t length = 0;
+			if (!read(length) || length > mSize - mPos) {
+				mFailed = true;
+				outString.clear();
+				return false;
+			}
+			outString.assign(reinterpret_cast<const char *>(mData + mPos), length);
+			mPos += length;
+			return true;
+		}
+
+		bool readWString(wstring &outString)
+		{
+			uint32_t length = 0;
+			if (!read(length) || length > (mSize - mPos) / sizeof(wchar_t)) {
+				mFailed = true;
+				outString.clear();
+				return false;
+			}
+			outString.resize(length);
+			if (length > 0) { memcpy(&outString[0], mData + mPos, length * sizeof(wchar_t)); }
+			mPos += length * sizeof(wchar_t);
+			return true;
+		}
+
+		bool skip(size_t size)
+		{
+			if (mFailed || size > mSize - mPos) {
+				mFailed = true;
+				return false;
+			}
+			mPos += size;
+			return true;
+		}
+
+		bool	ok() const			{ return !mFailed; }
+		size_t	position() const	{ return mPos; }
+		size_t	remaining() const	{ return mSize - mPos; }
+
+		explicit BinaryReader(const uint8_t *data, size_t size) :
+			mData(data), mSize(size), mPos(0), mFailed(false)
+		{}
+};
@@ -0,0 +1,244 @@
+/* BitStream.h
+Author: Jeff Kiah
+Orig.Date: 10/17/2026
+*/
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include "Utility/Debug.h"
+
+///// FUNCTIONS /////
+
+/*---------------------------------------------------------------------
+	Number of bits needed to hold any value from 0 to maxValue
+---------------------------------------------------------------------*/
+inline uint32_t bitsRequired(uint32_t maxValue)
+{
+	uint32_t bits = 0;
+	while (maxValue != 0) { ++bits; maxValue >>= 1; }
+	return bits;
+}
+
+///// STRUCTURES /////
+
+/*=============================================================================
+class BitWriter
+	Packs values of 1 to 32 bits into a caller-owned buffer, such as a packet
+	handed out by a transport, so nothing is allocated or copied afterwards.
+	Bits are filled from the least significant end and stored in
+	little-endian byte order regardless of platform. Pending bits collect in
+	a 64-bit scratch word and are stored a word at a time. Writing past the
+	capacity sets the fail state instead of overrunning, and mark/rewind
+	undo a partial write, so a caller can try to fit a record and back it
+	out if it doesn't. Call finish to store the last partial byte.
+=============================================================================*/
+class BitWriter {
+	public:
+		///// DEFINITIONS /////
+		struct Mark {
+			size_t		mBytePos;
+			uint64_t	mScratch;
+			uint32_t	mScratchBits;
+		};
+
+	private:
+		///// VARIABLES /////
+		uint8_t *	mData;
+		size_t		mCapacity;		// in bytes
+		size_t		mBytePos;		// bytes stored, the scratch bits follow
+		uint64_t	mScratch;
+		uint32_t	mScratchBits;
+		bool		mFailed;
+
+		///// FUNCTIONS /////
+		void storeBytes(uint32_t numBytes)
+		{
+			for (uint32_t b = 0; b < numBytes; ++b) {
+				mData[mBytePos++] = static_cast<uint8_t>(mScratch);
+				mScratch >>= 8;
+			}
+			mScratchBits -= numBytes * 8;
+		}
+
+	public:
+		/*---------------------------------------------------------------------
+			Writes the low numBits of value, numBits from 1 to 32
+		---------------------------------------------------------------------*/
+		bool writeBits(uint32_t value, uint32_t numBits)
+		{
+			_ASSERTE(numBits > 0 && numBits <= 32 && (numBits == 32 || (value >> numBits) == 0) && "BitWriter value doesn't fit");
+			if (mFailed || bitsWritten() + numBits > mCapacity * 8) {
+				mFailed = true;
+				return false;
+			}
+			mScratch |= static_cast<uint64_t>(value) << mScratchBits;
+			mScratchBits += numBits;
+			if (mScratchBits >= 32) { storeBytes(4); }
+			return true;
+		}
+
+		bool writeBool(bool value) { return writeBits((value ? 1 : 0), 1); }
+
+		/*---------------------------------------------------------------------
+			Pads with zero bits to the next byte boundary
+		---------------------------------------------------------------------*/
+		bool alignToByte()
+		{
+			uint32_t pad = (8 - (mScratchBits & 7)) & 7;
+			if (pad != 0 && !writeBits(0, pad)) { return false; }
+			storeBytes(mScratchBits / 8);
+			return true;
+		}
+
+		/*---------------------------------------------------------------------
+			Byte aligns, then copies size bytes straight into the buffer
+		---------------------------------------------------------------------*/
+		bool writeBytes(const void *data, size_t size)
+		{
+			if (!alignToByte()) { return false; }
+			if (size > mCapacity - mBytePos) {
+				mFailed = true;
+				return false;
+			}
+			if (size > 0) { memcpy(mData + mBytePos, data, size); }
+			mBytePos += size;
+			return true;
+		}
+
+		/*---------------------------------------------------------------------
+			Stores the pending bits, padding the last byte with zeros, and
+			returns the number of bytes used
+		---------------------------------------------------------------------*/
+		size_t finish()
+		{
+			uint32_t numBytes = (mScratchBits + 7) / 8;
+			mScratchBits = numBytes * 8;	// the padding is already zero
+			storeBytes(numBytes);
+			return mBytePos;
+		}
+
+		Mark	mark() const { Mark m = { mBytePos, mScratch, mScratchBits }; return m; }
+		/*---------------------------------------------------------------------
+			Returns to a mark taken earlier, discarding everything written
+			since and clearing the fail state
+		---------------------------------------------------------------------*/
+		void	rewind(const Mark &m)
+		{
+			mBytePos = m.mBytePos;
+			mScratch = m.mScratch;
+			mScratchBits = m.mScratchBits;
+			mFailed = false;
+		}
+
+		/*---------------------------------------------------------------------
+			Starts writing over a new buffer
+		---------------------------------------------------------------------*/
+		void	reset(uint8_t *data, size_t capacity)
+		{
+			mData = data;
+			mCapacity = capacity;
+			mBytePos = 0;
+			mScratch = 0;
+			mScratchBits = 0;
+			mFailed = false;
+		}
+
+		bool	ok() const			{ return !mFailed; }
+		size_t	bitsWritten() const	{ return mBytePos * 8 + mScratchBits; }
+		size_t	capacity() const	{ return mCapacity; }
+
+		explicit BitWriter(uint8_t *data = 0, size_t capacity = 0) { reset(data, capacity); }
+};
+
+/*=============================================================================
+class BitReader
+	Reads values packed by BitWriter directly from the buffer they arrived
+	in. Each read loads the 64-bit little-endian window holding the value
+	and shifts it out, with a byte at a time fallback near the end of the
+	buffer. readBytes returns a pointer into the buffer rather than copying.
+	Like BinaryReader, reading past the end sets the fail state and returns
+	zeros, so a sequence of reads can be checked once with ok().
+=============================================================================*/
+class BitReader {
+	private:
+		///// VARIABLES /////
+		const uint8_t *	mData;
+		size_t			mSize;		// in bytes
+		size_t			mBitPos;
+		bool			mFailed;
+
+	public:
+		/*---------------------------------------------------------------------
+			Reads numBits, from 1 to 32
+		---------------------------------------------------------------------*/
+		uint32_t readBits(uint32_t numBits)
+		{
+			_ASSERTE(numBits > 0 && numBits <= 32);
+			if (mFailed || numBits > mSize * 8 - mBitPos) {
+				mFailed = true;
+				return 0;
+			}
+			size_t byte = mBitPos >> 3;
+			uint64_t window = 0;
+			if (byte + 8 <= mSize) {
+				const uint8_t *p = mData + byte;
+				window = static_cast<uint64_t>(p[0])		| (static_cast<uint64_t>(p[1]) << 8)  |
+						 (static_cast<uint64_t>(p[2]) << 16) | (static_cast<uint64_t>(p[3]) << 24) |
+						 (static_cast<uint64_t>(p[4]) << 32) | (static_cast<uint64_t>(p[5]) << 40) |
+						 (static_cast<uint64_t>(p[6]) << 48) | (static_cast<uint64_t>(p[7]) << 56);
+			} else {
+				for (size_t b = byte; b < mSize; ++b) {
+					window |= static_cast<uint64_t>(mData[b]) << ((b - byte) * 8);
+				}
+			}
+			uint64_t mask = (static_cast<uint64_t>(1) << numBits) - 1;
+			uint32_t value = static_cast<uint32_t>((window >> (mBitPos & 7)) & mask);
+			mBitPos += numBits;
+			return value;
+		}
+
+		bool readBool() { return (readBits(1) != 0); }
+
+		/*---------------------------------------------------------------------
+			Skips to the next byte boundary
+		---------------------------------------------------------------------*/
+		bool alignToByte()
+		{
+			size_t aligned = (mBitPos + 7) & ~static_cast<size_t>(7);
+			if (mFailed || aligned > mSize * 8) {
+				mFailed = true;
+				return false;
+			}
+			mBitPos = aligned;
+			return true;
+		}
+
+		/*---------------------------------------------------------------------
+			Byte aligns and returns a pointer to the next size bytes in the
+			buffer, valid as long as the buffer is. Null on failure.
+		---------------------------------------------------------------------*/
+		const uint8_t *readBytes(size_t size)
+		{
+			if (!alignToByte() || size > mSize - (mBitPos >> 3)) {
+				mFailed = true;
+				return 0;
+			}
+			const uint8_t *p = mData + (mBitPos >> 3);
+			mBitPos += size * 8;
+			return p;
+		}
+
+		/*---------------------------------------------------------------------
+			Sets the fail state, for callers that find the data invalid
+		---------------------------------------------------------------------*/
+		void	fail()					{ mFailed = true; }
+
+		bool	ok() const				{ return !mFailed; }
+		size_t	bitsRead() const		{ return mBitPos; }
+		size_t	bitsRemaining() const	{ return mSize * 8 - mBitPos; }
+
+		explicit BitReader(const uint8_t *data, size_t size) :
+			mData(data), mSize(size), mBitPos(0), mFailed(false)
+		{}
+};
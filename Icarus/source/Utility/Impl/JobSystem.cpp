@@ -0,0 +1,225 @@
+/* JobSystem.cpp
+Author: Jeff Kiah
+Orig.Date: 10/17/2026
+*/
+
+#include "Utility/JobSystem.h"
+#include "Utility/PoolAllocator.h"
+#include "Utility/Debug.h"
+#include <new>
+#include <boost/thread/thread.hpp>
+
+///// FUNCTIONS /////
+
+////////// class JobSystem::JobDeque //////////
+
+bool JobSystem::JobDeque::push(Job *job)
+{
+	int64_t b = mBottom.load(std::memory_order_relaxed);
+	int64_t t = mTop.load(std::memory_order_acquire);
+	if (b - t > mMask) { return false; } // full
+	mBuffer[b & mMask].store(job, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	mBottom.store(b + 1, std::memory_order_relaxed);
+	return true;
+}
+
+/*---------------------------------------------------------------------
+	Takes the newest job. Only the last job can be contended by a
+	thief, the CAS on top settles who gets it.
+---------------------------------------------------------------------*/
+JobSystem::Job * JobSystem::JobDeque::pop()
+{
+	int64_t b = mBottom.load(std::memory_order_relaxed) - 1;
+	mBottom.store(b, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	int64_t t = mTop.load(std::memory_order_relaxed);
+	if (t > b) {
+		mBottom.store(b + 1, std::memory_order_relaxed); // was empty
+		return 0;
+	}
+	Job *job = mBuffer[b & mMask].load(std::memory_order_relaxed);
+	if (t == b) {
+		if (!mTop.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+			job = 0; // a thief got it
+		}
+		mBottom.store(b + 1, std::memory_order_relaxed);
+	}
+	return job;
+}
+
+/*---------------------------------------------------------------------
+	Takes the oldest job, returns null if the deque is empty or another
+	thread won the race for it
+---------------------------------------------------------------------*/
+JobSystem::Job * JobSystem::JobDeque::steal()
+{
+	int64_t t = mTop.load(std::memory_order_acquire);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	int64_t b = mBottom.load(std::memory_order_acquire);
+	if (t >= b) { return 0; }
+	Job *job = mBuffer[t & mMask].load(std::memory_order_relaxed);
+	if (!mTop.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+		return 0;
+	}
+	return job;
+}
+
+JobSystem::JobDeque::JobDeque(size_t capacity) :
+	mTop(0), mBottom(0), mBuffer(0), mMask(0)
+{
+	size_t size = 2;
+	while (size < capacity) { size <<= 1; }
+	mMask = static_cast<int64_t>(size - 1);
+	mBuffer = new std::atomic<Job*>[size];
+	for (size_t j = 0; j < size; ++j) {
+		mBuffer[j].store(0, std::memory_order_relaxed);
+	}
+}
+
+JobSystem::JobDeque::~JobDeque()
+{
+	delete [] mBuffer;
+}
+
+////////// class JobSystem //////////
+
+/*---------------------------------------------------------------------
+	Steals from each worker once, starting at startVictim and passing
+	over the worker at index skip
+---------------------------------------------------------------------*/
+JobSystem::Job * JobSystem::stealJob(uint32_t startVictim, uint32_t skip)
+{
+	uint32_t numWorkers = static_cast<uint32_t>(mWorkers.size());
+	for (uint32_t w = 0; w < numWorkers; ++w) {
+		uint32_t victim = (startVictim + w) % numWorkers;
+		if (victim == skip) { continue; }
+		Job *job = mWorkers[victim]->mDeque.steal();
+		if (job) { return job; }
+	}
+	return 0;
+}
+
+JobSystem::Job * JobSystem::findJob(Worker *self)
+{
+	Job *job = 0;
+	if (self) {
+		job = self->mDeque.pop();
+		if (job) { return job; }
+	}
+	if (mInjectQueue.tryPop(job)) { return job; }
+	if (self) {
+		job = stealJob(self->mNextVictim, self->mIndex);
+		self->mNextVictim = (self->mNextVictim + 1) % static_cast<uint32_t>(mWorkers.size());
+		return job;
+	}
+	return stealJob(0, static_cast<uint32_t>(-1));
+}
+
+void JobSystem::runJob(Job *job)
+{
+	job->mFunc();
+	JobCounter *counter = job->mCounter;
+	// free the record before signaling, the waiter may tear down whatever the job referenced
+	job->~Job();
+	SlabPool::deallocate(SlabPool_Job, job, sizeof(Job));
+	if (counter) { counter->done(); }
+}
+
+/*---------------------------------------------------------------------
+	Worker thread loop. Runs jobs until shutdown and the queues are
+	drained, sleeping when there is nothing to run or steal.
+---------------------------------------------------------------------*/
+void JobSystem::workerProc(Worker *self)
+{
+	mLocalWorker.reset(self);
+	for (;;) {
+		Job *job = findJob(self);
+		if (job) {
+			runJob(job);
+			continue;
+		}
+		uint32_t key = mIdle.prepareWait();
+		job = findJob(self);
+		if (job) {
+			mIdle.cancelWait();
+			runJob(job);
+			continue;
+		}
+		if (mShutdown.load(std::memory_order_acquire)) {
+			mIdle.cancelWait();
+			break;
+		}
+		mIdle.commitWait(key);
+	}
+	mLocalWorker.reset();
+}
+
+void JobSystem::submit(const JobFunc &func, JobCounter *counter)
+{
+	_ASSERTE(func && "Empty job");
+	Job *job = new (SlabPool::local(SlabPool_Job).allocate(sizeof(Job))) Job();
+	job->mFunc = func;
+	job->mCounter = counter;
+	if (counter) { counter->add(); }
+
+	Worker *self = mLocalWorker.get();
+	if (!self || !self->mDeque.push(job)) {
+		mInjectQueue.push(job);
+	}
+	// one job needs one worker, the rest stay asleep
+	mIdle.notifyOne();
+}
+
+bool JobSystem::runOne()
+{
+	Job *job = findJob(mLocalWorker.get());
+	if (!job) { return false; }
+	runJob(job);
+	return true;
+}
+
+void JobSystem::waitFor(const JobCounter &counter)
+{
+	while (!counter.finished()) {
+		if (!runOne()) { boost::this_thread::yield(); }
+	}
+}
+
+uint32_t JobSystem::defaultNumThreads()
+{
+	uint32_t hwThreads = boost::thread::hardware_concurrency();
+	return (hwThreads > 1) ? hwThreads - 1 : 1;
+}
+
+// Constructor / destructor
+JobSystem::JobSystem(uint32_t numThreads, size_t dequeCapacity) :
+	mInjectQueue(),
+	mLocalWorker(&JobSystem::noCleanup),
+	mShutdown(false)
+{
+	_ASSERTE(numThreads > 0);
+	// every deque exists before any worker starts stealing
+	for (uint32_t t = 0; t < numThreads; ++t) {
+		mWorkers.push_back(new Worker(t, dequeCapacity));
+	}
+	for (uint32_t t = 0; t < numThreads; ++t) {
+		mWorkers[t]->mThread = new boost::thread(&JobSystem::workerProc, this, mWorkers[t]);
+	}
+	debugPrintf("JobSystem: started %u threads\n", numThreads);
+}
+
+JobSystem::~JobSystem()
+{
+	mShutdown.store(true, std::memory_order_release);
+	mIdle.notify();
+	for (size_t t = 0; t < mWorkers.size(); ++t) {
+		mWorkers[t]->mThread->join();
+		delete mWorkers[t]->mThread;
+	}
+	// anything still queued was submitted during shutdown, run it here so no counter is left waiting
+	while (runOne()) {}
+	for (size_t t = 0; t < mWorkers.size(); ++t) {
+		delete mWorkers[t];
+	}
+}
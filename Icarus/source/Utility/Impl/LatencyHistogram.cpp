@@ -0,0 +1,56 @@
+/* LatencyHistogram.cpp
+Author: Jeff Kiah
+Orig.Date: 10/17/2026
+*/
+
+#include "Utility/LatencyHistogram.h"
+#include <cstring>
+
+////////// class LatencyHistogram //////////
+
+uint64_t LatencyHistogram::bucketUpperValue(uint32_t b)
+{
+	if (b < SubBuckets) { return b; }
+	uint32_t magnitude = b / SubBuckets - 1;
+	uint64_t sub = b % SubBuckets;
+	return ((SubBuckets + sub + 1) << magnitude) - 1;
+}
+
+void LatencyHistogram::merge(const LatencyHistogram &other)
+{
+	if (other.mTotalCount == 0) { return; }
+	for (uint32_t b = 0; b < NumBuckets; ++b) {
+		mCounts[b] += other.mCounts[b];
+	}
+	mTotalCount += other.mTotalCount;
+	mTotalValue += other.mTotalValue;
+	if (other.mMin < mMin) { mMin = other.mMin; }
+	if (other.mMax > mMax) { mMax = other.mMax; }
+}
+
+void LatencyHistogram::reset()
+{
+	memset(mCounts, 0, sizeof(mCounts));
+	mTotalCount = 0;
+	mTotalValue = 0;
+	mMin = UINT64_MAX;
+	mMax = 0;
+}
+
+uint64_t LatencyHistogram::percentile(double pct) const
+{
+	if (mTotalCount == 0) { return 0; }
+	if (pct >= 100.0) { return mMax; }
+	uint64_t target = static_cast<uint64_t>(pct * 0.01 * static_cast<double>(mTotalCount) + 0.5);
+	if (target == 0) { target = 1; }
+
+	uint64_t seen = 0;
+	for (uint32_t b = 0; b < NumBuckets; ++b) {
+		seen += mCounts[b];
+		if (seen >= target) {
+			uint64_t value = bucketUpperValue(b);
+			return (value < mMax ? value : mMax);
+		}
+	}
+	return mMax;
+}
@@ -0,0 +1,239 @@
+/* PoolAllocator.cpp
+Author: Jeff Kiah
+Orig.Date: 10/17/2026
+*/
+
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN	// defined in project settings
+#endif
+
+#include "Utility/PoolAllocator.h"
+#include "Utility/Debug.h"
+#include <Windows.h>
+#include <new>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/tss.hpp>
+
+///// STRUCTURES /////
+
+/*=============================================================================
+struct SlabPoolRegistry
+	Owns every SlabPool ever created. Pools are never destroyed while the
+	program runs since blocks from a finished thread's pool may still be
+	alive elsewhere, instead the pools of exited threads are parked here and
+	handed to the next thread that needs one.
+=============================================================================*/
+struct SlabPoolRegistry {
+	boost::mutex			mMutex;
+	std::vector<SlabPool*>	mPools[SlabPool_MAX];	// all pools, for stats
+	std::vector<SlabPool*>	mIdle[SlabPool_MAX];	// pools released by exited threads
+
+	/*---------------------------------------------------------------------
+		Per-thread set of pools, returned to the registry at thread exit
+	---------------------------------------------------------------------*/
+	struct ThreadPools {
+		SlabPool *	pool[SlabPool_MAX];
+	};
+	boost::thread_specific_ptr<ThreadPools>	mThreadPools;
+
+	static void releaseThreadPools(ThreadPools *tp);
+	static SlabPoolRegistry & instance();
+
+	SlabPoolRegistry() : mThreadPools(&SlabPoolRegistry::releaseThreadPools) {}
+};
+
+///// VARIABLES /////
+
+const uint32_t SlabPool::sBlockSize[SlabPool::NumSizeClasses] = {
+	16, 32, 48, 64, 80, 96, 128, 160, 192, 256, 320, 384, 512
+};
+
+///// FUNCTIONS /////
+
+// struct SlabPoolRegistry
+
+SlabPoolRegistry & SlabPoolRegistry::instance()
+{
+	static SlabPoolRegistry sRegistry;
+	return sRegistry;
+}
+
+void SlabPoolRegistry::releaseThreadPools(ThreadPools *tp)
+{
+	SlabPoolRegistry &reg = instance();
+	boost::mutex::scoped_lock lock(reg.mMutex);
+	for (int p = 0; p < SlabPool_MAX; ++p) {
+		if (tp->pool[p]) { reg.mIdle[p].push_back(tp->pool[p]); }
+	}
+	delete tp;
+}
+
+// class SlabPool
+
+/*---------------------------------------------------------------------
+	Maps a request size to its size class, or NumSizeClasses if the
+	request is too large for the pool
+---------------------------------------------------------------------*/
+uint32_t SlabPool::sizeClassOf(size_t size)
+{
+	for (uint32_t c = 0; c < NumSizeClasses; ++c) {
+		if (size <= sBlockSize[c]) { return c; }
+	}
+	return NumSizeClasses;
+}
+
+/*---------------------------------------------------------------------
+	Reserves a new slab and threads its blocks onto the local free list
+---------------------------------------------------------------------*/
+void SlabPool::addSlab(uint32_t sizeClass)
+{
+	// VirtualAlloc hands out 64KB aligned regions, which is what lets deallocate find the header
+	char *slab = static_cast<char *>(VirtualAlloc(0, SlabSize, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE));
+	if (!slab) { throw std::bad_alloc(); }
+	mSlabs.push_back(slab);
+
+	SlabHeader &header = *reinterpret_cast<SlabHeader *>(slab);
+	header.owner = this;
+	header.sizeClass = sizeClass;
+
+	const size_t blockSize = sBlockSize[sizeClass];
+	const size_t firstBlock = (sizeof(SlabHeader) + 15) & ~static_cast<size_t>(15);
+	for (size_t b = firstBlock; b + blockSize <= SlabSize; b += blockSize) {
+		FreeBlock *block = reinterpret_cast<FreeBlock *>(slab + b);
+		block->next = mFreeList[sizeClass];
+		mFreeList[sizeClass] = block;
+	}
+}
+
+/*---------------------------------------------------------------------
+	Local free list is empty, reclaim blocks freed by other threads or
+	reserve a new slab
+---------------------------------------------------------------------*/
+void * SlabPool::allocateSlow(uint32_t sizeClass)
+{
+	FreeBlock *remote = mRemoteFreeList[sizeClass].exchange(0, std::memory_order_acquire);
+	if (remote) {
+		mFreeList[sizeClass] = remote;
+	} else {
+		addSlab(sizeClass);
+	}
+	FreeBlock *block = mFreeList[sizeClass];
+	mFreeList[sizeClass] = block->next;
+	return block;
+}
+
+void * SlabPool::allocate(size_t size)
+{
+	bump(mAllocations);
+	uint32_t sizeClass = sizeClassOf(size);
+	if (sizeClass == NumSizeClasses) {
+		bump(mLargeAllocations);
+		mBytesInUse.fetch_add(static_cast<int64_t>(size), std::memory_order_relaxed);
+		return ::operator new(size);
+	}
+	mBytesInUse.fetch_add(sBlockSize[sizeClass], std::memory_order_relaxed);
+
+	FreeBlock *block = mFreeList[sizeClass];
+	if (!block) { return allocateSlow(sizeClass); }
+	mFreeList[sizeClass] = block->next;
+	return block;
+}
+
+void SlabPool::deallocate(SlabPoolId poolId, void *p, size_t size)
+{
+	if (!p) { return; }
+	if (sizeClassOf(size) == NumSizeClasses) {
+		// large blocks carry no slab header, so they are counted against the freeing thread's
+		// pool, which balances out in the summed stats
+		::operator delete(p);
+		SlabPool &pool = local(poolId);
+		pool.mDeallocations.fetch_add(1, std::memory_order_relaxed);
+		pool.mBytesInUse.fetch_sub(static_cast<int64_t>(size), std::memory_order_relaxed);
+		return;
+	}
+
+	SlabHeader &header = *reinterpret_cast<SlabHeader *>(
+							reinterpret_cast<uintptr_t>(p) & ~static_cast<uintptr_t>(SlabSize - 1));
+	SlabPool &owner = *header.owner;
+	FreeBlock *block = static_cast<FreeBlock *>(p);
+	owner.mBytesInUse.fetch_sub(sBlockSize[header.sizeClass], std::memory_order_relaxed);
+
+	SlabPoolRegistry::ThreadPools *tp = SlabPoolRegistry::instance().mThreadPools.get();
+	if (tp && tp->pool[owner.mPoolId] == &owner) {
+		// freed by the owning thread, straight back on the local list
+		owner.mDeallocations.fetch_add(1, std::memory_order_relaxed);
+		block->next = owner.mFreeList[header.sizeClass];
+		owner.mFreeList[header.sizeClass] = block;
+	} else {
+		// freed by another thread, push onto the owner's remote list
+		owner.mDeallocations.fetch_add(1, std::memory_order_relaxed);
+		owner.mRemoteDeallocations.fetch_add(1, std::memory_order_relaxed);
+		std::atomic<FreeBlock*> &remote = owner.mRemoteFreeList[header.sizeClass];
+		FreeBlock *head = remote.load(std::memory_order_relaxed);
+		do {
+			block->next = head;
+		} while (!remote.compare_exchange_weak(head, block, std::memory_order_release, std::memory_order_relaxed));
+	}
+}
+
+SlabPool & SlabPool::local(SlabPoolId poolId)
+{
+	SlabPoolRegistry &reg = SlabPoolRegistry::instance();
+	SlabPoolRegistry::ThreadPools *tp = reg.mThreadPools.get();
+	if (tp && tp->pool[poolId]) { return *tp->pool[poolId]; }
+
+	if (!tp) {
+		tp = new SlabPoolRegistry::ThreadPools();
+		for (int p = 0; p < SlabPool_MAX; ++p) { tp->pool[p] = 0; }
+		reg.mThreadPools.reset(tp);
+	}
+
+	// adopt a pool parked by an exited thread, or create a new one
+	boost::mutex::scoped_lock lock(reg.mMutex);
+	if (!reg.mIdle[poolId].empty()) {
+		tp->pool[poolId] = reg.mIdle[poolId].back();
+		reg.mIdle[poolId].pop_back();
+	} else {
+		tp->pool[poolId] = new SlabPool(poolId);
+		reg.mPools[poolId].push_back(tp->pool[poolId]);
+		debugPrintf("SlabPool: pool %i created, %u total\n", (int)poolId, (uint32_t)reg.mPools[poolId].size());
+	}
+	return *tp->pool[poolId];
+}
+
+SlabPool::Stats SlabPool::stats(SlabPoolId poolId)
+{
+	Stats s = { 0, 0, 0, 0, 0, 0, 0 };
+	SlabPoolRegistry &reg = SlabPoolRegistry::instance();
+	boost::mutex::scoped_lock lock(reg.mMutex);
+	for (size_t p = 0; p < reg.mPools[poolId].size(); ++p) {
+		const SlabPool &pool = *reg.mPools[poolId][p];
+		s.allocations			+= pool.mAllocations.load(std::memory_order_relaxed);
+		s.deallocations			+= pool.mDeallocations.load(std::memory_order_relaxed);
+		s.remoteDeallocations	+= pool.mRemoteDeallocations.load(std::memory_order_relaxed);
+		s.largeAllocations		+= pool.mLargeAllocations.load(std::memory_order_relaxed);
+		s.bytesInUse			+= pool.mBytesInUse.load(std::memory_order_relaxed);
+		s.slabs					+= pool.mSlabs.size(); // racy read of the owner's vector size, only a hint
+	}
+	s.pools = static_cast<uint32_t>(reg.mPools[poolId].size());
+	return s;
+}
+
+// Constructor / destructor
+SlabPool::SlabPool(SlabPoolId poolId) :
+	mPoolId(poolId),
+	mAllocations(0), mDeallocations(0), mRemoteDeallocations(0),
+	mLargeAllocations(0), mBytesInUse(0)
+{
+	for (int c = 0; c < NumSizeClasses; ++c) {
+		mFreeList[c] = 0;
+		mRemoteFreeList[c].store(0, std::memory_order_relaxed);
+	}
+}
+
+SlabPool::~SlabPool()
+{
+	for (size_t s = 0; s < mSlabs.size(); ++s) {
+		VirtualFree(mSlabs[s], 0, MEM_RELEASE);
+	}
+}
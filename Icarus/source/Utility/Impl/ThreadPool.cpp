@@ -0,0 +1,231 @@
+/* ThreadPool.cpp
+Author: Jeff Kiah
+Orig.Date: 10/17/2026
+*/
+
+#include "Utility/ThreadPool.h"
+#include "Utility/Debug.h"
+#include <algorithm>
+
+#if defined(WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN	// defined in project settings
+#endif
+#include <Windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#endif
+
+///// FUNCTIONS /////
+
+ThreadPool::TaskPtr ThreadPool::popWaiting()
+{
+	for (int c = ThreadClass_MAX - 1; c >= 0; --c) {
+		if (!mWaiting[c].empty()) {
+			TaskPtr task(mWaiting[c].front());
+			mWaiting[c].pop_front();
+			return task;
+		}
+	}
+	return TaskPtr();
+}
+
+void ThreadPool::threadLoop()
+{
+	boost::mutex::scoped_lock lock(mMutex);
+	for (;;) {
+		TaskPtr task(popWaiting());
+		if (!task) {
+			if (mShutdown) { break; }
+			++mIdleThreads;
+			mTaskReady.wait(lock);
+			--mIdleThreads;
+			continue;
+		}
+		task->mState = Task::Task_Running;
+		task->mThreadId = boost::this_thread::get_id();
+		uint64_t affinityMask = mConfig.affinityMask[task->mClass];
+		lock.unlock();
+
+		setCurrentThreadClass(task->mClass, affinityMask);
+		task->mFunc();
+
+		lock.lock();
+		task->mState = Task::Task_Done;
+		task->mThreadId = boost::thread::id();
+		task->mFunc = TaskFunc(); // let go of the captures now, the handle may live on
+		mTaskDone.notify_all();
+	}
+}
+
+ThreadPool::TaskPtr ThreadPool::start(const TaskFunc &func, const std::string &name, ThreadClass threadClass)
+{
+	_ASSERTE(func && threadClass < ThreadClass_MAX);
+	TaskPtr task(std::make_shared<Task>(func, name, threadClass));
+
+	boost::mutex::scoped_lock lock(mMutex);
+	_ASSERTE(!mShutdown);
+	mWaiting[threadClass].push_back(task);
+
+	// idle threads only stop counting as idle once they wake, so compare against everything waiting
+	uint32_t waiting = 0;
+	for (int c = 0; c < ThreadClass_MAX; ++c) { waiting += static_cast<uint32_t>(mWaiting[c].size()); }
+	if (waiting > mIdleThreads) {
+		if (mThreads.size() < mConfig.maxThreads) {
+			mThreads.push_back(new boost::thread(&ThreadPool::threadLoop, this));
+		} else {
+			debugPrintf("ThreadPool: \"%s\" waiting, all %u threads busy\n", name.c_str(), mConfig.maxThreads);
+		}
+	}
+	mTaskReady.notify_one();
+	return task;
+}
+
+bool ThreadPool::join(const TaskPtr &task)
+{
+	boost::mutex::scoped_lock lock(mMutex);
+	_ASSERTE(task->mThreadId != boost::this_thread::get_id() && "Task can't join itself");
+	if (task->mState == Task::Task_Waiting) {
+		std::deque<TaskPtr> &waiting = mWaiting[task->mClass];
+		waiting.erase(std::find(waiting.begin(), waiting.end(), task));
+		task->mState = Task::Task_Done;
+		task->mFunc = TaskFunc();
+		return false;
+	}
+	while (task->mState != Task::Task_Done) {
+		mTaskDone.wait(lock);
+	}
+	return true;
+}
+
+boost::thread::id ThreadPool::threadId(const TaskPtr &task)
+{
+	boost::mutex::scoped_lock lock(mMutex);
+	return task->mThreadId;
+}
+
+uint32_t ThreadPool::numThreads()
+{
+	boost::mutex::scoped_lock lock(mMutex);
+	return static_cast<uint32_t>(mThreads.size());
+}
+
+uint32_t ThreadPool::numWaiting()
+{
+	boost::mutex::scoped_lock lock(mMutex);
+	uint32_t waiting = 0;
+	for (int c = 0; c < ThreadClass_MAX; ++c) { waiting += static_cast<uint32_t>(mWaiting[c].size()); }
+	return waiting;
+}
+
+bool ThreadPool::setCurrentThreadClass(ThreadClass threadClass, uint64_t affinityMask)
+{
+	bool ok = pinCurrentThread(affinityMask);
+
+	#if defined(WIN32)
+	HANDLE hThread = GetCurrentThread();
+	// leave background mode from the thread's last task, fails harmlessly if it wasn't in it
+	SetThreadPriority(hThread, THREAD_MODE_BACKGROUND_END);
+	BOOL set = TRUE;
+	switch (threadClass) {
+		case ThreadClass_Background:
+			// lowers I/O and memory priority along with the CPU priority
+			set = SetThreadPriority(hThread, THREAD_MODE_BACKGROUND_BEGIN);
+			break;
+		case ThreadClass_Latency:
+			set = SetThreadPriority(hThread, THREAD_PRIORITY_ABOVE_NORMAL);
+			break;
+		default:
+			set = SetThreadPriority(hThread, THREAD_PRIORITY_NORMAL);
+			break;
+	}
+	if (!set) {
+		debugPrintf("ThreadPool: could not set thread priority, error %u\n", GetLastError());
+		ok = false;
+	}
+	#elif defined(__linux__)
+	static const int niceness[ThreadClass_MAX] = { 10, 0, -5 };
+	// per thread nice values, raising priority needs CAP_SYS_NICE
+	if (setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), niceness[threadClass]) != 0) {
+		debugPrintf("ThreadPool: could not set thread nice value to %i\n", niceness[threadClass]);
+		ok = false;
+	}
+	#endif
+	return ok;
+}
+
+bool ThreadPool::pinCurrentThread(uint64_t affinityMask)
+{
+	#if defined(WIN32)
+	DWORD_PTR mask = static_cast<DWORD_PTR>(affinityMask);
+	if (mask == 0) {
+		DWORD_PTR systemMask = 0;
+		GetProcessAffinityMask(GetCurrentProcess(), &mask, &systemMask);
+	}
+	if (SetThreadAffinityMask(GetCurrentThread(), mask) == 0) {
+		debugPrintf("ThreadPool: could not set thread affinity, error %u\n", GetLastError());
+		return false;
+	}
+	#elif defined(__linux__)
+	cpu_set_t cpus;
+	CPU_ZERO(&cpus);
+	for (int c = 0; c < 64 && c < CPU_SETSIZE; ++c) {
+		if (affinityMask == 0 || (affinityMask & (1ULL << c))) { CPU_SET(c, &cpus); }
+	}
+	if (pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) != 0) {
+		debugPrintf("ThreadPool: could not set thread affinity\n");
+		return false;
+	}
+	#endif
+	return true;
+}
+
+ThreadPool::Config ThreadPool::defaultConfig(uint32_t maxThreads)
+{
+	Config config;
+	config.maxThreads = (maxThreads > 0 ? maxThreads : 1);
+	uint32_t hwThreads = boost::thread::hardware_concurrency();
+	uint64_t mask = 0;
+	if (hwThreads >= 4) {
+		mask = (hwThreads >= 64 ? ~0ULL : (1ULL << hwThreads) - 1) & ~1ULL;
+	}
+	for (int c = 0; c < ThreadClass_MAX; ++c) {
+		config.affinityMask[c] = mask;
+	}
+	return config;
+}
+
+// Constructor / destructor
+ThreadPool::ThreadPool(const Config &config) :
+	mConfig(config),
+	mIdleThreads(0),
+	mShutdown(false)
+{
+	_ASSERTE(mConfig.maxThreads > 0);
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		boost::mutex::scoped_lock lock(mMutex);
+		mShutdown = true;
+		for (int c = 0; c < ThreadClass_MAX; ++c) {
+			for (size_t t = 0; t < mWaiting[c].size(); ++t) {
+				debugPrintf("ThreadPool: \"%s\" dropped at shutdown, it never started\n", mWaiting[c][t]->mName.c_str());
+				mWaiting[c][t]->mState = Task::Task_Done;
+			}
+			mWaiting[c].clear();
+		}
+		mTaskReady.notify_all();
+		mTaskDone.notify_all();
+	}
+	for (size_t t = 0; t < mThreads.size(); ++t) {
+		mThreads[t]->join();
+		delete mThreads[t];
+	}
+	debugPrintf("ThreadPool: stopped %u threads\n", static_cast<uint32_t>(mThreads.size()));
+}
@@ -0,0 +1,155 @@
+/* JobSystem.h
+Author: Jeff Kiah
+Orig.Date: 10/17/2026
+*/
+#pragma once
+
+#include <cstdint>
+#include <atomic>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <boost/noncopyable.hpp>
+#include <boost/thread/tss.hpp>
+#include "LockFreeQueue.h"
+
+namespace boost { class thread; }
+
+///// STRUCTURES /////
+
+/*=============================================================================
+class JobSystem
+	A fixed set of worker threads, one per core less the main thread, that
+	run small jobs with work stealing. Each worker owns a Chase-Lev deque of
+	jobs: it pushes and pops its own jobs at the bottom, so jobs spawned from
+	a job run on the same core while their data is still in cache, and idle
+	workers steal from the top of the others. Jobs submitted from threads
+	outside the pool, or that overflow a full deque, go through a shared
+	lock-free MPMC inject queue. Workers with nothing to run or steal sleep
+	on an EventCount, so submitting only costs an atomic load when every
+	worker is busy, and otherwise wakes just one of them.
+	Jobs are fire and forget, to wait for a batch pass a JobCounter to submit
+	and call waitFor(counter), which runs and steals jobs on the calling
+	thread until the counter reaches zero instead of sleeping. Job records
+	come from the SlabPool_Job pool, so steady state submission doesn't reach
+	the heap unless the job's captures are too big for std::function to hold
+	in place.
+	One JobSystem is meant to be shared, the Application hands the same one
+	to the EventManager and the ProcessManager.
+=============================================================================*/
+class JobSystem : private boost::noncopyable {
+	public:
+		///// DEFINITIONS /////
+		typedef std::function<void()>	JobFunc;
+
+		/*---------------------------------------------------------------------
+			Counts outstanding jobs of one batch. submit adds to it and the
+			job marks itself done after it runs.
+		---------------------------------------------------------------------*/
+		class JobCounter : private boost::noncopyable {
+			friend class JobSystem;
+			private:
+				std::atomic<uint32_t>	mPending;
+			public:
+				void	add(uint32_t n = 1)	{ mPending.fetch_add(n, std::memory_order_relaxed); }
+				void	done()				{ mPending.fetch_sub(1, std::memory_order_release); }
+				bool	finished() const	{ return (mPending.load(std::memory_order_acquire) == 0); }
+				explicit JobCounter() : mPending(0) {}
+		};
+
+	private:
+		///// STRUCTURES /////
+		struct Job {
+			JobFunc			mFunc;
+			JobCounter *	mCounter;
+		};
+
+		/*---------------------------------------------------------------------
+			Fixed size Chase-Lev work-stealing deque. push and pop are only
+			called by the owning worker, steal by any thread. A full deque
+			refuses the push rather than growing.
+		---------------------------------------------------------------------*/
+		class JobDeque : private boost::noncopyable {
+			private:
+				enum : size_t { CacheLineSize = 64 };
+				char						mPad0[CacheLineSize];
+				std::atomic<int64_t>		mTop;		// next to steal, advanced by thieves and by pop of the last job
+				char						mPad1[CacheLineSize - sizeof(std::atomic<int64_t>)];
+				std::atomic<int64_t>		mBottom;	// next free slot, only written by the owner
+				char						mPad2[CacheLineSize - sizeof(std::atomic<int64_t>)];
+				std::atomic<Job*> *			mBuffer;
+				int64_t						mMask;
+			public:
+				bool	push(Job *job);
+				Job *	pop();
+				Job *	steal();
+				explicit JobDeque(size_t capacity);
+				~JobDeque();
+		};
+
+		struct Worker {
+			JobDeque		mDeque;
+			uint32_t		mIndex;
+			uint32_t		mNextVictim;	// where the next steal attempt starts, spreads thieves over the deques
+			boost::thread *	mThread;
+			explicit Worker(uint32_t index, size_t dequeCapacity) :
+				mDeque(dequeCapacity), mIndex(index), mNextVictim(index + 1), mThread(0)
+			{}
+		};
+
+		///// VARIABLES /////
+		std::vector<Worker*>					mWorkers;
+		MPMCQueue<Job*>							mInjectQueue;
+		boost::thread_specific_ptr<Worker>		mLocalWorker;	// the calling thread's Worker, null outside the pool
+		EventCount								mIdle;			// workers sleep here when there is nothing to run or steal
+		std::atomic<bool>						mShutdown;
+
+		///// FUNCTIONS /////
+		static void	noCleanup(Worker *) {}
+
+		Job *	findJob(Worker *self);
+		Job *	stealJob(uint32_t startVictim, uint32_t skip);
+		void	runJob(Job *job);
+		void	workerProc(Worker *self);
+
+	public:
+		/*---------------------------------------------------------------------
+			Queues a job, counting it in counter if one is given. From a
+			worker the job goes on its own deque, otherwise to the inject
+			queue. Thread safe.
+		---------------------------------------------------------------------*/
+		void	submit(const JobFunc &func, JobCounter *counter = 0);
+
+		/*---------------------------------------------------------------------
+			Runs one job on the calling thread, the caller's own job first if
+			it is a worker, then the inject queue, then one stolen from a
+			worker. Returns false if no job was found.
+		---------------------------------------------------------------------*/
+		bool	runOne();
+
+		/*---------------------------------------------------------------------
+			Helps run jobs until the counter reaches zero. Safe to call from
+			inside a job, which is how jobs wait on jobs they spawn.
+		---------------------------------------------------------------------*/
+		void	waitFor(const JobCounter &counter);
+
+		size_t	numThreads() const	{ return mWorkers.size(); }
+
+		/*---------------------------------------------------------------------
+			Returns true when called from one of this system's workers
+		---------------------------------------------------------------------*/
+		bool	onWorkerThread() const	{ return (mLocalWorker.get() != 0); }
+
+		/*---------------------------------------------------------------------
+			Returns a default thread count, one less than the number of
+			hardware threads so the main thread keeps a core, at least 1
+		---------------------------------------------------------------------*/
+		static uint32_t	defaultNumThreads();
+
+		// Constructor / destructor
+		explicit JobSystem(uint32_t numThreads, size_t dequeCapacity = 1024);
+		~JobSystem();
+};
+
+typedef std::shared_ptr<JobSystem>	JobSystemPtr;
+typedef std::weak_ptr<JobSystem>	JobSystemWeakPtr;
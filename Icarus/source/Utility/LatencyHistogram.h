@@ -0,0 +1,94 @@
+/* LatencyHistogram.h
+Author: Jeff Kiah
+Orig.Date: 10/17/2026
+*/
+#pragma once
+
+#include <cstdint>
+
+///// STRUCTURES /////
+
+/*=============================================================================
+class LatencyHistogram
+	Fixed size log-linear histogram of durations, in the style of an HDR
+	histogram. Values below 16 get a bucket each, above that every power of
+	two is split into 16 linear sub-buckets, so any recorded value is known
+	to within 1/16th (about 6%) at every scale. Recording is a few shifts and
+	an increment, with no allocation, so it can sit in hot dispatch paths.
+	Units are whatever the caller records, usually Timer counts. Values past
+	the top bucket, about 2^44, are clamped into it.
+=============================================================================*/
+class LatencyHistogram {
+	public:
+		///// DEFINITIONS /////
+		enum : uint32_t {
+			SubBucketBits	= 4,
+			SubBuckets		= 1 << SubBucketBits,
+			Magnitudes		= 40,							// powers of two above SubBuckets
+			NumBuckets		= SubBuckets * (Magnitudes + 1)
+		};
+
+	private:
+		///// VARIABLES /////
+		uint32_t	mCounts[NumBuckets];
+		uint64_t	mTotalCount;
+		uint64_t	mTotalValue;
+		uint64_t	mMin;
+		uint64_t	mMax;
+
+		///// FUNCTIONS /////
+		static uint32_t bucketOf(uint64_t value)
+		{
+			if (value < SubBuckets) { return static_cast<uint32_t>(value); }
+			// find the most significant bit, value is at least SubBuckets so msb >= SubBucketBits
+			uint32_t msb = 0;
+			uint64_t v = value;
+			if (v >> 32) { v >>= 32; msb += 32; }
+			if (v >> 16) { v >>= 16; msb += 16; }
+			if (v >> 8)  { v >>= 8;  msb += 8; }
+			if (v >> 4)  { v >>= 4;  msb += 4; }
+			if (v >> 2)  { v >>= 2;  msb += 2; }
+			if (v >> 1)  { msb += 1; }
+			uint32_t magnitude = msb - SubBucketBits;
+			if (magnitude >= Magnitudes) { return NumBuckets - 1; }
+			uint32_t sub = static_cast<uint32_t>(value >> magnitude) - SubBuckets;
+			return SubBuckets * (magnitude + 1) + sub;
+		}
+
+	public:
+		/*---------------------------------------------------------------------
+			Returns the highest value that falls in bucket b
+		---------------------------------------------------------------------*/
+		static uint64_t bucketUpperValue(uint32_t b);
+
+		void record(uint64_t value)
+		{
+			++mCounts[bucketOf(value)];
+			++mTotalCount;
+			mTotalValue += value;
+			if (value < mMin) { mMin = value; }
+			if (value > mMax) { mMax = value; }
+		}
+
+		/*---------------------------------------------------------------------
+			Adds the samples of another histogram to this one
+		---------------------------------------------------------------------*/
+		void merge(const LatencyHistogram &other);
+		void reset();
+
+		/*---------------------------------------------------------------------
+			Returns the value at or below which pct percent of the samples
+			fall, accurate to the bucket, clamped to the recorded max.
+			Returns 0 if empty.
+		---------------------------------------------------------------------*/
+		uint64_t percentile(double pct) const;
+
+		uint64_t	count() const	{ return mTotalCount; }
+		uint64_t	total() const	{ return mTotalValue; }
+		uint64_t	minValue() const { return (mTotalCount > 0 ? mMin : 0); }
+		uint64_t	maxValue() const { return mMax; }
+		double		mean() const	{ return (mTotalCount > 0 ? static_cast<double>(mTotalValue) / mTotalCount : 0.0); }
+
+		// Constructor
+		explicit LatencyHistogram() { reset(); }
+};
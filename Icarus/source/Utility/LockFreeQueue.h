@@ -0,0 +1,317 @@
+/* LockFreeQueue.h
+Author: Jeff Kiah
+Orig.Date: 10/17/2026
+*/
+#pragma once
+
+#include <cstdint>
+#include <atomic>
+#include <utility>
+#include <deque>
+#include <boost/noncopyable.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+
+///// STRUCTURES /////
+
+/*=============================================================================
+class EventCount
+	Lets a consumer block on a lock-free structure without putting a lock on
+	the producer's path. A producer only touches the mutex when a consumer is
+	actually asleep, otherwise notify() is a single atomic load. Usage by the
+	consumer is always prepareWait, re-check the condition, then cancelWait or
+	commitWait, so a notify between the check and the sleep is never lost.
+=============================================================================*/
+class EventCount : private boost::noncopyable {
+	private:
+		std::atomic<uint32_t>		mWaiters;	// number of threads between prepareWait and the end of commitWait
+		std::atomic<uint32_t>		mEpoch;		// bumped by every notify that finds waiters
+		boost::mutex				mMutex;
+		boost::condition_variable	mCondVar;
+
+	public:
+		/*---------------------------------------------------------------------
+			Registers the calling thread as a waiter and returns the key to
+			pass to commitWait. The caller must check its condition again
+			after this returns.
+		---------------------------------------------------------------------*/
+		uint32_t prepareWait()
+		{
+			mWaiters.fetch_add(1, std::memory_order_seq_cst);
+			return mEpoch.load(std::memory_order_seq_cst);
+		}
+
+		/*---------------------------------------------------------------------
+			Call if the condition became true after prepareWait
+		---------------------------------------------------------------------*/
+		void cancelWait()
+		{
+			mWaiters.fetch_sub(1, std::memory_order_relaxed);
+		}
+
+		/*---------------------------------------------------------------------
+			Sleeps until a notify() is issued after prepareWait returned key
+		---------------------------------------------------------------------*/
+		void commitWait(uint32_t key)
+		{
+			boost::mutex::scoped_lock lock(mMutex);
+			while (mEpoch.load(std::memory_order_seq_cst) == key) {
+				mCondVar.wait(lock);
+			}
+			lock.unlock();
+			mWaiters.fetch_sub(1, std::memory_order_relaxed);
+		}
+
+		/*---------------------------------------------------------------------
+			Wakes all sleeping waiters. Call after publishing the data the
+			waiters are checking for.
+		---------------------------------------------------------------------*/
+		void notify()
+		{
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if (mWaiters.load(std::memory_order_seq_cst) == 0) { return; }
+			boost::mutex::scoped_lock lock(mMutex);
+			mEpoch.fetch_add(1, std::memory_order_seq_cst);
+			lock.unlock();
+			mCondVar.notify_all();
+		}
+
+		/*---------------------------------------------------------------------
+			Wakes one sleeping waiter, for a producer that published one
+			item any waiter can take. Waiters that see the epoch move
+			without being woken just check their condition again.
+		---------------------------------------------------------------------*/
+		void notifyOne()
+		{
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if (mWaiters.load(std::memory_order_seq_cst) == 0) { return; }
+			boost::mutex::scoped_lock lock(mMutex);
+			mEpoch.fetch_add(1, std::memory_order_seq_cst);
+			lock.unlock();
+			mCondVar.notify_one();
+		}
+
+		explicit EventCount() : mWaiters(0), mEpoch(0) {}
+};
+
+/*=============================================================================
+class BoundedQueue
+	A fixed capacity lock-free queue based on Dmitry Vyukov's bounded MPMC
+	queue. Each cell carries a sequence number that tells producers and
+	consumers whether the cell is free to write or ready to read, so push and
+	pop are one CAS on the shared position plus one release store on the
+	cell. When SingleConsumer is true the pop side skips the CAS since only
+	one thread ever advances the dequeue position.
+	Exposes the same push/tryPop/waitPop/empty surface as ConcurrentQueue.
+	Capacity is rounded up to a power of two. push() never blocks: while the
+	ring is full, and until the consumers have drained what spilled, pushes
+	go to a mutex guarded overflow list, which keeps each producer's items
+	in order. A producer that fills the ring while the consumer waits on it,
+	such as a job raising events while the main thread joins it, can't
+	stall. tryPush() is lock-free and fails instead.
+	Use the MPSCQueue and MPMCQueue names below rather than this directly.
+=============================================================================*/
+template <typename T, bool SingleConsumer>
+class BoundedQueue : private boost::noncopyable {
+	private:
+		///// DEFINITIONS /////
+		enum : size_t { CacheLineSize = 64 };
+
+		struct Cell {
+			std::atomic<size_t>	mSequence;
+			T					mData;
+		};
+
+		///// VARIABLES /////
+		// positions are padded onto their own cache lines so producers and consumer don't false share
+		char				mPad0[CacheLineSize];
+		Cell *				mBuffer;
+		size_t				mMask;
+		char				mPad1[CacheLineSize - sizeof(Cell*) - sizeof(size_t)];
+		std::atomic<size_t>	mEnqueuePos;
+		char				mPad2[CacheLineSize - sizeof(std::atomic<size_t>)];
+		std::atomic<size_t>	mDequeuePos;
+		char				mPad3[CacheLineSize - sizeof(std::atomic<size_t>)];
+		EventCount			mEventCount;
+
+		// spill for pushes that find the ring full, consumers pop it only once the ring is empty
+		std::deque<T>		mOverflow;
+		boost::mutex		mOverflowMutex;
+		std::atomic<size_t>	mOverflowSize;
+		std::atomic<uint64_t>	mOverflowed;	// total pushes that spilled
+
+		///// FUNCTIONS /////
+		bool tryPushRing(const T &inData)
+		{
+			Cell *cell = 0;
+			size_t pos = mEnqueuePos.load(std::memory_order_relaxed);
+			for (;;) {
+				cell = &mBuffer[pos & mMask];
+				size_t seq = cell->mSequence.load(std::memory_order_acquire);
+				intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+				if (diff == 0) {
+					if (mEnqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) { break; }
+				} else if (diff < 0) {
+					return false; // full
+				} else {
+					pos = mEnqueuePos.load(std::memory_order_relaxed);
+				}
+			}
+			cell->mData = inData;
+			cell->mSequence.store(pos + 1, std::memory_order_release);
+			return true;
+		}
+
+		bool tryPopOverflow(T &outData)
+		{
+			if (mOverflowSize.load(std::memory_order_acquire) == 0) { return false; }
+			boost::mutex::scoped_lock lock(mOverflowMutex);
+			if (mOverflow.empty()) { return false; }
+			outData = std::move(mOverflow.front());
+			mOverflow.pop_front();
+			mOverflowSize.store(mOverflow.size(), std::memory_order_release);
+			return true;
+		}
+
+		static size_t roundUpPow2(size_t n)
+		{
+			size_t p = 2;
+			while (p < n) { p <<= 1; }
+			return p;
+		}
+
+	public:
+		/*---------------------------------------------------------------------
+			Lock-free push, returns false immediately if the ring is full or
+			spilled items are still waiting
+		---------------------------------------------------------------------*/
+		bool tryPush(const T &inData)
+		{
+			if (mOverflowSize.load(std::memory_order_acquire) > 0 || !tryPushRing(inData)) { return false; }
+			mEventCount.notify();
+			return true;
+		}
+
+		/*---------------------------------------------------------------------
+			Lock-free push while the ring has room, otherwise appends to the
+			overflow list under its mutex. Never waits for a consumer.
+		---------------------------------------------------------------------*/
+		void push(const T &inData)
+		{
+			if (tryPush(inData)) { return; } // notified already
+
+			boost::mutex::scoped_lock lock(mOverflowMutex);
+			// the consumer may have drained the spill since, keep it in order either way
+			if (mOverflow.empty() && tryPushRing(inData)) {
+				lock.unlock();
+			} else {
+				mOverflow.push_back(inData);
+				mOverflowSize.store(mOverflow.size(), std::memory_order_release);
+				mOverflowed.fetch_add(1, std::memory_order_relaxed);
+				lock.unlock();
+			}
+			mEventCount.notify();
+		}
+
+		/*---------------------------------------------------------------------
+			This pops an item from the queue, and if the queue is empty,
+			returns immediately instead of waiting for an item.
+		---------------------------------------------------------------------*/
+		bool tryPop(T &outData)
+		{
+			Cell *cell = 0;
+			size_t pos = mDequeuePos.load(std::memory_order_relaxed);
+			for (;;) {
+				cell = &mBuffer[pos & mMask];
+				size_t seq = cell->mSequence.load(std::memory_order_acquire);
+				intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+				if (diff == 0) {
+					if (SingleConsumer) {
+						mDequeuePos.store(pos + 1, std::memory_order_relaxed);
+						break;
+					}
+					if (mDequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) { break; }
+				} else if (diff < 0) {
+					return tryPopOverflow(outData); // ring empty
+				} else {
+					pos = mDequeuePos.load(std::memory_order_relaxed);
+				}
+			}
+			outData = std::move(cell->mData);
+			cell->mData = T(); // release anything the cell holds (e.g. shared_ptr) as soon as it's popped
+			cell->mSequence.store(pos + mMask + 1, std::memory_order_release);
+			return true;
+		}
+
+		/*---------------------------------------------------------------------
+			Pops an item, sleeping on the event count while the queue is
+			empty. Most likely would use this in a worker thread to pop items
+			that are pushed from the main thread.
+		---------------------------------------------------------------------*/
+		void waitPop(T &outData)
+		{
+			while (!tryPop(outData)) {
+				uint32_t key = mEventCount.prepareWait();
+				if (tryPop(outData)) {
+					mEventCount.cancelWait();
+					return;
+				}
+				mEventCount.commitWait(key);
+			}
+		}
+
+		/*---------------------------------------------------------------------
+			Check if the queue is empty. Only a hint when other threads are
+			pushing or popping concurrently.
+		---------------------------------------------------------------------*/
+		bool empty() const
+		{
+			size_t pos = mDequeuePos.load(std::memory_order_relaxed);
+			size_t seq = mBuffer[pos & mMask].mSequence.load(std::memory_order_acquire);
+			return (seq != pos + 1 && mOverflowSize.load(std::memory_order_acquire) == 0);
+		}
+
+		size_t capacity() const { return mMask + 1; }
+
+		/*---------------------------------------------------------------------
+			Pushes that found the ring full since the queue was made, a sign
+			the capacity is too small for the load
+		---------------------------------------------------------------------*/
+		uint64_t overflowed() const { return mOverflowed.load(std::memory_order_relaxed); }
+
+		// Constructor / destructor
+		explicit BoundedQueue(size_t capacity) :
+			mBuffer(0), mMask(roundUpPow2(capacity) - 1),
+			mEnqueuePos(0), mDequeuePos(0),
+			mOverflowSize(0), mOverflowed(0)
+		{
+			mBuffer = new Cell[mMask + 1];
+			for (size_t c = 0; c <= mMask; ++c) {
+				mBuffer[c].mSequence.store(c, std::memory_order_relaxed);
+			}
+		}
+		~BoundedQueue() { delete [] mBuffer; }
+};
+
+/*=============================================================================
+class MPSCQueue
+	Bounded lock-free queue for any number of producers and a single consumer.
+	This is the queue behind EventManager::raiseThreadSafe and the
+	ThreadEventHandler used by worker thread processes.
+=============================================================================*/
+template <typename T>
+class MPSCQueue : public BoundedQueue<T, true> {
+	public:
+		explicit MPSCQueue(size_t capacity = 4096) : BoundedQueue<T, true>(capacity) {}
+};
+
+/*=============================================================================
+class MPMCQueue
+	Bounded lock-free queue for any number of producers and consumers
+=============================================================================*/
+template <typename T>
+class MPMCQueue : public BoundedQueue<T, false> {
+	public:
+		explicit MPMCQueue(size_t capacity = 4096) : BoundedQueue<T, false>(capacity) {}
+};
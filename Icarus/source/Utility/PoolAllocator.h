@@ -0,0 +1,159 @@
+/* PoolAllocator.h
+Author: Jeff Kiah
+Orig.Date: 10/17/2026
+*/
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <atomic>
+#include <vector>
+#include <boost/noncopyable.hpp>
+
+///// DEFINITIONS /////
+
+/*=============================================================================
+	Each subsystem that pools its small objects gets its own family of per-
+	thread pools, so allocation counters can be reported per subsystem.
+=============================================================================*/
+enum SlabPoolId : uint8_t {
+	SlabPool_Event = 0,		// Event objects, their shared_ptr control blocks and event queue nodes
+	SlabPool_Job,			// JobSystem jobs
+	SlabPool_Process,		// Process objects made with ProcessManager::make and their control blocks
+	SlabPool_MAX			// not a pool, reference for array size
+};
+
+///// STRUCTURES /////
+
+/*=============================================================================
+class SlabPool
+	A per-thread small object allocator. Memory is carved from 64KB slabs
+	into fixed size blocks by size class, and freed blocks go on an intrusive
+	free list to be recycled, so steady state allocation never reaches the
+	heap. Slabs are aligned to their size, which lets deallocate() find the
+	owning pool from any pointer without a per-block header.
+	Blocks can be freed from any thread. A free from a thread other than the
+	owner is pushed onto the owner's lock-free remote free list, which the
+	owner reclaims the next time its local free list for that size runs dry.
+	When a thread exits its pools are parked and adopted by the next thread,
+	so blocks still alive in other threads are never orphaned.
+	Requests larger than MaxBlockSize go straight to the heap, but are still
+	counted in the stats.
+=============================================================================*/
+class SlabPool : private boost::noncopyable {
+	public:
+		///// DEFINITIONS /////
+		enum : size_t {
+			SlabSize		= 64 * 1024,
+			MaxBlockSize	= 512,
+			NumSizeClasses	= 13
+		};
+
+		/*---------------------------------------------------------------------
+			Allocation counters, summed over every thread's pool of one id
+		---------------------------------------------------------------------*/
+		struct Stats {
+			uint64_t	allocations;			// total blocks handed out, including large allocations
+			uint64_t	deallocations;			// total blocks returned, including remote frees
+			uint64_t	remoteDeallocations;	// blocks returned from a thread other than the owner
+			uint64_t	largeAllocations;		// requests too big for a size class, sent to the heap
+			int64_t		bytesInUse;				// bytes currently allocated (by size class, not request size)
+			uint64_t	slabs;					// number of 64KB slabs reserved
+			uint32_t	pools;					// number of per-thread pools created
+		};
+
+	private:
+		///// STRUCTURES /////
+		struct FreeBlock {
+			FreeBlock *	next;
+		};
+		struct SlabHeader {
+			SlabPool *	owner;
+			uint32_t	sizeClass;
+		};
+
+		///// VARIABLES /////
+		static const uint32_t	sBlockSize[NumSizeClasses];
+
+		SlabPoolId				mPoolId;
+		FreeBlock *				mFreeList[NumSizeClasses];			// only touched by the owning thread
+		std::atomic<FreeBlock*>	mRemoteFreeList[NumSizeClasses];	// pushed by other threads, drained by the owner
+		std::vector<void*>		mSlabs;
+
+		// allocation counters are only written by the owning thread, the rest by any thread
+		std::atomic<uint64_t>	mAllocations;
+		std::atomic<uint64_t>	mDeallocations;
+		std::atomic<uint64_t>	mRemoteDeallocations;
+		std::atomic<uint64_t>	mLargeAllocations;
+		std::atomic<int64_t>	mBytesInUse;
+
+		///// FUNCTIONS /////
+		static uint32_t	sizeClassOf(size_t size);
+		static void		bump(std::atomic<uint64_t> &counter)	{ counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed); }
+
+		void *	allocateSlow(uint32_t sizeClass);
+		void	addSlab(uint32_t sizeClass);
+
+		explicit SlabPool(SlabPoolId poolId);
+
+	public:
+		/*---------------------------------------------------------------------
+			Allocates size bytes from this pool. Must be called from the
+			thread that owns the pool, use local() to get it.
+		---------------------------------------------------------------------*/
+		void *	allocate(size_t size);
+
+		/*---------------------------------------------------------------------
+			Returns a block to the pool it came from, from any thread. size
+			must be the same size passed to allocate.
+		---------------------------------------------------------------------*/
+		static void	deallocate(SlabPoolId poolId, void *p, size_t size);
+
+		/*---------------------------------------------------------------------
+			Returns the calling thread's pool for poolId, creating or adopting
+			one the first time a thread asks
+		---------------------------------------------------------------------*/
+		static SlabPool &	local(SlabPoolId poolId);
+
+		/*---------------------------------------------------------------------
+			Sums the counters of every pool with the given id
+		---------------------------------------------------------------------*/
+		static Stats		stats(SlabPoolId poolId);
+
+		~SlabPool();
+};
+
+/*=============================================================================
+class PoolAllocator
+	Standard library allocator that draws from the calling thread's SlabPool.
+	Use with std::allocate_shared so the object and its control block come
+	from a single pooled block, or with containers to pool their nodes.
+=============================================================================*/
+template <typename T, SlabPoolId PoolId>
+class PoolAllocator {
+	public:
+		///// DEFINITIONS /////
+		typedef T			value_type;
+		typedef T *			pointer;
+		typedef const T *	const_pointer;
+		typedef T &			reference;
+		typedef const T &	const_reference;
+		typedef size_t		size_type;
+		typedef ptrdiff_t	difference_type;
+
+		template <typename U>
+		struct rebind { typedef PoolAllocator<U, PoolId> other; };
+
+		///// FUNCTIONS /////
+		T *		allocate(size_t n)				{ return static_cast<T*>(SlabPool::local(PoolId).allocate(n * sizeof(T))); }
+		void	deallocate(T *p, size_t n)		{ SlabPool::deallocate(PoolId, p, n * sizeof(T)); }
+		size_t	max_size() const				{ return static_cast<size_t>(-1) / sizeof(T); }
+
+		bool	operator==(const PoolAllocator &) const	{ return true; }
+		bool	operator!=(const PoolAllocator &) const	{ return false; }
+
+		// Constructors
+		PoolAllocator() {}
+		template <typename U>
+		PoolAllocator(const PoolAllocator<U, PoolId> &) {}
+};
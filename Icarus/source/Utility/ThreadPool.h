@@ -0,0 +1,146 @@
+/* ThreadPool.h
+Author: Jeff Kiah
+Orig.Date: 10/17/2026
+*/
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <boost/noncopyable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/thread.hpp>
+
+///// DEFINITIONS /////
+
+/*---------------------------------------------------------------------
+	Scheduling class of a long running task, sets the OS priority and
+	the cores it may run on
+---------------------------------------------------------------------*/
+enum ThreadClass : uint8_t {
+	ThreadClass_Background = 0,	// loading and other I/O, lowest priority, background I/O priority on Windows
+	ThreadClass_Normal,			// CPU work that isn't waited on within the frame
+	ThreadClass_Latency,		// work the frame waits on, above normal priority
+	ThreadClass_MAX
+};
+
+///// STRUCTURES /////
+
+/*=============================================================================
+class ThreadPool
+	Runs long running tasks, such as the loops of ThreadProcesses, on a
+	capped set of threads with per class OS priority and core affinity.
+	Unlike the JobSystem, which runs short jobs on one worker per core, a
+	task here may block or loop for as long as it likes, so each running
+	task holds a thread. Threads are made as tasks need them up to
+	maxThreads and reused once their task returns. Past the cap, tasks wait
+	in a queue, latency tasks first, until a thread frees up, so a loop that
+	never returns holds its thread for good and the cap has to leave room
+	for every such loop that is expected to run at once.
+	Each thread takes on the priority and affinity of the task it runs. The
+	default affinity keeps every class off core 0, where Application pins
+	the main thread, so loading work can't preempt the simulation however
+	high its priority.
+=============================================================================*/
+class ThreadPool : private boost::noncopyable {
+	public:
+		///// DEFINITIONS /////
+		typedef std::function<void()>	TaskFunc;
+
+		struct Config {
+			uint32_t	maxThreads;
+			uint64_t	affinityMask[ThreadClass_MAX];	// bit per core the class may run on, 0 for any
+		};
+
+		/*---------------------------------------------------------------------
+			Handle to a started task, see join
+		---------------------------------------------------------------------*/
+		class Task : private boost::noncopyable {
+			friend class ThreadPool;
+			private:
+				enum TaskState : uint8_t { Task_Waiting = 0, Task_Running, Task_Done };
+				TaskFunc			mFunc;
+				std::string			mName;
+				ThreadClass			mClass;
+				TaskState			mState;		// guarded by the pool's mutex
+				boost::thread::id	mThreadId;	// guarded by the pool's mutex, set while running
+			public:
+				ThreadClass			threadClass() const	{ return mClass; }
+				const std::string &	name() const		{ return mName; }
+				explicit Task(const TaskFunc &func, const std::string &name, ThreadClass threadClass) :
+					mFunc(func), mName(name), mClass(threadClass), mState(Task_Waiting)
+				{}
+		};
+		typedef std::shared_ptr<Task>	TaskPtr;
+
+	private:
+		///// VARIABLES /////
+		Config							mConfig;
+		std::vector<boost::thread*>		mThreads;
+		std::deque<TaskPtr>				mWaiting[ThreadClass_MAX];
+		boost::mutex					mMutex;
+		boost::condition_variable		mTaskReady;		// signaled when a task is queued or on shutdown
+		boost::condition_variable		mTaskDone;		// signaled when a task returns
+		uint32_t						mIdleThreads;
+		bool							mShutdown;
+
+		///// FUNCTIONS /////
+		TaskPtr	popWaiting();
+		void	threadLoop();
+
+	public:
+		/*---------------------------------------------------------------------
+			Queues the task and starts it on an idle or new thread, or leaves
+			it waiting if the pool is at its cap. Thread safe.
+		---------------------------------------------------------------------*/
+		TaskPtr	start(const TaskFunc &func, const std::string &name, ThreadClass threadClass);
+
+		/*---------------------------------------------------------------------
+			Returns once the task is done. A task still waiting for a thread
+			is dropped without running. Returns false if it was dropped.
+			Don't call from the task itself.
+		---------------------------------------------------------------------*/
+		bool	join(const TaskPtr &task);
+
+		/*---------------------------------------------------------------------
+			The thread running the task, not-a-thread while it waits
+		---------------------------------------------------------------------*/
+		boost::thread::id	threadId(const TaskPtr &task);
+
+		uint32_t	numThreads();
+		uint32_t	numWaiting();
+		const Config &	config() const { return mConfig; }
+
+		/*---------------------------------------------------------------------
+			Sets the calling thread's OS priority for the class and restricts
+			it to the cores in affinityMask, 0 for any. Returns false if the OS
+			refused either, which is logged but otherwise harmless.
+		---------------------------------------------------------------------*/
+		static bool	setCurrentThreadClass(ThreadClass threadClass, uint64_t affinityMask);
+
+		/*---------------------------------------------------------------------
+			Restricts the calling thread to the cores in affinityMask
+		---------------------------------------------------------------------*/
+		static bool	pinCurrentThread(uint64_t affinityMask);
+
+		/*---------------------------------------------------------------------
+			Returns a config of maxThreads threads keeping every class off
+			core 0, unless there are fewer than 4 hardware threads
+		---------------------------------------------------------------------*/
+		static Config	defaultConfig(uint32_t maxThreads);
+
+		// Constructor / destructor
+		explicit ThreadPool(const Config &config);
+		/*---------------------------------------------------------------------
+			Waits for the running tasks to return, so they must all have been
+			asked to stop, and drops the waiting ones
+		---------------------------------------------------------------------*/
+		~ThreadPool();
+};
+
+typedef std::shared_ptr<ThreadPool>	ThreadPoolPtr;
+typedef std::weak_ptr<ThreadPool>	ThreadPoolWeakPtr;
@@ -0,0 +1,189 @@
+/* TimerWheel.h
+Author: Jeff Kiah
+Orig.Date: 10/17/2026
+*/
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <utility>
+#include <boost/noncopyable.hpp>
+
+using std::vector;
+
+///// STRUCTURES /////
+
+/*=============================================================================
+class TimerWheel
+	Hierarchical timer wheel holding items of type T until an absolute due
+	tick. There are 4 levels of 256 slots each. An item goes in the lowest
+	level whose span covers its distance from the current tick, level 0 for
+	the next 256 ticks, level 1 for the next 65536, and so on, with items
+	further out than 2^32 ticks kept in an overflow list. Advancing one tick
+	empties a single level 0 slot, and every 256 ticks a slot of the level
+	above is cascaded down, so scheduling and expiring are O(1) per item no
+	matter how many items are pending. Stretches with nothing in the lower
+	levels are skipped a whole span at a time. Slot vectors keep their capacity, so
+	a wheel with a steady load doesn't allocate.
+	The tick unit is up to the owner. Not thread safe.
+=============================================================================*/
+template <typename T>
+class TimerWheel : private boost::noncopyable {
+	private:
+		///// DEFINITIONS /////
+		enum : uint32_t {
+			SlotBits	= 8,
+			NumSlots	= 1 << SlotBits,
+			SlotMask	= NumSlots - 1,
+			NumLevels	= 4
+		};
+
+		struct Entry {
+			uint64_t	mDueTick;
+			T			mItem;
+		};
+		typedef vector<Entry>	Slot;
+
+		///// VARIABLES /////
+		Slot		mSlots[NumLevels][NumSlots];
+		Slot		mOverflow;		// due 2^32 or more ticks past mNextTick when scheduled
+		Slot		mCascade;		// scratch for re-inserting a cascaded slot
+		size_t		mLevelSize[NumLevels + 1];	// items per level, the last is the overflow list
+		uint64_t	mNextTick;		// all ticks before this have been expired
+		size_t		mSize;
+
+		///// FUNCTIONS /////
+		void insert(Entry &&entry)
+		{
+			uint64_t delta = entry.mDueTick - mNextTick;
+			for (uint32_t level = 0; level < NumLevels; ++level) {
+				if (delta < (static_cast<uint64_t>(1) << (SlotBits * (level + 1)))) {
+					uint32_t slot = static_cast<uint32_t>(entry.mDueTick >> (SlotBits * level)) & SlotMask;
+					mSlots[level][slot].push_back(std::move(entry));
+					++mLevelSize[level];
+					return;
+				}
+			}
+			mOverflow.push_back(std::move(entry));
+			++mLevelSize[NumLevels];
+		}
+
+		/*---------------------------------------------------------------------
+			Re-inserts the items of a slot, each lands in a lower level now
+			that the wheel has caught up to its span
+		---------------------------------------------------------------------*/
+		void cascade(Slot &slot, uint32_t level)
+		{
+			mLevelSize[level] -= slot.size();
+			mCascade.swap(slot);
+			for (size_t e = 0; e < mCascade.size(); ++e) {
+				insert(std::move(mCascade[e]));
+			}
+			mCascade.clear();
+		}
+
+	public:
+		/*---------------------------------------------------------------------
+			Adds an item to expire on dueTick. Items already due expire on
+			the next advance.
+		---------------------------------------------------------------------*/
+		void schedule(uint64_t dueTick, T item)
+		{
+			Entry entry = { (dueTick > mNextTick ? dueTick : mNextTick), std::move(item) };
+			insert(std::move(entry));
+			++mSize;
+		}
+
+		/*---------------------------------------------------------------------
+			Expires every item due up to and including nowTick, in due order,
+			calling onExpire(T &) for each. onExpire may schedule new items,
+			one scheduled for a tick already passed expires on the next tick,
+			which is still within this call if nowTick is past it.
+		---------------------------------------------------------------------*/
+		template <typename TFunc>
+		void advance(uint64_t nowTick, TFunc &&onExpire)
+		{
+			while (mNextTick <= nowTick) {
+				if (mSize == 0) {
+					// nothing pending, skip straight to the present
+					mNextTick = nowTick + 1;
+					return;
+				}
+				uint64_t tick = mNextTick;
+				if (mLevelSize[0] == 0) {
+					// nothing can expire before the next cascade of the lowest level holding items,
+					// jump ahead to it, the levels in between are empty so their cascades are no-ops
+					uint32_t level = 1;
+					while (level < NumLevels && mLevelSize[level] == 0) { ++level; }
+					uint64_t span = static_cast<uint64_t>(1) << (SlotBits * level);
+					uint64_t boundary = (tick + span - 1) & ~(span - 1);
+					if (boundary != tick) {
+						mNextTick = (boundary <= nowTick ? boundary : nowTick + 1);
+						continue;
+					}
+				}
+				// cascade down from each level whose lower levels just wrapped
+				if ((tick & SlotMask) == 0) {
+					uint32_t level = 1;
+					for (; level < NumLevels; ++level) {
+						uint32_t slot = static_cast<uint32_t>(tick >> (SlotBits * level)) & SlotMask;
+						cascade(mSlots[level][slot], level);
+						if (slot != 0) { break; }
+					}
+					if (level == NumLevels) {
+						cascade(mOverflow, NumLevels);
+					}
+				}
+
+				// swap the slot out and move past the tick before expiring, so anything onExpire
+				// schedules lands in a later tick rather than the slot being walked
+				Slot &current = mSlots[0][tick & SlotMask];
+				++mNextTick;
+				if (!current.empty()) {
+					Slot expired;
+					expired.swap(current);
+					mSize -= expired.size();
+					mLevelSize[0] -= expired.size();
+					for (size_t e = 0; e < expired.size(); ++e) {
+						onExpire(expired[e].mItem);
+					}
+					// hand the capacity back unless an item was scheduled into this slot 256 ticks out
+					if (current.empty()) {
+						expired.clear();
+						current.swap(expired);
+					}
+				}
+			}
+		}
+
+		/*---------------------------------------------------------------------
+			Removes all items without expiring them
+		---------------------------------------------------------------------*/
+		void clear()
+		{
+			for (uint32_t level = 0; level < NumLevels; ++level) {
+				for (uint32_t slot = 0; slot < NumSlots; ++slot) {
+					mSlots[level][slot].clear();
+				}
+			}
+			mOverflow.clear();
+			for (uint32_t level = 0; level <= NumLevels; ++level) {
+				mLevelSize[level] = 0;
+			}
+			mSize = 0;
+		}
+
+		size_t		size() const		{ return mSize; }
+		bool		empty() const		{ return (mSize == 0); }
+		uint64_t	nextTick() const	{ return mNextTick; }
+
+		// Constructor
+		explicit TimerWheel(uint64_t startTick = 0) :
+			mNextTick(startTick),
+			mSize(0)
+		{
+			for (uint32_t level = 0; level <= NumLevels; ++level) {
+				mLevelSize[level] = 0;
+			}
+		}
+};